@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+"""
+Offline benchmark suite for tracking nextpnr runtime and quality of results.
+
+`run` places and routes a fixed set of generated netlists on every arch that has been built, and writes the
+results to a JSON file: per-stage wall time, peak RSS, wirelength (routing pips used), Fmax and router effort.
+`compare` checks a results file against a baseline and fails if anything got worse by more than the threshold.
+
+    bench.py run --bin-dir build --out results.json
+    bench.py compare baseline.json results.json
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+
+from gen_netlist import generate
+
+# name, binary, netlist arch, size, extra nextpnr arguments
+CASES = [
+    ("ice40-hx8k-1k", "nextpnr-ice40", "ice40", 1000, ["--hx8k", "--package", "ct256"]),
+    ("ice40-hx8k-5k", "nextpnr-ice40", "ice40", 5000, ["--hx8k", "--package", "ct256"]),
+    ("ecp5-85k-5k", "nextpnr-ecp5", "ecp5", 5000, ["--85k"]),
+    ("ecp5-85k-25k", "nextpnr-ecp5", "ecp5", 25000, ["--85k"]),
+    # The example arch's switch matrix can't route tiles packed full of this design's logic, so HeAP is told to spread
+    # cells out more, and router2 is used as router1 doesn't converge on it
+    ("example-2k", "nextpnr-himbaechel", "example", 2000,
+     ["--device", "EXAMPLE", "--placer-heap-beta", "0.3", "--router", "router2"]),
+    ("xilinx-a35t-5k", "nextpnr-himbaechel", "xilinx", 5000, ["--device", "xc7a35tcsg324-1"]),
+    ("xilinx-a35t-15k", "nextpnr-himbaechel", "xilinx", 15000, ["--device", "xc7a35tcsg324-1"]),
+]
+
+STAGES = ["load", "pack", "place", "route"]
+
+# Metrics checked by compare, and whether a bigger value is better
+METRICS = [
+    ("wall_s", False),
+    ("load_s", False),
+    ("pack_s", False),
+    ("place_s", False),
+    ("route_s", False),
+    ("peak_rss_mb", False),
+    ("wirelength", False),
+    ("router_iterations", False),
+    ("fmax_mhz", True),
+]
+TIME_METRICS = {"wall_s", "load_s", "pack_s", "place_s", "route_s"}
+
+
+def run_with_rusage(cmd, log):
+    """Runs cmd, returning its exit status and peak RSS in MiB (None where the platform can't tell us)."""
+    proc = subprocess.Popen(cmd, stdout=log, stderr=subprocess.STDOUT)
+    if hasattr(os, "wait4"):
+        _, status, usage = os.wait4(proc.pid, 0)
+        proc.returncode = os.waitstatus_to_exitcode(status) if hasattr(os, "waitstatus_to_exitcode") else status
+        # ru_maxrss is in KiB on Linux but bytes on macOS
+        scale = 1024 * 1024 if sys.platform == "darwin" else 1024
+        return proc.returncode, usage.ru_maxrss / scale
+    return proc.wait(), None
+
+
+def read_profile(filename):
+    """Stage times in seconds, router iteration count and final counter totals from a --profile-out trace."""
+    with open(filename) as f:
+        events = json.load(f)["traceEvents"]
+    # Stages are timed on the main thread; passes may also use the same scope names on worker threads
+    main_tid = next((ev["tid"] for ev in events if ev["name"] == "thread_name" and ev["args"]["name"] == "main"), None)
+    stage_us = {}
+    iterations = 0
+    counters = {}
+    for ev in events:
+        if ev["ph"] == "X":
+            if ev["name"] in STAGES and ev["tid"] == main_tid:
+                stage_us[ev["name"]] = stage_us.get(ev["name"], 0) + ev["dur"]
+            elif ev["name"] == "router2/iter":
+                iterations += 1
+        elif ev["ph"] == "C":
+            counters[ev["name"]] = ev["args"]["count"]
+    # router1 has no passes over the whole design; its iterations are the arcs taken off its queue
+    iterations += counters.get("router1/iterations", 0)
+    return {s: stage_us[s] / 1e6 for s in stage_us}, iterations, counters
+
+
+def read_wirelength(filename):
+    """Number of pips used by the routing in a netlist written with --write."""
+    with open(filename) as f:
+        netlist = json.load(f)
+    pips = 0
+    for module in netlist["modules"].values():
+        for net in module["netnames"].values():
+            routing = net.get("attributes", {}).get("ROUTING", "")
+            if not routing:
+                continue
+            fields = routing.split(";")
+            # wire;pip;strength triples, with an empty pip for the source wire
+            pips += sum(1 for i in range(1, len(fields), 3) if fields[i] != "")
+    return pips
+
+
+def read_fmax(filename):
+    """Lowest achieved Fmax over all clocks, from a --report file."""
+    with open(filename) as f:
+        report = json.load(f)
+    fmax = [clk["achieved"] for clk in report.get("fmax", {}).values()]
+    return min(fmax) if fmax else None
+
+
+def run_case(args, case):
+    name, binary, arch, size, extra = case
+    exe = os.path.join(args.bin_dir, args.program_prefix + binary)
+    if not os.path.exists(exe):
+        print("{:<20} skipped, {} not built".format(name, binary))
+        return None
+    work = os.path.join(args.work_dir, name)
+    os.makedirs(work, exist_ok=True)
+    netlist = os.path.join(work, "design.json")
+    with open(netlist, "w") as f:
+        json.dump(generate(arch, size, args.design_seed), f)
+
+    routed = os.path.join(work, "routed.json")
+    report = os.path.join(work, "report.json")
+    profile = os.path.join(work, "profile.json")
+    for old in (routed, report, profile):
+        if os.path.exists(old):
+            os.remove(old)
+    cmd = [exe, "--json", netlist, "--write", routed, "--report", report, "--profile-out", profile,
+           "--seed", str(args.seed), "--threads", str(args.threads), "--freq", "100"] + extra + args.extra
+    with open(os.path.join(work, "nextpnr.log"), "w") as log:
+        start = time.monotonic()
+        status, peak_rss = run_with_rusage(cmd, log)
+        wall = time.monotonic() - start
+
+    result = {"arch": arch, "size": size, "command": cmd, "status": status, "wall_s": wall, "peak_rss_mb": peak_rss}
+    if status != 0:
+        print("{:<20} FAILED (exit status {}), see {}".format(name, status, work))
+        return result
+    stage_s, iterations, counters = read_profile(profile)
+    for stage in STAGES:
+        result[stage + "_s"] = stage_s.get(stage)
+    result["router_iterations"] = iterations if iterations > 0 else None
+    result["counters"] = counters
+    result["wirelength"] = read_wirelength(routed)
+    result["fmax_mhz"] = read_fmax(report)
+    print("{:<20} {:8.2f}s  place {:7.2f}s  route {:7.2f}s  {:8.1f} MiB  wirelength {:8d}  fmax {}".format(
+        name, wall, result["place_s"] or 0, result["route_s"] or 0, peak_rss or 0, result["wirelength"],
+        "{:.2f} MHz".format(result["fmax_mhz"]) if result["fmax_mhz"] is not None else "-"))
+    return result
+
+
+def cmd_run(args):
+    cases = [c for c in CASES if re.search(args.only, c[0])]
+    results = {}
+    for case in cases:
+        r = run_case(args, case)
+        if r is not None:
+            results[case[0]] = r
+    output = {
+        "version": 1,
+        "host": os.uname().nodename if hasattr(os, "uname") else "",
+        "timestamp": time.strftime("%Y-%m-%dT%H:%M:%S"),
+        "seed": args.seed,
+        "threads": args.threads,
+        "cases": results,
+    }
+    with open(args.out, "w") as f:
+        json.dump(output, f, indent=2)
+    print("Results written to {}".format(args.out))
+    if any(r["status"] != 0 for r in results.values()):
+        return 1
+    return 0
+
+
+def cmd_compare(args):
+    with open(args.baseline) as f:
+        baseline = json.load(f)["cases"]
+    with open(args.results) as f:
+        results = json.load(f)["cases"]
+    regressions = 0
+    for name in sorted(results.keys()):
+        if name not in baseline:
+            print("{}: not in baseline".format(name))
+            continue
+        base, curr = baseline[name], results[name]
+        if curr["status"] != 0:
+            print("{}: FAILED".format(name))
+            regressions += 1
+            continue
+        print("{}:".format(name))
+        for metric, higher_better in METRICS:
+            b, c = base.get(metric), curr.get(metric)
+            if b is None or c is None:
+                continue
+            change = 0.0 if b == 0 else 100.0 * (c - b) / b
+            threshold = args.time_threshold if metric in TIME_METRICS else args.threshold
+            # Ignore noise on stages that only take a moment
+            worse = (change < -threshold) if higher_better else (change > threshold)
+            if metric in TIME_METRICS and abs(c - b) < args.min_time:
+                worse = False
+            if worse:
+                regressions += 1
+            print("    {:<18} {:>12.2f} -> {:>12.2f}  {:+7.1f}%{}".format(metric, b, c, change,
+                                                                         "  REGRESSION" if worse else ""))
+    print("{} regression(s)".format(regressions))
+    return 1 if regressions > 0 else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command")
+    sub.required = True
+
+    run = sub.add_parser("run", help="run the benchmarks")
+    run.add_argument("--bin-dir", default=".", help="directory containing the nextpnr binaries")
+    run.add_argument("--program-prefix", default="", help="prefix of the binary names, as set with PROGRAM_PREFIX")
+    run.add_argument("--work-dir", default="bench-work", help="directory for netlists, logs and outputs")
+    run.add_argument("--out", default="bench-results.json", help="results file to write")
+    run.add_argument("--only", default="", help="regex of case names to run")
+    run.add_argument("--seed", type=int, default=1, help="nextpnr placement seed")
+    run.add_argument("--design-seed", type=int, default=1, help="seed for the generated netlists")
+    run.add_argument("--threads", type=int, default=8, help="value passed to --threads")
+    run.add_argument("extra", nargs="*", help="extra arguments for nextpnr (after --)")
+    run.set_defaults(func=cmd_run)
+
+    compare = sub.add_parser("compare", help="compare a results file against a baseline")
+    compare.add_argument("baseline")
+    compare.add_argument("results")
+    compare.add_argument("--threshold", type=float, default=2.0,
+                         help="allowed QoR and memory regression in percent")
+    compare.add_argument("--time-threshold", type=float, default=10.0,
+                         help="allowed runtime regression in percent")
+    compare.add_argument("--min-time", type=float, default=0.5,
+                         help="runtime differences below this many seconds are never regressions")
+    compare.set_defaults(func=cmd_compare)
+
+    args = parser.parse_args()
+    return args.func(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+"""
+Generates synthetic, already technology-mapped JSON netlists for benchmarking.
+
+The designs are a ring of registers fed through short chains of 4-input LUTs, with mostly local connectivity and a
+sprinkling of long-range nets, so they look enough like real logic to exercise the placers, routers and timing
+analysis. Output is fully determined by the arch, size and seed, so the same netlist is produced on every host
+without needing Yosys.
+"""
+
+import argparse
+import json
+import random
+
+# Per-arch primitive names and pins, as Yosys would emit them after synthesis
+PRIMS = {
+    "ice40": {
+        "lut": "SB_LUT4", "lut_in": ["I0", "I1", "I2", "I3"], "lut_out": "O", "lut_init": "LUT_INIT",
+        "ff": "SB_DFF", "ff_clk": "C", "ff_d": "D", "ff_q": "Q", "ff_consts": {},
+    },
+    "ecp5": {
+        "lut": "LUT4", "lut_in": ["A", "B", "C", "D"], "lut_out": "Z", "lut_init": "INIT",
+        "ff": "TRELLIS_FF", "ff_clk": "CLK", "ff_d": "DI", "ff_q": "Q", "ff_consts": {},
+    },
+    "example": {
+        "lut": "LUT4", "lut_in": ["I[0]", "I[1]", "I[2]", "I[3]"], "lut_out": "F", "lut_init": "INIT",
+        "ff": "DFF", "ff_clk": "CLK", "ff_d": "D", "ff_q": "Q", "ff_consts": {},
+        # No IO buffer insertion, so they are instantiated here; only the first IO has a route onto the global clock
+        "ibuf": "INBUF", "ibuf_o": "O", "obuf": "OUTBUF", "obuf_i": "I", "buf_pad": "PAD", "clk_bel": "X1Y0/IO0",
+    },
+    "xilinx": {
+        "lut": "LUT4", "lut_in": ["I0", "I1", "I2", "I3"], "lut_out": "O", "lut_init": "INIT",
+        "ff": "FDRE", "ff_clk": "C", "ff_d": "D", "ff_q": "Q", "ff_consts": {"CE": "1", "R": "0"},
+    },
+}
+
+
+def generate(arch, size, seed=1, chain_len=3, num_outputs=8, io_buffers=True, ports=True):
+    """Returns a Yosys-style netlist dict with `size` LUTs and `size` flip-flops. IO buffers are instantiated for the
+    arches that need them unless io_buffers is False; with ports False, the top module has no ports at all."""
+    prims = PRIMS[arch]
+    rng = random.Random("{}:{}:{}".format(arch, size, seed))
+    next_bit = [2]
+
+    def new_bit():
+        b = next_bit[0]
+        next_bit[0] += 1
+        return b
+
+    cells = {}
+    netnames = {}
+
+    clk = new_bit()
+    din = new_bit()
+    ff_q = [new_bit() for i in range(size)]
+    lut_o = [new_bit() for i in range(size)]
+    dout = [ff_q[(i * size) // num_outputs] for i in range(num_outputs)]
+
+    def add_cell(name, cell_type, params, dirs, conns):
+        cells[name] = {
+            "hide_name": 0,
+            "type": cell_type,
+            "parameters": params,
+            "attributes": {},
+            "port_directions": dirs,
+            "connections": conns,
+        }
+
+    for i in range(size):
+        # Registers close by in the ring, and occasionally one from anywhere, so most nets are short but the router
+        # still has to cross the chip now and then
+        def pick():
+            if rng.random() < 0.05:
+                return ff_q[rng.randrange(size)]
+            return ff_q[(i + rng.randint(-32, 32)) % size]
+        inputs = [pick() for j in range(4)]
+        if i == 0:
+            inputs[0] = din
+        elif (i % chain_len) != 0:
+            # Continue a LUT chain, for multi-level paths between registers
+            inputs[0] = lut_o[i - 1]
+        init = "".join(rng.choice("01") for j in range(16))
+        dirs = {p: "input" for p in prims["lut_in"]}
+        dirs[prims["lut_out"]] = "output"
+        conns = {p: [b] for p, b in zip(prims["lut_in"], inputs)}
+        conns[prims["lut_out"]] = [lut_o[i]]
+        add_cell("lut_{}".format(i), prims["lut"], {prims["lut_init"]: init}, dirs, conns)
+
+        dirs = {prims["ff_clk"]: "input", prims["ff_d"]: "input", prims["ff_q"]: "output"}
+        conns = {prims["ff_clk"]: [clk], prims["ff_d"]: [lut_o[i]], prims["ff_q"]: [ff_q[i]]}
+        for port, value in prims["ff_consts"].items():
+            dirs[port] = "input"
+            conns[port] = [value]
+        add_cell("ff_{}".format(i), prims["ff"], {}, dirs, conns)
+
+        netnames["lut_o[{}]".format(i)] = {"hide_name": 0, "bits": [lut_o[i]], "attributes": {}}
+        netnames["ff_q[{}]".format(i)] = {"hide_name": 0, "bits": [ff_q[i]], "attributes": {}}
+
+    netnames["clk"] = {"hide_name": 0, "bits": [clk], "attributes": {}}
+    netnames["din"] = {"hide_name": 0, "bits": [din], "attributes": {}}
+    netnames["dout"] = {"hide_name": 0, "bits": dout, "attributes": {}}
+
+    clk_pad, din_pad, dout_pad = [clk], [din], dout
+    if io_buffers and "ibuf" in prims:
+        pad = prims["buf_pad"]
+        clk_pad, din_pad, dout_pad = [new_bit()], [new_bit()], [new_bit() for i in range(num_outputs)]
+        for name, pad_bit, bit in (("clk", clk_pad[0], clk), ("din", din_pad[0], din)):
+            add_cell("ibuf_" + name, prims["ibuf"], {}, {pad: "input", prims["ibuf_o"]: "output"},
+                     {pad: [pad_bit], prims["ibuf_o"]: [bit]})
+        if "clk_bel" in prims:
+            cells["ibuf_clk"]["attributes"]["BEL"] = prims["clk_bel"]
+        for i in range(num_outputs):
+            add_cell("obuf_dout_{}".format(i), prims["obuf"], {}, {prims["obuf_i"]: "input", pad: "output"},
+                     {prims["obuf_i"]: [dout[i]], pad: [dout_pad[i]]})
+        netnames["clk_pad"] = {"hide_name": 0, "bits": clk_pad, "attributes": {}}
+        netnames["din_pad"] = {"hide_name": 0, "bits": din_pad, "attributes": {}}
+        netnames["dout_pad"] = {"hide_name": 0, "bits": dout_pad, "attributes": {}}
+
+    top = {
+        "attributes": {"top": "00000000000000000000000000000001"},
+        "ports": {
+            "clk": {"direction": "input", "bits": clk_pad},
+            "din": {"direction": "input", "bits": din_pad},
+            "dout": {"direction": "output", "bits": dout_pad},
+        } if ports else {},
+        "cells": cells,
+        "netnames": netnames,
+    }
+    return {"creator": "nextpnr bench/gen_netlist.py", "modules": {"top": top}}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("arch", choices=sorted(PRIMS.keys()))
+    parser.add_argument("size", type=int, help="number of LUTs (and flip-flops)")
+    parser.add_argument("output", help="JSON netlist to write")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--no-io-buffers", action="store_true", help="don't instantiate IO buffers")
+    parser.add_argument("--no-ports", action="store_true", help="leave the top module without ports")
+    args = parser.parse_args()
+    with open(args.output, "w") as f:
+        json.dump(generate(args.arch, args.size, args.seed, io_buffers=not args.no_io_buffers, ports=not args.no_ports),
+                  f)
+
+
+if __name__ == "__main__":
+    main()
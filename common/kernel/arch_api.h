@@ -84,6 +84,8 @@ template <typename R> struct ArchAPI : BaseCtx
     virtual NetInfo *getConflictingWireNet(WireId wire) const = 0;
     virtual DelayQuad getWireDelay(WireId wire) const = 0;
     virtual IdString getWireConstantValue(WireId wire) const = 0;
+    virtual int getWireIndexCount() const = 0;
+    virtual int getWireIndex(WireId wire) const = 0;
     // Pip methods
     virtual typename R::AllPipsRangeT getPips() const = 0;
     virtual PipId getPipByName(IdStringList name) const = 0;
@@ -239,6 +239,22 @@ template <typename R> struct BaseArch : ArchAPI<R>
     virtual WireId getConflictingWireWire(WireId wire) const override { return wire; };
     virtual NetInfo *getConflictingWireNet(WireId wire) const override { return getBoundWireNet(wire); }
     virtual IdString getWireConstantValue(WireId /*wire*/) const override { return {}; }
+    virtual int getWireIndexCount() const override
+    {
+        if (!base_wire2idx_ready) {
+            for (auto wire : this->getWires())
+                base_wire2idx[wire] = int(base_wire2idx.size());
+            base_wire2idx_ready = true;
+        }
+        return int(base_wire2idx.size());
+    }
+    virtual int getWireIndex(WireId wire) const override
+    {
+        // The map is built by getWireIndexCount(), which must have been called before any threads are started, so
+        // that this is only ever a read
+        NPNR_ASSERT(base_wire2idx_ready);
+        return base_wire2idx.at(wire);
+    }
 
     // Pip methods
     virtual IdString getPipType(PipId /*pip*/) const override { return IdString(); }
@@ -453,6 +469,10 @@ template <typename R> struct BaseArch : ArchAPI<R>
     dict<WireId, NetInfo *> base_wire2net;
     dict<PipId, NetInfo *> base_pip2net;
 
+    // For the default dense wire index implementation, built by the first getWireIndexCount() call
+    mutable dict<WireId, int> base_wire2idx;
+    mutable bool base_wire2idx_ready = false;
+
     // For the default cell/bel bucket implementations
     std::vector<IdString> cell_types;
     std::vector<BelBucketId> bel_buckets;
@@ -299,10 +299,69 @@ CellInfo *BaseCtx::createCell(IdString name, IdString type)
     auto cell = std::make_unique<CellInfo>(getCtx(), name, type);
     CellInfo *ptr = cell.get();
     cells[name] = std::move(cell);
+    if (cells_by_type[type].insert(name).second)
+        ++cells_by_type_count;
     refreshUi();
     return ptr;
 }
 
+CellInfo *BaseCtx::addCell(std::unique_ptr<CellInfo> cell)
+{
+    NPNR_ASSERT(!cells.count(cell->name));
+    CellInfo *ptr = cell.get();
+    cells[ptr->name] = std::move(cell);
+    if (cells_by_type[ptr->type].insert(ptr->name).second)
+        ++cells_by_type_count;
+    refreshUi();
+    return ptr;
+}
+
+void BaseCtx::deleteCell(IdString name)
+{
+    CellInfo *cell = cells.at(name).get();
+    auto fnd = cells_by_type.find(cell->type);
+    if (fnd != cells_by_type.end())
+        cells_by_type_count -= fnd->second.erase(name);
+    cells.erase(name);
+    refreshUi();
+}
+
+void BaseCtx::setCellType(CellInfo *cell, IdString type)
+{
+    if (cell->type == type)
+        return;
+    auto fnd = cells_by_type.find(cell->type);
+    if (fnd != cells_by_type.end())
+        cells_by_type_count -= fnd->second.erase(cell->name);
+    cell->type = type;
+    if (cells_by_type[type].insert(cell->name).second)
+        ++cells_by_type_count;
+}
+
+std::vector<CellInfo *> BaseCtx::getCellsByType(IdString type) const
+{
+    // Catch cells added or erased without going through the index
+    NPNR_ASSERT(cells_by_type_count == cells.size());
+    std::vector<CellInfo *> result;
+    auto fnd = cells_by_type.find(type);
+    if (fnd == cells_by_type.end())
+        return result;
+    for (IdString name : fnd->second) {
+        auto cell = cells.find(name);
+        NPNR_ASSERT(cell != cells.end() && cell->second->type == type);
+        result.push_back(cell->second.get());
+    }
+    return result;
+}
+
+void BaseCtx::rebuildCellTypeIndex()
+{
+    cells_by_type.clear();
+    for (auto &cell : cells)
+        cells_by_type[cell.second->type].insert(cell.first);
+    cells_by_type_count = cells.size();
+}
+
 void BaseCtx::copyBelPorts(IdString cell, BelId bel)
 {
     CellInfo *cell_info = cells.at(cell).get();
@@ -30,8 +30,10 @@
 
 #include "hashlib.h"
 #include "idstring.h"
+#include "idstring_db.h"
 #include "nextpnr_namespaces.h"
 #include "nextpnr_types.h"
+#include "profiler.h"
 #include "property.h"
 #include "str_ring_buffer.h"
 
@@ -53,12 +55,14 @@ struct BaseCtx
 #endif
 
     // ID String database.
-    mutable std::unordered_map<std::string, int> *idstring_str_to_idx;
-    mutable std::vector<const std::string *> *idstring_idx_to_str;
+    mutable IdStringDb *idstring_db;
 
     // Temporary string backing store for logging
     mutable StrRingBuffer log_strs;
 
+    // Timed scopes and work counters, when enabled with --profile-out
+    mutable Profiler profiler;
+
     // Project settings and config switches
     dict<IdString, Property> settings;
 
@@ -66,6 +70,11 @@ struct BaseCtx
     dict<IdString, std::unique_ptr<NetInfo>> nets;
     dict<IdString, std::unique_ptr<CellInfo>> cells;
 
+    // Names of cells by type, so that passes like packing can visit only the types they care about. Only kept up to
+    // date by createCell, addCell, deleteCell and setCellType; cells_by_type_count is the number of names in the index.
+    dict<IdString, pool<IdString>> cells_by_type;
+    size_t cells_by_type_count = 0;
+
     // Hierarchical (non-leaf) cells by full path
     dict<IdString, HierarchicalCell> hierarchy;
     // This is the root of the above structure
@@ -94,8 +103,7 @@ struct BaseCtx
 
     BaseCtx()
     {
-        idstring_str_to_idx = new std::unordered_map<std::string, int>;
-        idstring_idx_to_str = new std::vector<const std::string *>;
+        idstring_db = new IdStringDb;
         IdString::initialize_add(this, "", 0);
         IdString::initialize_arch(this);
 
@@ -104,8 +112,7 @@ struct BaseCtx
 
     virtual ~BaseCtx()
     {
-        delete idstring_str_to_idx;
-        delete idstring_idx_to_str;
+        delete idstring_db;
     }
 
     // Must be called before performing any mutating changes on the Ctx/Arch.
@@ -239,6 +246,15 @@ struct BaseCtx
     void renameNet(IdString old_name, IdString new_name);
 
     CellInfo *createCell(IdString name, IdString type);
+    // Take ownership of a cell that was constructed elsewhere
+    CellInfo *addCell(std::unique_ptr<CellInfo> cell);
+    void deleteCell(IdString name);
+    void setCellType(CellInfo *cell, IdString type);
+    // All cells of a type, in a deterministic order. This relies on every cell having been added, erased and retyped
+    // through the functions above since the index was last rebuilt; code that changes 'cells' or a cell's type
+    // directly must call rebuildCellTypeIndex before the next lookup.
+    std::vector<CellInfo *> getCellsByType(IdString type) const;
+    void rebuildCellTypeIndex();
     void copyBelPorts(IdString cell, BelId bel);
 
     // Workaround for lack of wrappable constructors
@@ -53,4 +53,21 @@ int Bits::generic_ctz(unsigned int x)
     log_error("Unreachable!");
 }
 
+int Bits::generic_clz(unsigned int x)
+{
+    if (x == 0) {
+        log_error("Cannot call clz with arg = 0");
+    }
+
+    const int digits = std::numeric_limits<unsigned int>::digits;
+    for (int i = 0; i < digits; ++i) {
+        if ((x & (1u << (digits - 1 - i))) != 0) {
+            return i;
+        }
+    }
+
+    // Unreachable!
+    log_error("Unreachable!");
+}
+
 NEXTPNR_NAMESPACE_END
@@ -24,11 +24,11 @@
 //  - popcount : The number of bits set in an unsigned int
 //  - ctz : The number of trailing zero bits in an unsigned int.
 //          Must be called with a value that has at least 1 bit set.
+//  - clz : The number of leading zero bits in an unsigned int.
+//          Must be called with a value that has at least 1 bit set.
 //
 // These methods will typically use instrinics when available, and have a
 // generic fallback in the event that the instrinic is not available.
-//
-// If clz (count leading zeros) is needed, it can be added when needed.
 #ifndef BITS_H
 #define BITS_H
 
@@ -37,6 +37,8 @@
 #pragma intrinsic(_BitScanForward, _BitScanReverse, __popcnt)
 #endif
 
+#include <limits>
+
 #include "nextpnr_namespaces.h"
 
 NEXTPNR_NAMESPACE_BEGIN
@@ -45,6 +47,7 @@ struct Bits
 {
     static int generic_popcount(unsigned int x);
     static int generic_ctz(unsigned int x);
+    static int generic_clz(unsigned int x);
 
     static int popcount(unsigned int x)
     {
@@ -67,6 +70,19 @@ struct Bits
         return result;
 #else
         return generic_ctz(x);
+#endif
+    }
+
+    static int clz(unsigned int x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clz(x);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        unsigned long result;
+        _BitScanReverse(&result, x);
+        return (std::numeric_limits<unsigned int>::digits - 1) - result;
+#else
+        return generic_clz(x);
 #endif
     }
 };
@@ -0,0 +1,803 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  The nextpnr Authors
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "checkpoint.h"
+
+#include <algorithm>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+
+#include "log.h"
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+
+// Layout: a header, then a table of every string used, then the body, in which all names are indices into the string
+// table. Integers are stored in host byte order; the header records enough to reject files from a different host,
+// build or device rather than misreading them. Bump the version whenever the layout changes.
+const char checkpoint_magic[8] = {'N', 'P', 'N', 'R', 'C', 'K', 'P', 'T'};
+const uint32_t checkpoint_version = 2;
+const uint32_t checkpoint_byte_order = 0x01020304;
+
+// hashlib containers iterate in reverse insertion order. Everything is written in insertion order, so recreating it
+// in file order gives back the same iteration order
+template <typename T> auto insertion_order(const T &container)
+{
+    std::vector<decltype(&*container.begin())> result;
+    result.reserve(container.size());
+    for (auto &entry : container)
+        result.push_back(&entry);
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+struct CheckpointWriter
+{
+    CheckpointWriter(Context *ctx) : ctx(ctx)
+    {
+        arch_info_attrs = {ctx->id("NEXTPNR_BEL"), ctx->id("BEL_STRENGTH"), ctx->id("ROUTING")};
+    };
+    Context *ctx;
+
+    // Attributes that mirror bel bindings and routing (see archInfoToAttributes). They are dropped when saving, as the
+    // bindings themselves are saved, and recreated on load
+    pool<IdString> arch_info_attrs;
+
+    std::vector<char> body;
+    dict<IdString, uint32_t> string_idx;
+    std::vector<IdString> strings;
+    bool had_arch_info_attrs = false;
+
+    template <typename T> void write_pod(const T &value)
+    {
+        const char *data = reinterpret_cast<const char *>(&value);
+        body.insert(body.end(), data, data + sizeof(T));
+    }
+    void write_u8(uint8_t value) { write_pod(value); }
+    void write_u32(uint32_t value) { write_pod(value); }
+
+    void write_id(IdString id)
+    {
+        auto fnd = string_idx.find(id);
+        if (fnd == string_idx.end()) {
+            fnd = string_idx.emplace(id, uint32_t(strings.size())).first;
+            strings.push_back(id);
+        }
+        write_u32(fnd->second);
+    }
+
+    void write_id_list(IdStringList list)
+    {
+        write_u32(uint32_t(list.size()));
+        for (IdString id : list)
+            write_id(id);
+    }
+
+    void write_string(const std::string &str)
+    {
+        write_u32(uint32_t(str.size()));
+        body.insert(body.end(), str.begin(), str.end());
+    }
+
+    void write_property(const Property &prop)
+    {
+        write_u8(prop.is_string);
+        write_string(prop.str);
+    }
+
+    void write_props(const dict<IdString, Property> &props)
+    {
+        auto entries = insertion_order(props);
+        uint32_t count = 0;
+        for (auto entry : entries)
+            if (!arch_info_attrs.count(entry->first))
+                ++count;
+        write_u32(count);
+        for (auto entry : entries) {
+            if (arch_info_attrs.count(entry->first)) {
+                had_arch_info_attrs = true;
+                continue;
+            }
+            write_id(entry->first);
+            write_property(entry->second);
+        }
+    }
+
+    void write_id_map(const dict<IdString, IdString> &map)
+    {
+        write_u32(uint32_t(map.size()));
+        for (auto entry : insertion_order(map)) {
+            write_id(entry->first);
+            write_id(entry->second);
+        }
+    }
+
+    void write_delay(const DelayPair &delay)
+    {
+        write_pod(delay.min_delay);
+        write_pod(delay.max_delay);
+    }
+
+    void write_regions()
+    {
+        write_u32(uint32_t(ctx->region.size()));
+        for (auto entry : insertion_order(ctx->region)) {
+            const Region &r = *entry->second;
+            write_id(r.name);
+            write_u8(r.constr_bels);
+            write_u8(r.constr_wires);
+            write_u8(r.constr_pips);
+            write_u32(uint32_t(r.bels.size()));
+            for (auto bel : insertion_order(r.bels))
+                write_id_list(ctx->getBelName(*bel));
+            write_u32(uint32_t(r.wires.size()));
+            for (auto wire : insertion_order(r.wires))
+                write_id_list(ctx->getWireName(*wire));
+            write_u32(uint32_t(r.piplocs.size()));
+            for (auto loc : insertion_order(r.piplocs)) {
+                write_pod(int32_t(loc->x));
+                write_pod(int32_t(loc->y));
+                write_pod(int32_t(loc->z));
+            }
+        }
+    }
+
+    void write_hierarchy()
+    {
+        write_id(ctx->top_module);
+        write_u32(uint32_t(ctx->hierarchy.size()));
+        for (auto entry : insertion_order(ctx->hierarchy)) {
+            const HierarchicalCell &hc = entry->second;
+            write_id(entry->first);
+            write_id(hc.name);
+            write_id(hc.type);
+            write_id(hc.parent);
+            write_id(hc.fullpath);
+            write_id_map(hc.leaf_cells);
+            write_id_map(hc.nets);
+            write_id_map(hc.leaf_cells_by_gname);
+            write_id_map(hc.nets_by_gname);
+            write_id_map(hc.hier_cells);
+            write_u32(uint32_t(hc.ports.size()));
+            for (auto port : insertion_order(hc.ports)) {
+                write_id(port->first);
+                write_id(port->second.name);
+                write_u8(uint8_t(port->second.dir));
+                write_u32(uint32_t(port->second.nets.size()));
+                for (IdString net : port->second.nets)
+                    write_id(net);
+                write_pod(int32_t(port->second.offset));
+                write_u8(port->second.upto);
+            }
+        }
+    }
+
+    void write_nets(const std::vector<const std::pair<IdString, std::unique_ptr<NetInfo>> *> &nets)
+    {
+        write_u32(uint32_t(nets.size()));
+        for (auto entry : nets) {
+            const NetInfo *ni = entry->second.get();
+            write_id(ni->name);
+            write_id(ni->hierpath);
+            write_id(ni->constant_value);
+            write_props(ni->attrs);
+            write_u32(uint32_t(ni->aliases.size()));
+            for (IdString alias : ni->aliases)
+                write_id(alias);
+            write_id(ni->region ? ni->region->name : IdString());
+            write_u8(bool(ni->clkconstr));
+            if (ni->clkconstr) {
+                write_delay(ni->clkconstr->high);
+                write_delay(ni->clkconstr->low);
+                write_delay(ni->clkconstr->period);
+            }
+        }
+    }
+
+    void write_cells(const std::vector<const std::pair<IdString, std::unique_ptr<CellInfo>> *> &cells)
+    {
+        write_u32(uint32_t(cells.size()));
+        for (auto entry : cells) {
+            const CellInfo *ci = entry->second.get();
+            if (ci->isPseudo())
+                log_error("Cell '%s' is a pseudo cell, which can't be saved to a checkpoint.\n", ctx->nameOf(ci));
+            write_id(ci->name);
+            write_id(ci->type);
+            write_id(ci->hierpath);
+            write_props(ci->attrs);
+            write_props(ci->params);
+            write_id(ci->cluster);
+            write_id(ci->region ? ci->region->name : IdString());
+            write_u32(uint32_t(ci->ports.size()));
+            for (auto port : insertion_order(ci->ports)) {
+                write_id(port->first);
+                write_u8(uint8_t(port->second.type));
+            }
+        }
+    }
+
+    void write_connectivity(const std::vector<const std::pair<IdString, std::unique_ptr<NetInfo>> *> &nets,
+                            const dict<IdString, uint32_t> &cell_idx)
+    {
+        auto write_ref = [&](const PortRef &ref) {
+            write_u32(ref.cell ? cell_idx.at(ref.cell->name) : ~0u);
+            write_id(ref.port);
+        };
+        for (auto entry : nets) {
+            const NetInfo *ni = entry->second.get();
+            write_ref(ni->driver);
+            write_u32(uint32_t(ni->users.entries()));
+            for (auto &usr : ni->users)
+                write_ref(usr);
+        }
+        write_id_map(ctx->net_aliases);
+        write_u32(uint32_t(ctx->ports.size()));
+        for (auto port : insertion_order(ctx->ports)) {
+            write_id(port->first);
+            write_id(port->second.name);
+            write_u8(uint8_t(port->second.type));
+            write_id(port->second.net ? port->second.net->name : IdString());
+        }
+        write_u32(uint32_t(ctx->port_cells.size()));
+        for (auto port : insertion_order(ctx->port_cells)) {
+            write_id(port->first);
+            write_id(port->second->name);
+        }
+    }
+
+    // The constraints of cells in legacy clusters (BaseClusterInfo, which every arch's ArchCellInfo derives from);
+    // the cluster IDs themselves are saved with the cells
+    void write_clusters(const std::vector<const std::pair<IdString, std::unique_ptr<CellInfo>> *> &cells,
+                        const dict<IdString, uint32_t> &cell_idx)
+    {
+        for (auto entry : cells) {
+            const CellInfo *ci = entry->second.get();
+            write_pod(int32_t(ci->constr_x));
+            write_pod(int32_t(ci->constr_y));
+            write_pod(int32_t(ci->constr_z));
+            write_u8(ci->constr_abs_z);
+            write_u32(uint32_t(ci->constr_children.size()));
+            for (const CellInfo *child : ci->constr_children)
+                write_u32(cell_idx.at(child->name));
+        }
+    }
+
+    void write_bindings(const std::vector<const std::pair<IdString, std::unique_ptr<NetInfo>> *> &nets,
+                        const std::vector<const std::pair<IdString, std::unique_ptr<CellInfo>> *> &cells)
+    {
+        for (auto entry : cells) {
+            const CellInfo *ci = entry->second.get();
+            if (ci->bel == BelId()) {
+                write_u32(0);
+                continue;
+            }
+            write_id_list(ctx->getBelName(ci->bel));
+            write_u8(uint8_t(ci->belStrength));
+        }
+        for (auto entry : nets) {
+            const NetInfo *ni = entry->second.get();
+            write_u32(uint32_t(ni->wires.size()));
+            for (auto wire : insertion_order(ni->wires)) {
+                write_u8(uint8_t(wire->second.strength));
+                if (wire->second.pip == PipId()) {
+                    write_u8(0);
+                    write_id_list(ctx->getWireName(wire->first));
+                } else {
+                    write_u8(1);
+                    write_id_list(ctx->getPipName(wire->second.pip));
+                }
+            }
+        }
+    }
+
+    void write_design()
+    {
+        auto nets = insertion_order(ctx->nets);
+        auto cells = insertion_order(ctx->cells);
+        dict<IdString, uint32_t> cell_idx;
+        for (uint32_t i = 0; i < uint32_t(cells.size()); i++)
+            cell_idx[cells.at(i)->first] = i;
+
+        write_props(ctx->settings);
+        write_props(ctx->attrs);
+        write_regions();
+        write_hierarchy();
+        write_nets(nets);
+        write_cells(cells);
+        write_connectivity(nets, cell_idx);
+        write_clusters(cells, cell_idx);
+        write_bindings(nets, cells);
+    }
+
+    void write_file(std::ostream &out)
+    {
+        std::vector<char> header;
+        auto put = [&](const void *data, size_t size) {
+            header.insert(header.end(), reinterpret_cast<const char *>(data),
+                          reinterpret_cast<const char *>(data) + size);
+        };
+        auto put_u32 = [&](uint32_t value) { put(&value, sizeof(value)); };
+        auto put_string = [&](const std::string &str) {
+            put_u32(uint32_t(str.size()));
+            put(str.data(), str.size());
+        };
+        put(checkpoint_magic, sizeof(checkpoint_magic));
+        put_u32(checkpoint_version);
+        put_u32(checkpoint_byte_order);
+        put_u32(uint32_t(sizeof(delay_t)));
+        put_string(ctx->archId().str(ctx));
+        put_string(ctx->getChipName());
+        put_u32(had_arch_info_attrs);
+        put_u32(uint32_t(strings.size()));
+        for (IdString id : strings)
+            put_string(id.str(ctx));
+        out.write(header.data(), header.size());
+        out.write(body.data(), body.size());
+    }
+};
+
+struct CheckpointReader
+{
+    CheckpointReader(Context *ctx, const char *data, size_t size, const std::string &filename)
+            : ctx(ctx), p(data), end(data + size), filename(filename) {};
+    Context *ctx;
+    const char *p, *end;
+    const std::string &filename;
+
+    std::vector<IdString> strings;
+    std::vector<NetInfo *> nets;
+    std::vector<CellInfo *> cells;
+
+    [[noreturn]] void corrupt() { log_error("Checkpoint '%s' is truncated or corrupt.\n", filename.c_str()); }
+
+    template <typename T> T read_pod()
+    {
+        if (size_t(end - p) < sizeof(T))
+            corrupt();
+        T value;
+        memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return value;
+    }
+    uint8_t read_u8() { return read_pod<uint8_t>(); }
+    uint32_t read_u32() { return read_pod<uint32_t>(); }
+
+    std::string_view read_string()
+    {
+        uint32_t size = read_u32();
+        if (size_t(end - p) < size)
+            corrupt();
+        std::string_view str(p, size);
+        p += size;
+        return str;
+    }
+
+    IdString read_id()
+    {
+        uint32_t idx = read_u32();
+        if (idx >= strings.size())
+            corrupt();
+        return strings.at(idx);
+    }
+
+    IdStringList read_id_list()
+    {
+        uint32_t size = read_u32();
+        std::vector<IdString> ids;
+        ids.reserve(size);
+        for (uint32_t i = 0; i < size; i++)
+            ids.push_back(read_id());
+        return IdStringList(ids);
+    }
+
+    Property read_property()
+    {
+        Property prop;
+        prop.is_string = read_u8();
+        prop.str = std::string(read_string());
+        if (prop.is_string)
+            prop.intval = 0;
+        else
+            prop.update_intval();
+        return prop;
+    }
+
+    void read_props(dict<IdString, Property> &props)
+    {
+        uint32_t count = read_u32();
+        for (uint32_t i = 0; i < count; i++) {
+            IdString name = read_id();
+            props[name] = read_property();
+        }
+    }
+
+    void read_id_map(dict<IdString, IdString> &map)
+    {
+        uint32_t count = read_u32();
+        for (uint32_t i = 0; i < count; i++) {
+            IdString key = read_id();
+            map[key] = read_id();
+        }
+    }
+
+    PortType read_port_type()
+    {
+        uint8_t type = read_u8();
+        if (type > PORT_INOUT)
+            corrupt();
+        return PortType(type);
+    }
+
+    PlaceStrength read_strength()
+    {
+        uint8_t strength = read_u8();
+        if (strength > STRENGTH_USER)
+            corrupt();
+        return PlaceStrength(strength);
+    }
+
+    DelayPair read_delay()
+    {
+        delay_t min_delay = read_pod<delay_t>();
+        delay_t max_delay = read_pod<delay_t>();
+        return DelayPair(min_delay, max_delay);
+    }
+
+    template <typename T> T *lookup(const std::vector<T *> &vec, uint32_t idx)
+    {
+        if (idx == ~0u)
+            return nullptr;
+        if (idx >= vec.size())
+            corrupt();
+        return vec.at(idx);
+    }
+
+    NetInfo *lookup_net(IdString name)
+    {
+        auto fnd = ctx->nets.find(name);
+        if (fnd == ctx->nets.end())
+            corrupt();
+        return fnd->second.get();
+    }
+
+    CellInfo *lookup_cell(IdString name)
+    {
+        auto fnd = ctx->cells.find(name);
+        if (fnd == ctx->cells.end())
+            corrupt();
+        return fnd->second.get();
+    }
+
+    Region *lookup_region(IdString name)
+    {
+        if (name == IdString())
+            return nullptr;
+        auto fnd = ctx->region.find(name);
+        if (fnd == ctx->region.end())
+            corrupt();
+        return fnd->second.get();
+    }
+
+    BelId lookup_bel(IdStringList name)
+    {
+        BelId bel = ctx->getBelByName(name);
+        if (bel == BelId())
+            log_error("Bel '%s' from checkpoint '%s' doesn't exist.\n", name.str(ctx).c_str(), filename.c_str());
+        return bel;
+    }
+
+    WireId lookup_wire(IdStringList name)
+    {
+        WireId wire = ctx->getWireByName(name);
+        if (wire == WireId())
+            log_error("Wire '%s' from checkpoint '%s' doesn't exist.\n", name.str(ctx).c_str(), filename.c_str());
+        return wire;
+    }
+
+    bool read_header()
+    {
+        if (size_t(end - p) < sizeof(checkpoint_magic) || memcmp(p, checkpoint_magic, sizeof(checkpoint_magic)) != 0)
+            log_error("'%s' is not a nextpnr checkpoint.\n", filename.c_str());
+        p += sizeof(checkpoint_magic);
+        uint32_t version = read_u32();
+        if (version != checkpoint_version)
+            log_error("Checkpoint '%s' has version %u, but this build of nextpnr only reads version %u.\n",
+                      filename.c_str(), version, checkpoint_version);
+        if (read_u32() != checkpoint_byte_order || read_u32() != sizeof(delay_t))
+            log_error("Checkpoint '%s' was written on a different host or by a different build of nextpnr.\n",
+                      filename.c_str());
+        std::string arch(read_string()), chip(read_string());
+        if (arch != ctx->archId().str(ctx) || chip != ctx->getChipName())
+            log_error("Checkpoint '%s' is for %s device '%s', not %s device '%s'.\n", filename.c_str(), arch.c_str(),
+                      chip.c_str(), ctx->archId().c_str(ctx), ctx->getChipName().c_str());
+        bool had_arch_info_attrs = read_u32();
+        uint32_t string_count = read_u32();
+        strings.reserve(string_count);
+        for (uint32_t i = 0; i < string_count; i++)
+            strings.emplace_back(ctx, read_string());
+        return had_arch_info_attrs;
+    }
+
+    void read_regions()
+    {
+        uint32_t count = read_u32();
+        for (uint32_t i = 0; i < count; i++) {
+            IdString name = read_id();
+            auto &region = ctx->region[name];
+            region = std::make_unique<Region>();
+            Region &r = *region;
+            r.name = name;
+            r.constr_bels = read_u8();
+            r.constr_wires = read_u8();
+            r.constr_pips = read_u8();
+            uint32_t bel_count = read_u32();
+            for (uint32_t j = 0; j < bel_count; j++)
+                r.bels.insert(lookup_bel(read_id_list()));
+            uint32_t wire_count = read_u32();
+            for (uint32_t j = 0; j < wire_count; j++)
+                r.wires.insert(lookup_wire(read_id_list()));
+            uint32_t loc_count = read_u32();
+            for (uint32_t j = 0; j < loc_count; j++) {
+                int x = read_pod<int32_t>(), y = read_pod<int32_t>(), z = read_pod<int32_t>();
+                r.piplocs.insert(Loc(x, y, z));
+            }
+        }
+    }
+
+    void read_hierarchy()
+    {
+        ctx->top_module = read_id();
+        uint32_t count = read_u32();
+        for (uint32_t i = 0; i < count; i++) {
+            HierarchicalCell &hc = ctx->hierarchy[read_id()];
+            hc.name = read_id();
+            hc.type = read_id();
+            hc.parent = read_id();
+            hc.fullpath = read_id();
+            read_id_map(hc.leaf_cells);
+            read_id_map(hc.nets);
+            read_id_map(hc.leaf_cells_by_gname);
+            read_id_map(hc.nets_by_gname);
+            read_id_map(hc.hier_cells);
+            uint32_t port_count = read_u32();
+            for (uint32_t j = 0; j < port_count; j++) {
+                HierarchicalPort &port = hc.ports[read_id()];
+                port.name = read_id();
+                port.dir = read_port_type();
+                uint32_t net_count = read_u32();
+                for (uint32_t k = 0; k < net_count; k++)
+                    port.nets.push_back(read_id());
+                port.offset = read_pod<int32_t>();
+                port.upto = read_u8();
+            }
+        }
+    }
+
+    void read_nets()
+    {
+        uint32_t count = read_u32();
+        nets.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            IdString name = read_id();
+            if (ctx->nets.count(name) || ctx->net_aliases.count(name))
+                corrupt();
+            NetInfo *ni = ctx->createNet(name);
+            nets.push_back(ni);
+            ni->hierpath = read_id();
+            ni->constant_value = read_id();
+            read_props(ni->attrs);
+            uint32_t alias_count = read_u32();
+            for (uint32_t j = 0; j < alias_count; j++)
+                ni->aliases.push_back(read_id());
+            ni->region = lookup_region(read_id());
+            if (read_u8()) {
+                ni->clkconstr = std::make_unique<ClockConstraint>();
+                ni->clkconstr->high = read_delay();
+                ni->clkconstr->low = read_delay();
+                ni->clkconstr->period = read_delay();
+            }
+        }
+    }
+
+    void read_cells()
+    {
+        uint32_t count = read_u32();
+        cells.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            IdString name = read_id();
+            if (ctx->cells.count(name))
+                corrupt();
+            CellInfo *ci = ctx->createCell(name, read_id());
+            cells.push_back(ci);
+            ci->hierpath = read_id();
+            read_props(ci->attrs);
+            read_props(ci->params);
+            ci->cluster = read_id();
+            ci->region = lookup_region(read_id());
+            uint32_t port_count = read_u32();
+            for (uint32_t j = 0; j < port_count; j++) {
+                IdString port = read_id();
+                ci->ports[port].name = port;
+                ci->ports[port].type = read_port_type();
+            }
+        }
+    }
+
+    void read_connectivity()
+    {
+        auto read_ref = [&]() {
+            PortRef ref;
+            ref.cell = lookup(cells, read_u32());
+            ref.port = read_id();
+            // Each port can only be connected to one net
+            if (ref.cell != nullptr && (!ref.cell->ports.count(ref.port) || ref.cell->ports.at(ref.port).net))
+                corrupt();
+            return ref;
+        };
+        for (NetInfo *ni : nets) {
+            ni->driver = read_ref();
+            if (ni->driver.cell != nullptr)
+                ni->driver.cell->ports.at(ni->driver.port).net = ni;
+            uint32_t user_count = read_u32();
+            for (uint32_t j = 0; j < user_count; j++) {
+                PortRef usr = read_ref();
+                if (usr.cell == nullptr)
+                    corrupt();
+                PortInfo &port = usr.cell->ports.at(usr.port);
+                port.net = ni;
+                port.user_idx = ni->users.add(usr);
+            }
+        }
+        // createNet adds each net as an alias of itself, so these are already partly filled in
+        read_id_map(ctx->net_aliases);
+        uint32_t port_count = read_u32();
+        for (uint32_t i = 0; i < port_count; i++) {
+            PortInfo &port = ctx->ports[read_id()];
+            port.name = read_id();
+            port.type = read_port_type();
+            IdString net = read_id();
+            port.net = (net == IdString()) ? nullptr : lookup_net(net);
+        }
+        uint32_t port_cell_count = read_u32();
+        for (uint32_t i = 0; i < port_cell_count; i++) {
+            IdString port = read_id();
+            ctx->port_cells[port] = lookup_cell(read_id());
+        }
+    }
+
+    void read_clusters()
+    {
+        for (CellInfo *ci : cells) {
+            ci->constr_x = read_pod<int32_t>();
+            ci->constr_y = read_pod<int32_t>();
+            ci->constr_z = read_pod<int32_t>();
+            ci->constr_abs_z = read_u8();
+            uint32_t child_count = read_u32();
+            for (uint32_t j = 0; j < child_count; j++) {
+                CellInfo *child = lookup(cells, read_u32());
+                if (child == nullptr)
+                    corrupt();
+                ci->constr_children.push_back(child);
+            }
+        }
+    }
+
+    void read_bindings()
+    {
+        for (CellInfo *ci : cells) {
+            IdStringList bel_name = read_id_list();
+            if (bel_name.size() == 0)
+                continue;
+            PlaceStrength strength = read_strength();
+            BelId bel = lookup_bel(bel_name);
+            if (!ctx->checkBelAvail(bel))
+                corrupt();
+            ctx->bindBel(bel, ci, strength);
+        }
+        for (NetInfo *ni : nets) {
+            uint32_t wire_count = read_u32();
+            for (uint32_t j = 0; j < wire_count; j++) {
+                PlaceStrength strength = read_strength();
+                bool is_pip = read_u8();
+                IdStringList name = read_id_list();
+                if (is_pip) {
+                    PipId pip = ctx->getPipByName(name);
+                    if (pip == PipId())
+                        log_error("Pip '%s' from checkpoint '%s' doesn't exist.\n", name.str(ctx).c_str(),
+                                  filename.c_str());
+                    if (!ctx->checkPipAvail(pip) || !ctx->checkWireAvail(ctx->getPipDstWire(pip)))
+                        corrupt();
+                    ctx->bindPip(pip, ni, strength);
+                } else {
+                    WireId wire = lookup_wire(name);
+                    if (!ctx->checkWireAvail(wire))
+                        corrupt();
+                    ctx->bindWire(wire, ni, strength);
+                }
+            }
+        }
+    }
+
+    void read_design()
+    {
+        bool had_arch_info_attrs = read_header();
+        read_props(ctx->settings);
+        read_props(ctx->attrs);
+        read_regions();
+        read_hierarchy();
+        read_nets();
+        read_cells();
+        read_connectivity();
+        read_clusters();
+        read_bindings();
+        if (p != end)
+            corrupt();
+        ctx->assignArchInfo();
+        if (had_arch_info_attrs)
+            ctx->archInfoToAttributes();
+        ctx->design_loaded = true;
+    }
+};
+
+} // namespace
+
+bool write_checkpoint(const std::string &filename, Context *ctx)
+{
+    try {
+        std::ofstream out(filename, std::ios::binary);
+        if (!out)
+            log_error("Failed to open checkpoint '%s' for writing.\n", filename.c_str());
+        CheckpointWriter writer(ctx);
+        writer.write_design();
+        writer.write_file(out);
+        if (!out)
+            log_error("Failed to write checkpoint '%s'.\n", filename.c_str());
+        log_info("Saved checkpoint to '%s' (%d cells, %d nets).\n", filename.c_str(), int(ctx->cells.size()),
+                 int(ctx->nets.size()));
+        return true;
+    } catch (log_execution_error_exception) {
+        return false;
+    }
+}
+
+bool read_checkpoint(const std::string &filename, Context *ctx)
+{
+    try {
+        if (!ctx->cells.empty() || !ctx->nets.empty())
+            log_error("A checkpoint can only be loaded into an empty design.\n");
+        boost::iostreams::mapped_file_source file;
+        try {
+            file.open(filename);
+        } catch (std::exception &) {
+            log_error("Failed to open checkpoint '%s'.\n", filename.c_str());
+        }
+        CheckpointReader(ctx, file.data(), file.size(), filename).read_design();
+        log_info("Loaded checkpoint from '%s' (%d cells, %d nets).\n", filename.c_str(), int(ctx->cells.size()),
+                 int(ctx->nets.size()));
+        return true;
+    } catch (log_execution_error_exception) {
+        return false;
+    }
+}
+
+NEXTPNR_NAMESPACE_END
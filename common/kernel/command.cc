@@ -38,6 +38,7 @@
 
 #include "command.h"
 #include "design_utils.h"
+#include "checkpoint.h"
 #include "json_frontend.h"
 #include "jsonwrite.h"
 #include "log.h"
@@ -342,6 +343,8 @@ po::options_description CommandHandler::getGeneralOptions()
 #endif
     general.add_options()("json", po::value<std::string>(), "JSON design file to ingest");
     general.add_options()("write", po::value<std::string>(), "JSON design file to write");
+    general.add_options()("load-checkpoint", po::value<std::string>(), "binary design checkpoint to load");
+    general.add_options()("save-checkpoint", po::value<std::string>(), "binary design checkpoint to write");
     general.add_options()("top", po::value<std::string>(), "name of top module");
     general.add_options()("seed", po::value<uint64_t>(), "seed value for random number generator");
     general.add_options()("randomize-seed,r", "randomize seed value for random number generator");
@@ -374,10 +377,16 @@ po::options_description CommandHandler::getGeneralOptions()
     general.add_options()("test", "check architecture database integrity");
     general.add_options()("freq", po::value<double>(), "set target frequency for design in MHz");
     general.add_options()("timing-allow-fail", "allow timing to fail in design");
+    general.add_options()("timing-corner", po::value<std::vector<std::string>>(),
+                          "add a timing corner as name:cell_derate[:route_derate], where the derating factors scale "
+                          "the arch delays; timing is analysed at all corners and optimised for the worst");
     general.add_options()("no-tmdriv", "disable timing-driven placement");
     general.add_options()("sdc", po::value<std::string>(), "Generic timing constraints SDC file to load");
     general.add_options()("sdf", po::value<std::string>(), "SDF delay back-annotation file to write");
     general.add_options()("sdf-cvc", "enable tweaks for SDF file compatibility with the CVC simulator");
+    general.add_options()("profile-out", po::value<std::string>(),
+                          "write timing profile of the flow; Chrome trace-event JSON if the name ends in .json, "
+                          "otherwise folded stacks for flamegraph tools");
     general.add_options()("no-print-critical-path-source",
                           "disable printing of the line numbers associated with each net in the critical path");
 
@@ -389,6 +398,12 @@ po::options_description CommandHandler::getGeneralOptions()
     general.add_options()("placer-heap-cell-placement-timeout", po::value<int>(),
                           "allow placer to attempt up to max(10000, total cells^2 / N) iterations to place a cell (int "
                           "N, default: 8, 0 for no timeout)");
+    general.add_options()("placer-heap-parallel-solver",
+                          "solve placer heap equations with the multithreaded solver rather than Eigen");
+    general.add_options()("placer-heap-parallel-legalise",
+                          "legalise placer heap cells by region in parallel, rather than all serially");
+    general.add_options()("placer-heap-legalise-region-size", po::value<int>(),
+                          "size in tiles of the regions legalised in parallel (int, default: 16)");
 
     general.add_options()("static-dump-density", "write density csv files during placer-static flow");
 
@@ -404,6 +419,9 @@ po::options_description CommandHandler::getGeneralOptions()
                           "enable experimental timing-driven ripup in router (deprecated; use --tmg-ripup instead)");
 
     general.add_options()("router2-alt-weights", "use alternate router2 weights");
+    general.add_options()("router2-speculative",
+                          "route nets that cross router2's thread regions in parallel, then reroute only conflicting "
+                          "ones serially");
 
     general.add_options()("report", po::value<std::string>(),
                           "write timing and utilization report in JSON format to file");
@@ -485,6 +503,13 @@ void CommandHandler::setupContext(Context *ctx)
         ctx->settings[ctx->id("timing/allowFail")] = true;
     }
 
+    if (vm.count("timing-corner")) {
+        std::string corners;
+        for (auto &corner : vm["timing-corner"].as<std::vector<std::string>>())
+            corners += (corners.empty() ? "" : ",") + corner;
+        ctx->settings[ctx->id("timing/corners")] = corners;
+    }
+
     if (vm.count("placer")) {
         std::string placer = vm["placer"].as<std::string>();
         if (std::find(Arch::availablePlacers.begin(), Arch::availablePlacers.end(), placer) ==
@@ -535,6 +560,16 @@ void CommandHandler::setupContext(Context *ctx)
         ctx->settings[ctx->id("placerHeap/cellPlacementTimeout")] =
                 std::to_string(std::max(0, vm["placer-heap-cell-placement-timeout"].as<int>()));
 
+    if (vm.count("placer-heap-parallel-solver"))
+        ctx->settings[ctx->id("placerHeap/parallelSolver")] = true;
+
+    if (vm.count("placer-heap-parallel-legalise"))
+        ctx->settings[ctx->id("placerHeap/parallelLegalise")] = true;
+
+    if (vm.count("placer-heap-legalise-region-size"))
+        ctx->settings[ctx->id("placerHeap/legaliseRegionSize")] =
+                std::to_string(std::max(1, vm["placer-heap-legalise-region-size"].as<int>()));
+
     if (vm.count("parallel-refine"))
         ctx->settings[ctx->id("placerHeap/parallelRefine")] = true;
 
@@ -546,6 +581,9 @@ void CommandHandler::setupContext(Context *ctx)
     if (vm.count("router2-alt-weights"))
         ctx->settings[ctx->id("router2/alt-weights")] = true;
 
+    if (vm.count("router2-speculative"))
+        ctx->settings[ctx->id("router2/speculative")] = true;
+
     if (vm.count("static-dump-density"))
         ctx->settings[ctx->id("static/dump_density")] = true;
 
@@ -596,6 +634,9 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
         ctx->settings[ctx->id("frontend/top")] = vm["top"].as<std::string>();
     }
 
+    if (vm.count("profile-out"))
+        ctx->profiler.enabled = true;
+
 #ifndef NO_GUI
     if (vm.count("gui")) {
         Application a(argc, argv, (vm.count("gui-no-aa") > 0));
@@ -603,8 +644,7 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
         try {
             if (vm.count("json")) {
                 std::string filename = vm["json"].as<std::string>();
-                std::ifstream f(filename);
-                if (!parse_json(f, filename, w.getContext()))
+                if (!parse_json_file(filename, w.getContext()))
                     log_error("Loading design failed.\n");
 
                 if (vm.count("sdc")) {
@@ -628,9 +668,9 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
     }
 #endif
     if (vm.count("json")) {
+        ProfileScope prof_scope(ctx->profiler, "load");
         std::string filename = vm["json"].as<std::string>();
-        std::ifstream f(filename);
-        if (!parse_json(f, filename, ctx.get()))
+        if (!parse_json_file(filename, ctx.get()))
             log_error("Loading design failed.\n");
 
         if (vm.count("sdc")) {
@@ -642,6 +682,13 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
         customAfterLoad(ctx.get());
     }
 
+    if (vm.count("load-checkpoint")) {
+        conflicting_options(vm, "json", "load-checkpoint");
+        // Constraint files were already applied before the checkpoint was saved, so customAfterLoad isn't needed
+        if (!read_checkpoint(vm["load-checkpoint"].as<std::string>(), ctx.get()))
+            log_error("Loading checkpoint failed.\n");
+    }
+
 #ifndef NO_PYTHON
     init_python(argv[0]);
     python_export_global("ctx", *ctx);
@@ -660,6 +707,7 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
 
         if (do_pack) {
             run_script_hook("pre-pack");
+            ProfileScope prof_scope(ctx->profiler, "pack");
             if (!ctx->pack() && !ctx->force)
                 log_error("Packing design failed.\n");
         }
@@ -671,8 +719,11 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
             bool saved_debug = ctx->debug;
             if (vm.count("debug-placer"))
                 ctx->debug = true;
-            if (!ctx->place() && !ctx->force)
-                log_error("Placing design failed.\n");
+            {
+                ProfileScope prof_scope(ctx->profiler, "place");
+                if (!ctx->place() && !ctx->force)
+                    log_error("Placing design failed.\n");
+            }
             ctx->debug = saved_debug;
             ctx->check();
             if (vm.count("placed-svg"))
@@ -684,14 +735,18 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
             bool saved_debug = ctx->debug;
             if (vm.count("debug-router"))
                 ctx->debug = true;
-            if (!ctx->route() && !ctx->force)
-                log_error("Routing design failed.\n");
+            {
+                ProfileScope prof_scope(ctx->profiler, "route");
+                if (!ctx->route() && !ctx->force)
+                    log_error("Routing design failed.\n");
+            }
             ctx->debug = saved_debug;
             run_script_hook("post-route");
             if (vm.count("routed-svg"))
                 ctx->writeSVG(vm["routed-svg"].as<std::string>(), "scale=500");
         }
 
+        ProfileScope prof_scope(ctx->profiler, "bitstream");
         customBitstream(ctx.get());
     }
 
@@ -702,6 +757,11 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
             log_error("Saving design failed.\n");
     }
 
+    if (vm.count("save-checkpoint")) {
+        if (!write_checkpoint(vm["save-checkpoint"].as<std::string>(), ctx.get()))
+            log_error("Saving checkpoint failed.\n");
+    }
+
     if (vm.count("sdf")) {
         std::string filename = vm["sdf"].as<std::string>();
         std::ofstream f(filename);
@@ -718,6 +778,17 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
         ctx->writeJsonReport(f);
     }
 
+    if (vm.count("profile-out")) {
+        std::string filename = vm["profile-out"].as<std::string>();
+        std::ofstream f(filename);
+        if (!f)
+            log_error("Failed to open profile file '%s' for writing.\n", filename.c_str());
+        if (boost::algorithm::ends_with(filename, ".json"))
+            ctx->profiler.write_trace(f);
+        else
+            ctx->profiler.write_folded(f);
+    }
+
 #ifndef NO_PYTHON
     deinit_python();
 #endif
@@ -771,11 +842,8 @@ void CommandHandler::load_json(Context *ctx, std::string filename)
 {
     setupContext(ctx);
     setupArchContext(ctx);
-    {
-        std::ifstream f(filename);
-        if (!parse_json(f, filename, ctx))
-            log_error("Loading design failed.\n");
-    }
+    if (!parse_json_file(filename, ctx))
+        log_error("Loading design failed.\n");
 }
 
 void CommandHandler::clear() { vm.clear(); }
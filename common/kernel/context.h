@@ -28,12 +28,17 @@
 
 NEXTPNR_NAMESPACE_BEGIN
 
+struct FastBelsCache;
+
 struct Context : Arch, DeterministicRNG
 {
     bool verbose = false;
     bool debug = false;
     bool force = false;
 
+    // Bels valid for each cell type, shared by the placers; see fast_bels.h
+    std::shared_ptr<FastBelsCache> fast_bels_cache;
+
     // Should we disable printing of the location of nets in the critical path?
     bool disable_critical_path_source_print = false;
     // True when detailed per-net timing is to be stored / reported
@@ -0,0 +1,141 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  The nextpnr Authors
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "idstring_db.h"
+
+#include <functional>
+#include <limits>
+
+#include "bits.h"
+#include "nextpnr_assertions.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+IdStringDb::IdStringDb()
+{
+    for (auto &block : blocks)
+        block.store(nullptr, std::memory_order_relaxed);
+    for (auto &shard : shards)
+        shard.slots.resize(16, Slot{0, -1});
+}
+
+IdStringDb::~IdStringDb()
+{
+    for (auto &block : blocks)
+        delete[] block.load(std::memory_order_relaxed);
+}
+
+uint32_t IdStringDb::hash(std::string_view s) { return uint32_t(std::hash<std::string_view>{}(s)); }
+
+int IdStringDb::find(const Shard &shard, std::string_view s, uint32_t h) const
+{
+    size_t mask = shard.slots.size() - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+        const Slot &slot = shard.slots[i];
+        if (slot.idx == -1)
+            return -1;
+        if (slot.hash == h && str(slot.idx) == s)
+            return slot.idx;
+    }
+}
+
+void IdStringDb::insert(Shard &shard, uint32_t h, int idx)
+{
+    // Keep the load factor below one half
+    if ((shard.used + 1) * 2 > int(shard.slots.size())) {
+        std::vector<Slot> old_slots(shard.slots.size() * 2, Slot{0, -1});
+        std::swap(old_slots, shard.slots);
+        shard.used = 0;
+        for (auto &slot : old_slots)
+            if (slot.idx != -1)
+                insert(shard, slot.hash, slot.idx);
+    }
+    size_t mask = shard.slots.size() - 1;
+    size_t i = h & mask;
+    while (shard.slots[i].idx != -1)
+        i = (i + 1) & mask;
+    shard.slots[i] = Slot{h, idx};
+    ++shard.used;
+}
+
+std::string &IdStringDb::entry(int idx)
+{
+    unsigned int j = unsigned(idx) + (1u << first_block_bits);
+    int msb = (std::numeric_limits<unsigned int>::digits - 1) - Bits::clz(j);
+    int b = msb - first_block_bits;
+    NPNR_ASSERT(b < max_blocks);
+    std::string *block = blocks[b].load(std::memory_order_acquire);
+    if (block == nullptr) {
+#ifndef NPNR_DISABLE_THREADS
+        std::lock_guard<std::mutex> lock(block_mutex);
+#endif
+        block = blocks[b].load(std::memory_order_acquire);
+        if (block == nullptr) {
+            block = new std::string[size_t(1) << msb];
+            blocks[b].store(block, std::memory_order_release);
+        }
+    }
+    return block[j - (1u << msb)];
+}
+
+const std::string &IdStringDb::str(int idx) const
+{
+    NPNR_ASSERT(idx >= 0 && idx < size());
+    unsigned int j = unsigned(idx) + (1u << first_block_bits);
+    int msb = (std::numeric_limits<unsigned int>::digits - 1) - Bits::clz(j);
+    return blocks[msb - first_block_bits].load(std::memory_order_acquire)[j - (1u << msb)];
+}
+
+int IdStringDb::lookup(std::string_view s) const
+{
+    uint32_t h = hash(s);
+    const Shard &shard = shards[h >> (32 - shard_bits)];
+#ifndef NPNR_DISABLE_THREADS
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+#endif
+    return find(shard, s, h);
+}
+
+int IdStringDb::intern(std::string_view s)
+{
+    uint32_t h = hash(s);
+    Shard &shard = shards[h >> (32 - shard_bits)];
+    {
+#ifndef NPNR_DISABLE_THREADS
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+#endif
+        int idx = find(shard, s, h);
+        if (idx != -1)
+            return idx;
+    }
+#ifndef NPNR_DISABLE_THREADS
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+#endif
+    // Another thread might have added it while we weren't holding the lock
+    int idx = find(shard, s, h);
+    if (idx != -1)
+        return idx;
+    // Anyone else can only find the new index through this shard, so the string is in place before it is used
+    idx = count.fetch_add(1, std::memory_order_acq_rel);
+    entry(idx) = s;
+    insert(shard, h, idx);
+    return idx;
+}
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,99 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  The nextpnr Authors
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef IDSTRING_DB_H
+#define IDSTRING_DB_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef NPNR_DISABLE_THREADS
+#include <mutex>
+#include <shared_mutex>
+#endif
+
+#include "nextpnr_namespaces.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// The string <-> index table behind IdString.
+//
+// Lookups take a string_view so don't need a temporary std::string, and are safe to do from multiple threads. The
+// hash table is split into shards by hash, each with its own lock, so threads interning different names rarely
+// contend. Strings live in geometrically sized blocks that are never reallocated, so the references returned by
+// str() stay valid as the table grows. When names are only ever added from one thread, indices are allocated in
+// order exactly as before; names added concurrently get indices in whatever order the threads reach the table.
+struct IdStringDb
+{
+    IdStringDb();
+    ~IdStringDb();
+
+    IdStringDb(const IdStringDb &) = delete;
+    IdStringDb &operator=(const IdStringDb &) = delete;
+
+    // Get the index of s, adding it if not already present
+    int intern(std::string_view s);
+    // Get the index of s, or -1 if not present
+    int lookup(std::string_view s) const;
+
+    const std::string &str(int idx) const;
+    // Number of indices that have been handed out
+    int size() const { return count.load(std::memory_order_acquire); }
+
+  private:
+    static const int shard_bits = 6;
+    static const int first_block_bits = 10;
+    static const int max_blocks = 32 - first_block_bits;
+
+    struct Slot
+    {
+        uint32_t hash;
+        int idx; // -1 for an empty slot
+    };
+
+    struct Shard
+    {
+#ifndef NPNR_DISABLE_THREADS
+        mutable std::shared_mutex mutex;
+#endif
+        std::vector<Slot> slots; // open addressing, size is a power of two
+        int used = 0;
+    };
+
+    Shard shards[1 << shard_bits];
+
+    // Block b holds (1 << (first_block_bits + b)) strings
+    std::atomic<std::string *> blocks[max_blocks];
+    std::atomic<int> count{0};
+#ifndef NPNR_DISABLE_THREADS
+    std::mutex block_mutex;
+#endif
+
+    static uint32_t hash(std::string_view s);
+    int find(const Shard &shard, std::string_view s, uint32_t h) const;
+    void insert(Shard &shard, uint32_t h, int idx);
+    std::string &entry(int idx);
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif /* IDSTRING_DB_H */
@@ -456,6 +456,9 @@ struct CriticalPath
     // Clock pair
     ClockPair clock_pair;
 
+    // Timing corner the path was analysed at, when there is more than one
+    IdString corner;
+
     // if sum[segments.delay] < 0 this is a hold/min violation
     // if sum[segments.delay] > max_delay this is a setup/max violation
     delay_t max_delay;
@@ -475,6 +478,14 @@ struct NetSinkTiming
     DelayPair delay;
 };
 
+// Results for a single timing corner
+struct TimingCornerResult
+{
+    IdString name;
+    dict<IdString, ClockFmax> clock_fmax;
+    dict<IdString, CriticalPath> clock_paths;
+};
+
 struct TimingResult
 {
     // Achieved and target Fmax for all clock domains
@@ -494,6 +505,10 @@ struct TimingResult
 
     // Min delay violations, only hold time for now
     std::vector<CriticalPath> min_delay_violations;
+
+    // Per-corner Fmax and critical paths, only when analysing more than one corner; the results above are then for the
+    // worst corner
+    std::vector<TimingCornerResult> corners;
 };
 
 // Represents the contents of a non-leaf cell in a design
@@ -0,0 +1,176 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  The nextpnr Authors
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <ostream>
+
+#include "nextpnr_assertions.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+struct OpenScope
+{
+    Profiler *profiler;
+    const char *name;
+    int64_t start;
+    // Total time of the scopes nested directly inside this one
+    int64_t child_time;
+};
+
+// Scopes nest per thread, so each thread keeps its own stack of open ones
+thread_local std::vector<OpenScope> open_scopes;
+
+int thread_index()
+{
+    static std::atomic<int> next_index{0};
+    thread_local int index = next_index++;
+    return index;
+}
+
+void write_json_string(std::ostream &out, const std::string &str)
+{
+    out << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+} // namespace
+
+Profiler::Profiler() : epoch(std::chrono::steady_clock::now()), main_thread(thread_index()) {}
+
+int64_t Profiler::now() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Profiler::add_count(const char *name, int64_t amount)
+{
+    if (!enabled)
+        return;
+    int64_t time = now();
+#ifndef NPNR_DISABLE_THREADS
+    std::lock_guard<std::mutex> lock(mutex);
+#endif
+    int64_t &total = counters[name];
+    total += amount;
+    samples.push_back(CounterSample{name, time, total});
+}
+
+int64_t Profiler::get_count(const char *name) const
+{
+#ifndef NPNR_DISABLE_THREADS
+    std::lock_guard<std::mutex> lock(mutex);
+#endif
+    auto fnd = counters.find(name);
+    return (fnd != counters.end()) ? fnd->second : 0;
+}
+
+void Profiler::add_scope(const char *name, const std::string &path, int thread, int64_t start, int64_t duration,
+                         int64_t self_time)
+{
+#ifndef NPNR_DISABLE_THREADS
+    std::lock_guard<std::mutex> lock(mutex);
+#endif
+    events.push_back(ScopeEvent{name, thread, start, duration});
+    path_time[path] += self_time;
+}
+
+void Profiler::write_trace(std::ostream &out) const
+{
+#ifndef NPNR_DISABLE_THREADS
+    std::lock_guard<std::mutex> lock(mutex);
+#endif
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    out << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"nextpnr\"}}";
+    std::vector<int> threads;
+    for (auto &ev : events)
+        threads.push_back(ev.thread);
+    std::sort(threads.begin(), threads.end());
+    threads.erase(std::unique(threads.begin(), threads.end()), threads.end());
+    for (int thread : threads) {
+        out << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread
+            << ", \"args\": {\"name\": \"" << ((thread == main_thread) ? "main" : "worker") << "\"}}";
+    }
+    for (auto &ev : events) {
+        out << ",\n{\"name\": ";
+        write_json_string(out, ev.name);
+        out << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << ev.thread << ", \"ts\": " << ev.start
+            << ", \"dur\": " << ev.duration << "}";
+    }
+    for (auto &s : samples) {
+        out << ",\n{\"name\": ";
+        write_json_string(out, s.name);
+        out << ", \"ph\": \"C\", \"pid\": 1, \"ts\": " << s.time << ", \"args\": {\"count\": " << s.total << "}}";
+    }
+    out << "\n]}\n";
+}
+
+void Profiler::write_folded(std::ostream &out) const
+{
+#ifndef NPNR_DISABLE_THREADS
+    std::lock_guard<std::mutex> lock(mutex);
+#endif
+    std::vector<std::pair<std::string, int64_t>> paths(path_time.begin(), path_time.end());
+    std::sort(paths.begin(), paths.end());
+    for (auto &p : paths) {
+        if (p.second > 0)
+            out << p.first << " " << p.second << "\n";
+    }
+}
+
+ProfileScope::ProfileScope(Profiler &profiler, const char *name) : profiler(profiler.enabled ? &profiler : nullptr)
+{
+    if (this->profiler != nullptr)
+        open_scopes.push_back(OpenScope{this->profiler, name, this->profiler->now(), 0});
+}
+
+ProfileScope::~ProfileScope()
+{
+    if (profiler == nullptr)
+        return;
+    NPNR_ASSERT(!open_scopes.empty() && open_scopes.back().profiler == profiler);
+    OpenScope scope = open_scopes.back();
+    int64_t duration = profiler->now() - scope.start;
+    std::string path;
+    for (auto &s : open_scopes) {
+        if (s.profiler != profiler)
+            continue;
+        if (!path.empty())
+            path += ';';
+        path += s.name;
+    }
+    open_scopes.pop_back();
+    for (auto it = open_scopes.rbegin(); it != open_scopes.rend(); ++it) {
+        if (it->profiler == profiler) {
+            it->child_time += duration;
+            break;
+        }
+    }
+    profiler->add_scope(scope.name, path, thread_index(), scope.start, duration,
+                        std::max<int64_t>(0, duration - scope.child_time));
+}
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,107 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  The nextpnr Authors
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#ifndef NPNR_DISABLE_THREADS
+#include <mutex>
+#endif
+
+#include "hashlib.h"
+#include "nextpnr_namespaces.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Built-in instrumentation, for seeing where the time goes without an external profiler.
+//
+// Passes mark out timed scopes with ProfileScope. Scopes nest within each thread to form a call tree. Passes also add
+// to named counters for the work they do (arcs routed, moves evaluated, ...). Nothing is recorded unless the profiler
+// is enabled, so the instrumentation can stay in. Scopes should still cover whole stages or iterations rather than
+// single nets or moves, and counters should be added to once per batch. Scope and counter names must stay valid for
+// the life of the profiler; in practice they are string literals, named "pass/what".
+struct Profiler
+{
+    bool enabled = false;
+
+    Profiler();
+
+    void add_count(const char *name, int64_t amount);
+    int64_t get_count(const char *name) const;
+
+    // Chrome trace-event JSON, which can be opened with chrome://tracing or Perfetto. Threads are named in the
+    // metadata, with the one that created the profiler named "main"
+    void write_trace(std::ostream &out) const;
+    // Folded stacks, one call path per line with its self time in microseconds, as used by flamegraph.pl
+    void write_folded(std::ostream &out) const;
+
+  private:
+    friend struct ProfileScope;
+
+    struct ScopeEvent
+    {
+        const char *name;
+        int thread;
+        int64_t start, duration;
+    };
+
+    struct CounterSample
+    {
+        const char *name;
+        int64_t time, total;
+    };
+
+#ifndef NPNR_DISABLE_THREADS
+    mutable std::mutex mutex;
+#endif
+    std::chrono::steady_clock::time_point epoch;
+    int main_thread;
+    std::vector<ScopeEvent> events;
+    std::vector<CounterSample> samples;
+    dict<std::string, int64_t> counters;
+    // Self time of each call path, with scope names separated by ';'
+    dict<std::string, int64_t> path_time;
+
+    int64_t now() const;
+    void add_scope(const char *name, const std::string &path, int thread, int64_t start, int64_t duration,
+                   int64_t self_time);
+};
+
+// Times a scope from construction to destruction. Only recorded if the profiler was enabled when the scope started.
+struct ProfileScope
+{
+    ProfileScope(Profiler &profiler, const char *name);
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+  private:
+    Profiler *profiler;
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif /* PROFILER_H */
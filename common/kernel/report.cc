@@ -51,65 +51,83 @@ static std::string clock_event_name(const Context *ctx, const ClockEvent &e)
     return value;
 };
 
-static Json::array json_report_critical_paths(const Context *ctx)
+static Json::object json_report_critical_path(const Context *ctx, const CriticalPath &report)
 {
+    Json::array pathJson;
 
-    auto report_critical_path = [ctx](const CriticalPath &report) {
-        Json::array pathJson;
-
-        for (const auto &segment : report.segments) {
-
-            const auto &driver = ctx->cells.at(segment.from.first);
-            const auto &sink = ctx->cells.at(segment.to.first);
+    for (const auto &segment : report.segments) {
 
-            auto fromLoc = ctx->getBelLocation(driver->bel);
-            auto toLoc = ctx->getBelLocation(sink->bel);
+        const auto &driver = ctx->cells.at(segment.from.first);
+        const auto &sink = ctx->cells.at(segment.to.first);
 
-            auto fromJson = Json::object({{"cell", segment.from.first.c_str(ctx)},
-                                          {"port", segment.from.second.c_str(ctx)},
-                                          {"loc", Json::array({fromLoc.x, fromLoc.y})}});
+        auto fromLoc = ctx->getBelLocation(driver->bel);
+        auto toLoc = ctx->getBelLocation(sink->bel);
 
-            auto toJson = Json::object({{"cell", segment.to.first.c_str(ctx)},
-                                        {"port", segment.to.second.c_str(ctx)},
-                                        {"loc", Json::array({toLoc.x, toLoc.y})}});
+        auto fromJson = Json::object({{"cell", segment.from.first.c_str(ctx)},
+                                      {"port", segment.from.second.c_str(ctx)},
+                                      {"loc", Json::array({fromLoc.x, fromLoc.y})}});
 
-            auto segmentJson = Json::object({
-                    {"delay", ctx->getDelayNS(segment.delay)},
-                    {"from", fromJson},
-                    {"to", toJson},
-            });
+        auto toJson = Json::object({{"cell", segment.to.first.c_str(ctx)},
+                                    {"port", segment.to.second.c_str(ctx)},
+                                    {"loc", Json::array({toLoc.x, toLoc.y})}});
 
-            segmentJson["type"] = CriticalPath::Segment::type_to_str(segment.type);
-            if (segment.type == CriticalPath::Segment::Type::ROUTING) {
-                segmentJson["net"] = segment.net.c_str(ctx);
-            }
+        auto segmentJson = Json::object({
+                {"delay", ctx->getDelayNS(segment.delay)},
+                {"from", fromJson},
+                {"to", toJson},
+        });
 
-            pathJson.push_back(segmentJson);
+        segmentJson["type"] = CriticalPath::Segment::type_to_str(segment.type);
+        if (segment.type == CriticalPath::Segment::Type::ROUTING) {
+            segmentJson["net"] = segment.net.c_str(ctx);
         }
 
-        return pathJson;
-    };
+        pathJson.push_back(segmentJson);
+    }
+
+    auto reportJson = Json::object({{"from", clock_event_name(ctx, report.clock_pair.start)},
+                                    {"to", clock_event_name(ctx, report.clock_pair.end)},
+                                    {"path", pathJson}});
+    if (report.corner != IdString())
+        reportJson["corner"] = report.corner.c_str(ctx);
+    return reportJson;
+}
 
+static Json::array json_report_critical_paths(const Context *ctx)
+{
     auto critPathsJson = Json::array();
 
     // Critical paths
-    for (auto &report : ctx->timing_result.clock_paths) {
-
-        critPathsJson.push_back(Json::object({{"from", clock_event_name(ctx, report.second.clock_pair.start)},
-                                              {"to", clock_event_name(ctx, report.second.clock_pair.end)},
-                                              {"path", report_critical_path(report.second)}}));
-    }
+    for (auto &report : ctx->timing_result.clock_paths)
+        critPathsJson.push_back(json_report_critical_path(ctx, report.second));
 
     // Cross-domain paths
-    for (auto &report : ctx->timing_result.xclock_paths) {
-        critPathsJson.push_back(Json::object({{"from", clock_event_name(ctx, report.clock_pair.start)},
-                                              {"to", clock_event_name(ctx, report.clock_pair.end)},
-                                              {"path", report_critical_path(report)}}));
-    }
+    for (auto &report : ctx->timing_result.xclock_paths)
+        critPathsJson.push_back(json_report_critical_path(ctx, report));
 
     return critPathsJson;
 }
 
+static Json::array json_report_corners(const Context *ctx)
+{
+    auto cornersJson = Json::array();
+    for (auto &corner : ctx->timing_result.corners) {
+        dict<std::string, Json> fmax_json;
+        for (const auto &kv : corner.clock_fmax) {
+            fmax_json[kv.first.str(ctx)] = Json::object{
+                    {"achieved", kv.second.achieved},
+                    {"constraint", kv.second.constraint},
+            };
+        }
+        auto pathsJson = Json::array();
+        for (auto &report : corner.clock_paths)
+            pathsJson.push_back(json_report_critical_path(ctx, report.second));
+        cornersJson.push_back(Json::object{
+                {"name", corner.name.c_str(ctx)}, {"fmax", fmax_json}, {"critical_paths", pathsJson}});
+    }
+    return cornersJson;
+}
+
 static Json::array json_report_detailed_net_timings(const Context *ctx)
 {
     auto detailedNetTimingsJson = Json::array();
@@ -166,6 +184,7 @@ Report JSON structure:
     {
       "from": <clock event edge and name>,
       "to": <clock event edge and name>,
+      "corner": <timing corner name (only with more than one corner)>,
       "path": [
         {
           "from": {
@@ -193,6 +212,14 @@ Report JSON structure:
     },
     ...
   ],
+  "corners": [ (only with more than one timing corner; "fmax" and "critical_paths" above are for the worst corner)
+    {
+      "name": <timing corner name>,
+      "fmax": <as above, for this corner>,
+      "critical_paths": <as above, for single domain paths at this corner>
+    },
+    ...
+  ],
   "detailed_net_timings": [
     {
       "driver": <driving cell name>,
@@ -238,6 +265,10 @@ void Context::writeJsonReport(std::ostream &out) const
     Json::object jsonRoot{
             {"utilization", util_json}, {"fmax", fmax_json}, {"critical_paths", json_report_critical_paths(this)}};
 
+    if (!timing_result.corners.empty()) {
+        jsonRoot["corners"] = json_report_corners(this);
+    }
+
     if (detailed_timing_report) {
         jsonRoot["detailed_net_timings"] = json_report_detailed_net_timings(this);
     }
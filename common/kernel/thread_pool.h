@@ -0,0 +1,128 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2023  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#ifndef NPNR_DISABLE_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#include "nextpnr_namespaces.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// A fixed set of worker threads; run(N, func) calls func(0..N-1), with each worker taking a contiguous chunk, and
+// returns once all of them are done. run must not be called from inside func.
+#ifdef NPNR_DISABLE_THREADS
+struct ThreadPool
+{
+    ThreadPool(int) {};
+
+    void run(int N, std::function<void(int)> func)
+    {
+        for (int i = 0; i < N; i++)
+            func(i);
+    };
+};
+#else
+struct ThreadPool
+{
+    ThreadPool(int thread_count)
+    {
+        done.resize(thread_count, false);
+        for (int i = 0; i < thread_count; i++) {
+            threads.emplace_back([this, i]() { this->worker(i); });
+        }
+    }
+    std::vector<std::thread> threads;
+    std::condition_variable cv_start, cv_done;
+    std::mutex mutex;
+
+    bool work_available = false;
+    bool shutdown = false;
+    std::vector<bool> done;
+    std::function<void(int)> work;
+    int work_count;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard lk(mutex);
+            shutdown = true;
+        }
+        cv_start.notify_all();
+        for (auto &t : threads)
+            t.join();
+    }
+
+    void run(int N, std::function<void(int)> func)
+    {
+        {
+            std::lock_guard lk(mutex);
+            work = func;
+            work_count = N;
+            work_available = true;
+            std::fill(done.begin(), done.end(), false);
+        }
+        cv_start.notify_all();
+        {
+            std::unique_lock lk(mutex);
+            cv_done.wait(lk, [this] { return std::all_of(done.begin(), done.end(), [](bool x) { return x; }); });
+            work_available = false;
+        }
+    }
+
+    void worker(int idx)
+    {
+        while (true) {
+            std::unique_lock lk(mutex);
+            cv_start.wait(lk, [this, idx] { return (work_available && !done.at(idx)) || shutdown; });
+            if (shutdown) {
+                lk.unlock();
+                break;
+            } else if (work_available && !done.at(idx)) {
+                int work_per_thread = (work_count + int(threads.size()) - 1) / threads.size();
+                int begin = work_per_thread * idx;
+                int end = std::min(work_count, work_per_thread * (idx + 1));
+                lk.unlock();
+
+                for (int j = begin; j < end; j++) {
+                    work(j);
+                }
+
+                lk.lock();
+                done.at(idx) = true;
+                lk.unlock();
+                cv_done.notify_one();
+            }
+        }
+    }
+};
+#endif
+
+NEXTPNR_NAMESPACE_END
+
+#endif
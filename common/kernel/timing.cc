@@ -21,6 +21,7 @@
 
 #include "timing.h"
 #include <algorithm>
+#include <boost/algorithm/string.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 #include <deque>
 #include <map>
@@ -29,7 +30,51 @@
 
 NEXTPNR_NAMESPACE_BEGIN
 
-TimingAnalyser::TimingAnalyser(Context *ctx) : ctx(ctx)
+namespace {
+// Below these sizes, the overhead of handing work to threads outweighs the gain
+const int min_parallel_ports = 20000;
+const int min_parallel_range = 256;
+
+DelayPair derate(DelayPair value, float factor)
+{
+    if (factor == 1.0f)
+        return value;
+    return DelayPair(delay_t(value.min_delay * factor), delay_t(value.max_delay * factor));
+}
+} // namespace
+
+std::vector<TimingCorner> get_timing_corners(const Context *ctx)
+{
+    std::vector<TimingCorner> corners;
+    std::string setting = str_or_default(ctx->settings, ctx->id("timing/corners"), "");
+    std::vector<std::string> entries;
+    boost::split(entries, setting, boost::is_any_of(","));
+    for (auto &entry : entries) {
+        if (entry.empty())
+            continue;
+        std::vector<std::string> fields;
+        boost::split(fields, entry, boost::is_any_of(":"));
+        if (fields.size() < 2 || fields.size() > 3 || fields.at(0).empty())
+            log_error("Invalid timing corner '%s', expected name:cell_derate[:route_derate].\n", entry.c_str());
+        TimingCorner corner;
+        corner.name = ctx->id(fields.at(0));
+        try {
+            corner.cell_derate = std::stof(fields.at(1));
+            corner.route_derate = (fields.size() > 2) ? std::stof(fields.at(2)) : corner.cell_derate;
+        } catch (std::exception &) {
+            log_error("Invalid derating factor in timing corner '%s'.\n", entry.c_str());
+        }
+        for (auto &other : corners)
+            if (other.name == corner.name)
+                log_error("Timing corner '%s' is defined more than once.\n", fields.at(0).c_str());
+        corners.push_back(corner);
+    }
+    if (corners.empty())
+        corners.emplace_back();
+    return corners;
+}
+
+TimingAnalyser::TimingAnalyser(Context *ctx) : ctx(ctx), corners(get_timing_corners(ctx))
 {
     ClockDomainKey key{IdString(), ClockEdge::RISING_EDGE};
     domain_to_id.emplace(key, 0);
@@ -37,11 +82,73 @@ TimingAnalyser::TimingAnalyser(Context *ctx) : ctx(ctx)
     async_clock_id = 0;
 };
 
+TimingAnalyser::CornerDelays TimingAnalyser::corner_delays(DelayPair value, bool route) const
+{
+    CornerDelays result(corners.size());
+    for (size_t c = 0; c < corners.size(); c++)
+        result[c] = derate(value, route ? corners.at(c).route_derate : corners.at(c).cell_derate);
+    return result;
+}
+
+delay_t TimingAnalyser::clock_to_clock_delay(IdString launch_clock, IdString capture_clock, int corner) const
+{
+    auto fnd = clock_delays.find(std::make_pair(launch_clock, capture_clock));
+    if (fnd == clock_delays.end())
+        return 0;
+    return derate(DelayPair(fnd->second), corners.at(corner).cell_derate).maxDelay();
+}
+
+template <typename Tf> void TimingAnalyser::for_each_fanin(const CellPortKey &port, Tf func)
+{
+    auto &pd = ports.at(port);
+    if (pd.type == PORT_IN) {
+        const NetInfo *net = port_info(port).net;
+        if (net != nullptr && net->driver.cell != nullptr)
+            func(CellPortKey(net->driver));
+    } else if (pd.type == PORT_OUT) {
+        for (auto &fanin : pd.cell_arcs)
+            if (fanin.type == CellArc::COMBINATIONAL)
+                func(CellPortKey(port.cell, fanin.other_port));
+    }
+}
+
+template <typename Tf> void TimingAnalyser::for_each_fanout(const CellPortKey &port, Tf func)
+{
+    auto &pd = ports.at(port);
+    if (pd.type == PORT_OUT) {
+        const NetInfo *net = port_info(port).net;
+        if (net != nullptr)
+            for (auto &usr : net->users)
+                func(CellPortKey(usr));
+    } else if (pd.type == PORT_IN) {
+        for (auto &fanout : pd.cell_arcs)
+            if (fanout.type == CellArc::COMBINATIONAL)
+                func(CellPortKey(port.cell, fanout.other_port));
+    }
+}
+
+template <typename Tf> void TimingAnalyser::for_each_in_order(int begin, int end, Tf func)
+{
+    if (thread_pool && (end - begin) >= min_parallel_range) {
+        thread_pool->run(end - begin, [&](int i) { func(topological_order.at(begin + i)); });
+    } else {
+        for (int i = begin; i < end; i++)
+            func(topological_order.at(i));
+    }
+}
+
 void TimingAnalyser::setup(bool update_net_timings, bool update_histogram, bool update_crit_paths)
 {
+    times_valid = false;
     init_ports();
     get_cell_delays();
     topo_sort();
+    levelize();
+    if (!level_starts.empty())
+        setup_pull_lists();
+    int threads = int_or_default(ctx->settings, ctx->id("threads"), 8);
+    if (!thread_pool && threads > 1 && !level_starts.empty() && int(ports.size()) >= min_parallel_ports)
+        thread_pool = std::make_unique<ThreadPool>(threads);
     setup_port_domains();
     identify_related_domains();
     run(true, update_net_timings, update_histogram, update_crit_paths);
@@ -50,13 +157,21 @@ void TimingAnalyser::setup(bool update_net_timings, bool update_histogram, bool
 void TimingAnalyser::run(bool update_route_delays, bool update_net_timings, bool update_histogram,
                          bool update_crit_paths)
 {
-    reset_times();
+    ProfileScope prof_scope(ctx->profiler, "timing/analyse");
     if (update_route_delays)
         get_route_delays();
-    walk_forward();
-    walk_backward();
-    compute_slack();
-    compute_criticality();
+    if (!incremental || !run_incremental()) {
+        ctx->profiler.add_count("timing/ports_analysed", int64_t(ports.size()));
+        reset_times();
+        walk_forward();
+        walk_backward();
+        compute_slack();
+        compute_criticality();
+    }
+    for (auto &port : changed_ports)
+        ports.at(port).route_delay_changed = false;
+    changed_ports.clear();
+    times_valid = true;
 
     // Ensure we clear all timing results if any of them has been marked as
     // as to be updated. This is done so we ensure it's not possible to have
@@ -87,6 +202,8 @@ void TimingAnalyser::init_ports()
             auto &data = ports[CellPortKey(ci->name, port.first)];
             data.type = port.second.type;
             data.cell_port = CellPortKey(ci->name, port.first);
+            if (data.route_delay.size() != corners.size())
+                data.route_delay = CornerDelays(corners.size(), DelayPair(0));
         }
     }
 }
@@ -116,15 +233,16 @@ void TimingAnalyser::get_cell_delays()
                     auto info = ctx->getPortClockingInfo(ci, name, i);
                     if (!ci->ports.count(info.clock_port) || ci->ports.at(info.clock_port).net == nullptr)
                         continue;
-                    pd.cell_arcs.emplace_back(CellArc::SETUP, info.clock_port, DelayQuad(info.setup, info.setup),
+                    pd.cell_arcs.emplace_back(CellArc::SETUP, info.clock_port, corner_delays(info.setup, false),
                                               info.edge);
-                    pd.cell_arcs.emplace_back(CellArc::HOLD, info.clock_port, DelayQuad(info.hold, info.hold),
+                    pd.cell_arcs.emplace_back(CellArc::HOLD, info.clock_port, corner_delays(info.hold, false),
                                               info.edge);
                 }
             }
             // asynchronous endpoint
             else if (cls == TMG_ENDPOINT) {
-                pd.cell_arcs.emplace_back(CellArc::ENDPOINT, async_clk_key.key.clock, DelayQuad{});
+                pd.cell_arcs.emplace_back(CellArc::ENDPOINT, async_clk_key.key.clock,
+                                          corner_delays(DelayPair{}, false));
             }
             // Combinational delays through cell
             for (auto &other_port : ci->ports) {
@@ -135,7 +253,8 @@ void TimingAnalyser::get_cell_delays()
                 DelayQuad delay;
                 bool is_path = ctx->getCellDelay(ci, name, other_port.first, delay);
                 if (is_path)
-                    pd.cell_arcs.emplace_back(CellArc::COMBINATIONAL, other_port.first, delay);
+                    pd.cell_arcs.emplace_back(CellArc::COMBINATIONAL, other_port.first,
+                                              corner_delays(delay.delayPair(), false));
             }
         } else if (pi.type == PORT_OUT) {
             // Output ports might have clk-to-q relationships
@@ -144,12 +263,14 @@ void TimingAnalyser::get_cell_delays()
                     auto info = ctx->getPortClockingInfo(ci, name, i);
                     if (!ci->ports.count(info.clock_port) || ci->ports.at(info.clock_port).net == nullptr)
                         continue;
-                    pd.cell_arcs.emplace_back(CellArc::CLK_TO_Q, info.clock_port, info.clockToQ, info.edge);
+                    pd.cell_arcs.emplace_back(CellArc::CLK_TO_Q, info.clock_port,
+                                              corner_delays(info.clockToQ.delayPair(), false), info.edge);
                 }
             }
             // Asynchronous startpoint
             else if (cls == TMG_STARTPOINT) {
-                pd.cell_arcs.emplace_back(CellArc::STARTPOINT, async_clk_key.key.clock, DelayQuad{});
+                pd.cell_arcs.emplace_back(CellArc::STARTPOINT, async_clk_key.key.clock,
+                                          corner_delays(DelayPair{}, false));
             }
             // Combinational delays through cell
             for (auto &other_port : ci->ports) {
@@ -160,7 +281,8 @@ void TimingAnalyser::get_cell_delays()
                 DelayQuad delay;
                 bool is_path = ctx->getCellDelay(ci, other_port.first, name, delay);
                 if (is_path)
-                    pd.cell_arcs.emplace_back(CellArc::COMBINATIONAL, other_port.first, delay);
+                    pd.cell_arcs.emplace_back(CellArc::COMBINATIONAL, other_port.first,
+                                              corner_delays(delay.delayPair(), false));
             }
         }
     }
@@ -176,12 +298,28 @@ void TimingAnalyser::get_route_delays()
         for (auto &usr : ni->users) {
             if (usr.cell->bel == BelId())
                 continue;
-            ports.at(CellPortKey(usr)).route_delay = DelayPair(ctx->getNetinfoRouteDelay(ni, usr));
+            set_route_delay(CellPortKey(usr), DelayPair(ctx->getNetinfoRouteDelay(ni, usr)));
         }
     }
 }
 
-void TimingAnalyser::set_route_delay(CellPortKey port, DelayPair value) { ports.at(port).route_delay = value; }
+void TimingAnalyser::set_route_delay(CellPortKey port, DelayPair value)
+{
+    auto &pd = ports.at(port);
+    bool changed = false;
+    for (size_t c = 0; c < corners.size(); c++) {
+        DelayPair corner_value = derate(value, corners.at(c).route_derate);
+        if (pd.route_delay[c].min_delay == corner_value.min_delay &&
+            pd.route_delay[c].max_delay == corner_value.max_delay)
+            continue;
+        pd.route_delay[c] = corner_value;
+        changed = true;
+    }
+    if (changed && !pd.route_delay_changed) {
+        pd.route_delay_changed = true;
+        changed_ports.push_back(port);
+    }
+}
 
 void TimingAnalyser::topo_sort()
 {
@@ -227,6 +365,75 @@ void TimingAnalyser::topo_sort()
     }
     have_loops = !no_loops;
     std::swap(topological_order, topo.sorted);
+    for (int i = 0; i < int(topological_order.size()); i++)
+        ports.at(topological_order.at(i)).topo_index = i;
+}
+
+void TimingAnalyser::levelize()
+{
+    level_starts.clear();
+    if (have_loops)
+        return;
+    // The level of a port is the length of the longest path to it
+    std::vector<int> level(topological_order.size(), 0);
+    int max_level = 0;
+    for (int i = 0; i < int(topological_order.size()); i++) {
+        max_level = std::max(max_level, level.at(i));
+        for_each_fanout(topological_order.at(i), [&](const CellPortKey &next) {
+            int j = ports.at(next).topo_index;
+            level.at(j) = std::max(level.at(j), level.at(i) + 1);
+        });
+    }
+    // A counting sort keeps the existing order within each level
+    level_starts.resize(max_level + 2, 0);
+    for (int l : level)
+        level_starts.at(l + 1)++;
+    for (int l = 0; l <= max_level; l++)
+        level_starts.at(l + 1) += level_starts.at(l);
+    std::vector<int> next_pos(level_starts.begin(), level_starts.end() - 1);
+    std::vector<CellPortKey> sorted(topological_order.size());
+    for (int i = 0; i < int(topological_order.size()); i++)
+        sorted.at(next_pos.at(level.at(i))++) = topological_order.at(i);
+    std::swap(topological_order, sorted);
+    for (int i = 0; i < int(topological_order.size()); i++)
+        ports.at(topological_order.at(i)).topo_index = i;
+}
+
+void TimingAnalyser::setup_pull_lists()
+{
+    for (auto &port : ports) {
+        port.second.comb_arcs.clear();
+        port.second.sorted_users.clear();
+    }
+    for (auto &port : ports) {
+        auto &pd = port.second;
+        for (int i = 0; i < int(pd.cell_arcs.size()); i++)
+            if (pd.cell_arcs.at(i).type == CellArc::COMBINATIONAL)
+                ports.at(CellPortKey(port.first.cell, pd.cell_arcs.at(i).other_port))
+                        .comb_arcs.push_back(CombArcRef{port.first, i});
+        if (pd.type == PORT_OUT) {
+            const NetInfo *net = port_info(port.first).net;
+            if (net != nullptr && net->driver.cell != nullptr && CellPortKey(net->driver) == port.first)
+                for (auto &usr : net->users)
+                    pd.sorted_users.emplace_back(usr);
+        }
+    }
+    // propagate_arrival visits in topological order, propagate_required in reverse
+    auto topo_index = [&](const CellPortKey &key) { return ports.at(key).topo_index; };
+    for (auto &port : ports) {
+        auto &pd = port.second;
+        if (pd.type == PORT_OUT) {
+            std::sort(pd.comb_arcs.begin(), pd.comb_arcs.end(), [&](const CombArcRef &a, const CombArcRef &b) {
+                return topo_index(a.port) < topo_index(b.port);
+            });
+            std::sort(pd.sorted_users.begin(), pd.sorted_users.end(),
+                      [&](const CellPortKey &a, const CellPortKey &b) { return topo_index(a) > topo_index(b); });
+        } else {
+            std::sort(pd.comb_arcs.begin(), pd.comb_arcs.end(), [&](const CombArcRef &a, const CombArcRef &b) {
+                return topo_index(a.port) > topo_index(b.port);
+            });
+        }
+    }
 }
 
 void TimingAnalyser::setup_port_domains()
@@ -498,61 +705,87 @@ void TimingAnalyser::identify_related_domains()
             clock_delays[std::make_pair(c1.first, c2.first)] = delay;
         }
     }
+
+    for (auto &dp : domain_pairs) {
+        auto clocks = std::make_pair(domains.at(dp.key.launch).key.clock, domains.at(dp.key.capture).key.clock);
+        auto fnd = clock_delays.find(clocks);
+        dp.clock_to_clock = corner_delays(DelayPair((fnd != clock_delays.end()) ? fnd->second : 0), false);
+    }
 }
 
 void TimingAnalyser::reset_times()
+{
+    for (auto &port : ports)
+        reset_port_times(port.second, true, true);
+}
+
+void TimingAnalyser::reset_port_times(PerPort &pd, bool arrival, bool required)
 {
     static const auto init_delay =
             DelayPair(std::numeric_limits<delay_t>::max(), std::numeric_limits<delay_t>::lowest());
-    for (auto &port : ports) {
-        auto do_reset = [&](dict<domain_id_t, ArrivReqTime> &times) {
-            for (auto &t : times) {
-                t.second.value = init_delay;
-                t.second.path_length = 0;
-                t.second.bwd_min = CellPortKey();
-                t.second.bwd_max = CellPortKey();
+    auto do_reset = [&](dict<domain_id_t, ArrivReqTime> &times) {
+        for (auto &t : times) {
+            if (t.second.by_corner.size() != corners.size())
+                t.second.by_corner = SSOArray<CornerTime, 1>(corners.size());
+            for (auto &ct : t.second.by_corner) {
+                ct.value = init_delay;
+                ct.bwd_min = CellPortKey();
+                ct.bwd_max = CellPortKey();
             }
-        };
-        do_reset(port.second.arrival);
-        do_reset(port.second.required);
-        for (auto &dp : port.second.domain_pairs) {
-            dp.second.setup_slack = std::numeric_limits<delay_t>::max();
-            dp.second.hold_slack = std::numeric_limits<delay_t>::max();
-            dp.second.max_path_length = 0;
-            dp.second.criticality = 0;
+            t.second.path_length = 0;
         }
-        port.second.worst_crit = 0;
-        port.second.worst_setup_slack = std::numeric_limits<delay_t>::max();
-        port.second.worst_hold_slack = std::numeric_limits<delay_t>::max();
+    };
+    if (arrival)
+        do_reset(pd.arrival);
+    if (required)
+        do_reset(pd.required);
+    for (auto &dp : pd.domain_pairs) {
+        dp.second.setup_slack = std::numeric_limits<delay_t>::max();
+        dp.second.hold_slack = std::numeric_limits<delay_t>::max();
+        dp.second.max_path_length = 0;
+        dp.second.criticality = 0;
     }
+    pd.worst_crit = 0;
+    pd.worst_setup_slack = std::numeric_limits<delay_t>::max();
+    pd.worst_hold_slack = std::numeric_limits<delay_t>::max();
 }
 
-void TimingAnalyser::set_arrival_time(CellPortKey target, domain_id_t domain, DelayPair arrival, int path_length,
+template <typename Tf>
+void TimingAnalyser::set_arrival_time(CellPortKey target, domain_id_t domain, Tf arrival, int path_length,
                                       CellPortKey prev)
 {
     auto &arr = ports.at(target).arrival.at(domain);
-    if (arrival.max_delay > arr.value.max_delay) {
-        arr.value.max_delay = arrival.max_delay;
-        arr.bwd_max = prev;
-    }
-    if (!setup_only && (arrival.min_delay < arr.value.min_delay)) {
-        arr.value.min_delay = arrival.min_delay;
-        arr.bwd_min = prev;
+    for (int c = 0; c < int(corners.size()); c++) {
+        DelayPair value = arrival(c);
+        auto &ct = arr.by_corner[c];
+        if (value.max_delay > ct.value.max_delay) {
+            ct.value.max_delay = value.max_delay;
+            ct.bwd_max = prev;
+        }
+        if (!setup_only && (value.min_delay < ct.value.min_delay)) {
+            ct.value.min_delay = value.min_delay;
+            ct.bwd_min = prev;
+        }
     }
     arr.path_length = std::max(arr.path_length, path_length);
 }
 
-void TimingAnalyser::set_required_time(CellPortKey target, domain_id_t domain, DelayPair required, int path_length,
+template <typename Tf>
+void TimingAnalyser::set_required_time(CellPortKey target, domain_id_t domain, Tf required, int path_length,
                                        CellPortKey prev)
 {
     auto &req = ports.at(target).required.at(domain);
-    if (required.min_delay < req.value.min_delay) {
-        req.value.min_delay = required.min_delay;
-        req.bwd_min = prev;
-    }
-    if (!setup_only && (required.max_delay > req.value.max_delay)) {
-        req.value.max_delay = required.max_delay;
-        req.bwd_max = prev;
+    for (int c = 0; c < int(corners.size()); c++) {
+        DelayPair value = required(c);
+        auto &ct = req.by_corner[c];
+        if (value.min_delay < ct.value.min_delay) {
+            ct.value.min_delay = value.min_delay;
+            ct.bwd_min = prev;
+        }
+        if (!setup_only && (value.max_delay > ct.value.max_delay)) {
+            ct.value.max_delay = value.max_delay;
+            ct.bwd_max = prev;
+        }
     }
     req.path_length = std::max(req.path_length, path_length);
 }
@@ -562,112 +795,366 @@ void TimingAnalyser::walk_forward()
     // Assign initial arrival time to domain startpoints
     for (domain_id_t dom_id = 0; dom_id < domain_id_t(domains.size()); ++dom_id) {
         auto &dom = domains.at(dom_id);
-        for (auto &sp : dom.startpoints) {
-            auto &pd = ports.at(sp.first);
-            DelayPair init_arrival(0);
-            CellPortKey clock_key;
-            if (sp.second != IdString()) {
-                // clocked startpoints have a clock-to-out time
-                for (auto &fanin : pd.cell_arcs) {
-                    if (fanin.type == CellArc::CLK_TO_Q && fanin.other_port == sp.second) {
-                        init_arrival += fanin.value.delayPair();
-                        // Include the clock delay if clock_skew analysis is enabled
-                        if (with_clock_skew) {
-                            init_arrival += ports.at(CellPortKey(sp.first.cell, fanin.other_port)).route_delay;
-                        }
-                        break;
-                    }
-                }
-                clock_key = CellPortKey(sp.first.cell, sp.second);
+        for (auto &sp : dom.startpoints)
+            init_startpoint_arrival(dom_id, sp);
+    }
+    if (level_starts.empty()) {
+        // Walk forward in topological order
+        for (auto p : topological_order)
+            propagate_arrival(p, false);
+    } else {
+        // Every fanin of a level is in an earlier one, so the ports of a level can be updated in parallel
+        for (int l = 0; l < int(level_starts.size()) - 1; l++)
+            for_each_in_order(level_starts.at(l), level_starts.at(l + 1), [&](CellPortKey p) { pull_arrival(p); });
+    }
+}
+
+void TimingAnalyser::init_startpoint_arrival(domain_id_t domain, const std::pair<CellPortKey, IdString> &sp)
+{
+    auto &pd = ports.at(sp.first);
+    const CellArc *clk_to_q = nullptr;
+    const PerPort *clk_pd = nullptr;
+    CellPortKey clock_key;
+    if (sp.second != IdString()) {
+        // clocked startpoints have a clock-to-out time
+        for (auto &fanin : pd.cell_arcs) {
+            if (fanin.type == CellArc::CLK_TO_Q && fanin.other_port == sp.second) {
+                clk_to_q = &fanin;
+                // Include the clock delay if clock_skew analysis is enabled
+                if (with_clock_skew)
+                    clk_pd = &ports.at(CellPortKey(sp.first.cell, fanin.other_port));
+                break;
             }
-            set_arrival_time(sp.first, dom_id, init_arrival, 1, clock_key);
         }
+        clock_key = CellPortKey(sp.first.cell, sp.second);
     }
-    // Walk forward in topological order
-    for (auto p : topological_order) {
-        auto &pd = ports.at(p);
-        for (auto &arr : pd.arrival) {
-            if (pd.type == PORT_OUT) {
-                // Output port: propagate delay through net, adding route delay
-                NetInfo *net = port_info(p).net;
-                if (net != nullptr)
-                    for (auto &usr : net->users) {
-                        CellPortKey usr_key(usr);
-                        auto &usr_pd = ports.at(usr_key);
-                        auto next_arr = arr.second.value + usr_pd.route_delay;
-                        set_arrival_time(usr_key, arr.first, next_arr, arr.second.path_length, p);
-                    }
-            } else if (pd.type == PORT_IN) {
-                // Input port; propagate delay through cell, adding combinational delay
-                for (auto &fanout : pd.cell_arcs) {
-                    if (fanout.type != CellArc::COMBINATIONAL)
-                        continue;
+    set_arrival_time(
+            sp.first, domain,
+            [&](int c) {
+                DelayPair init_arrival(0);
+                if (clk_to_q)
+                    init_arrival += clk_to_q->value[c];
+                if (clk_pd)
+                    init_arrival += clk_pd->route_delay[c];
+                return init_arrival;
+            },
+            1, clock_key);
+}
 
-                    auto next_arr = arr.second.value + fanout.value.delayPair();
-                    set_arrival_time(CellPortKey(p.cell, fanout.other_port), arr.first, next_arr,
-                                     arr.second.path_length + 1, p);
+void TimingAnalyser::propagate_arrival(CellPortKey p, bool cone_only)
+{
+    auto &pd = ports.at(p);
+    for (auto &arr : pd.arrival) {
+        if (pd.type == PORT_OUT) {
+            // Output port: propagate delay through net, adding route delay
+            NetInfo *net = port_info(p).net;
+            if (net != nullptr)
+                for (auto &usr : net->users) {
+                    CellPortKey usr_key(usr);
+                    auto &usr_pd = ports.at(usr_key);
+                    if (cone_only && !usr_pd.in_fwd_cone)
+                        continue;
+                    set_arrival_time(
+                            usr_key, arr.first,
+                            [&](int c) { return arr.second.by_corner[c].value + usr_pd.route_delay[c]; },
+                            arr.second.path_length, p);
                 }
+        } else if (pd.type == PORT_IN) {
+            // Input port; propagate delay through cell, adding combinational delay
+            for (auto &fanout : pd.cell_arcs) {
+                if (fanout.type != CellArc::COMBINATIONAL)
+                    continue;
+                CellPortKey next_key(p.cell, fanout.other_port);
+                if (cone_only && !ports.at(next_key).in_fwd_cone)
+                    continue;
+                set_arrival_time(
+                        next_key, arr.first, [&](int c) { return arr.second.by_corner[c].value + fanout.value[c]; },
+                        arr.second.path_length + 1, p);
             }
         }
     }
 }
 
+void TimingAnalyser::pull_arrival(CellPortKey p)
+{
+    auto &pd = ports.at(p);
+    if (pd.type == PORT_IN) {
+        // Input port: from the net driver, adding route delay
+        const NetInfo *net = port_info(p).net;
+        if (net == nullptr || net->driver.cell == nullptr)
+            return;
+        CellPortKey drv_key(net->driver);
+        for (auto &arr : ports.at(drv_key).arrival)
+            set_arrival_time(
+                    p, arr.first, [&](int c) { return arr.second.by_corner[c].value + pd.route_delay[c]; },
+                    arr.second.path_length, drv_key);
+    } else if (pd.type == PORT_OUT) {
+        // Output port: from the cell inputs with a combinational arc to it, adding combinational delay
+        for (auto &ref : pd.comb_arcs) {
+            // Use the arcs as stored on the input, as propagate_arrival does
+            auto &prev_pd = ports.at(ref.port);
+            auto &arc = prev_pd.cell_arcs.at(ref.arc);
+            for (auto &arr : prev_pd.arrival)
+                set_arrival_time(
+                        p, arr.first, [&](int c) { return arr.second.by_corner[c].value + arc.value[c]; },
+                        arr.second.path_length + 1, ref.port);
+        }
+    }
+}
+
 void TimingAnalyser::walk_backward()
 {
     // Assign initial required time to domain endpoints
-    // Note that clock frequency will be considered later in the analysis for, for now all required times are normalised
-    // to 0ns
     for (domain_id_t dom_id = 0; dom_id < domain_id_t(domains.size()); ++dom_id) {
         auto &dom = domains.at(dom_id);
-        for (auto &ep : dom.endpoints) {
-            auto &pd = ports.at(ep.first);
-            DelayPair init_required(0);
-            CellPortKey clock_key;
-            // TODO: clock routing delay, if analysis of that is enabled
-            if (ep.second != IdString()) {
-                // Add setup/hold time, if this endpoint is clocked
-                for (auto &fanin : pd.cell_arcs) {
+        for (auto &ep : dom.endpoints)
+            init_endpoint_required(dom_id, ep);
+    }
+    if (level_starts.empty()) {
+        // Walk backwards in topological order
+        for (auto p : reversed_range(topological_order))
+            propagate_required(p, false);
+    } else {
+        for (int l = int(level_starts.size()) - 2; l >= 0; l--)
+            for_each_in_order(level_starts.at(l), level_starts.at(l + 1), [&](CellPortKey p) { pull_required(p); });
+    }
+}
 
-                    if (fanin.type == CellArc::SETUP && fanin.other_port == ep.second) {
-                        if (with_clock_skew) {
-                            init_required += ports.at(CellPortKey(ep.first.cell, fanin.other_port)).route_delay;
-                        }
-                        init_required.min_delay -= fanin.value.maxDelay();
-                    }
-                    if (fanin.type == CellArc::HOLD && fanin.other_port == ep.second)
-                        init_required.max_delay += fanin.value.maxDelay();
+void TimingAnalyser::init_endpoint_required(domain_id_t domain, const std::pair<CellPortKey, IdString> &ep)
+{
+    // Note that clock frequency will be considered later in the analysis for, for now all required times are normalised
+    // to 0ns
+    auto &pd = ports.at(ep.first);
+    CellPortKey clock_key;
+    if (ep.second != IdString())
+        clock_key = CellPortKey(ep.first.cell, ep.second);
+    // TODO: clock routing delay, if analysis of that is enabled
+    auto init_required = [&](int c) {
+        DelayPair required(0);
+        if (ep.second == IdString())
+            return required;
+        // Add setup/hold time, if this endpoint is clocked
+        for (auto &fanin : pd.cell_arcs) {
+
+            if (fanin.type == CellArc::SETUP && fanin.other_port == ep.second) {
+                if (with_clock_skew) {
+                    required += ports.at(CellPortKey(ep.first.cell, fanin.other_port)).route_delay[c];
                 }
-                clock_key = CellPortKey(ep.first.cell, ep.second);
+                required.min_delay -= fanin.value[c].maxDelay();
+            }
+            if (fanin.type == CellArc::HOLD && fanin.other_port == ep.second)
+                required.max_delay += fanin.value[c].maxDelay();
+        }
+        return required;
+    };
+    set_required_time(ep.first, domain, init_required, 1, clock_key);
+}
+
+void TimingAnalyser::propagate_required(CellPortKey p, bool cone_only)
+{
+    auto &pd = ports.at(p);
+    for (auto &req : pd.required) {
+        if (pd.type == PORT_IN) {
+            // Input port: propagate delay back through net, subtracting route delay
+            NetInfo *net = port_info(p).net;
+            if (net != nullptr && net->driver.cell != nullptr) {
+                CellPortKey drv_key(net->driver);
+                if (cone_only && !ports.at(drv_key).in_bwd_cone)
+                    continue;
+                set_required_time(
+                        drv_key, req.first,
+                        [&](int c) {
+                            return req.second.by_corner[c].value - DelayPair(pd.route_delay[c].maxDelay());
+                        },
+                        req.second.path_length, p);
+            }
+        } else if (pd.type == PORT_OUT) {
+            // Output port : propagate delay back through cell, subtracting combinational delay
+            for (auto &fanin : pd.cell_arcs) {
+                if (fanin.type != CellArc::COMBINATIONAL)
+                    continue;
+                CellPortKey prev_key(p.cell, fanin.other_port);
+                if (cone_only && !ports.at(prev_key).in_bwd_cone)
+                    continue;
+                set_required_time(
+                        prev_key, req.first,
+                        [&](int c) { return req.second.by_corner[c].value - DelayPair(fanin.value[c].maxDelay()); },
+                        req.second.path_length + 1, p);
             }
-            set_required_time(ep.first, dom_id, init_required, 1, clock_key);
         }
     }
-    // Walk backwards in topological order
-    for (auto p : reversed_range(topological_order)) {
-        auto &pd = ports.at(p);
-        for (auto &req : pd.required) {
-            if (pd.type == PORT_IN) {
-                // Input port: propagate delay back through net, subtracting route delay
-                NetInfo *net = port_info(p).net;
-                if (net != nullptr && net->driver.cell != nullptr)
-                    set_required_time(CellPortKey(net->driver), req.first,
-                                      req.second.value - DelayPair(pd.route_delay.maxDelay()), req.second.path_length,
-                                      p);
-            } else if (pd.type == PORT_OUT) {
-                // Output port : propagate delay back through cell, subtracting combinational delay
-                for (auto &fanin : pd.cell_arcs) {
-                    if (fanin.type != CellArc::COMBINATIONAL)
+}
+
+void TimingAnalyser::pull_required(CellPortKey p)
+{
+    auto &pd = ports.at(p);
+    if (pd.type == PORT_OUT) {
+        // Output port: from the net users, subtracting route delay
+        for (auto &usr_key : pd.sorted_users) {
+            auto &next_pd = ports.at(usr_key);
+            for (auto &req : next_pd.required)
+                set_required_time(
+                        p, req.first,
+                        [&](int c) {
+                            return req.second.by_corner[c].value - DelayPair(next_pd.route_delay[c].maxDelay());
+                        },
+                        req.second.path_length, usr_key);
+        }
+    } else if (pd.type == PORT_IN) {
+        // Input port: from the cell outputs it has a combinational arc to, subtracting combinational delay
+        for (auto &ref : pd.comb_arcs) {
+            // Use the arcs as stored on the output, as propagate_required does
+            auto &next_pd = ports.at(ref.port);
+            auto &arc = next_pd.cell_arcs.at(ref.arc);
+            for (auto &req : next_pd.required)
+                set_required_time(
+                        p, req.first,
+                        [&](int c) { return req.second.by_corner[c].value - DelayPair(arc.value[c].maxDelay()); },
+                        req.second.path_length + 1, ref.port);
+        }
+    }
+}
+
+bool TimingAnalyser::run_incremental()
+{
+    if (!times_valid || have_loops)
+        return false;
+    if (changed_ports.empty())
+        return true;
+
+    std::vector<CellPortKey> fwd_cone, bwd_cone;
+    auto add_fwd = [&](const CellPortKey &key) {
+        auto &pd = ports.at(key);
+        if (!pd.in_fwd_cone) {
+            pd.in_fwd_cone = true;
+            fwd_cone.push_back(key);
+        }
+    };
+    auto add_bwd = [&](const CellPortKey &key) {
+        auto &pd = ports.at(key);
+        if (!pd.in_bwd_cone) {
+            pd.in_bwd_cone = true;
+            bwd_cone.push_back(key);
+        }
+    };
+    auto clear_cones = [&]() {
+        for (auto &key : fwd_cone)
+            ports.at(key).in_fwd_cone = false;
+        for (auto &key : bwd_cone)
+            ports.at(key).in_bwd_cone = false;
+    };
+
+    for (auto &p : changed_ports) {
+        // The route delay into an input port affects its own arrival time and the required time of its driver
+        add_fwd(p);
+        for_each_fanin(p, add_bwd);
+        if (with_clock_skew) {
+            // Clock routing delays shift the launch and capture times of the cell's registers
+            for (auto &cell_port : cell_info(p)->ports) {
+                CellPortKey key(p.cell, cell_port.first);
+                for (auto &arc : ports.at(key).cell_arcs) {
+                    if (arc.other_port != p.port)
                         continue;
-                    set_required_time(CellPortKey(p.cell, fanin.other_port), req.first,
-                                      req.second.value - DelayPair(fanin.value.maxDelay()), req.second.path_length + 1,
-                                      p);
+                    if (arc.type == CellArc::CLK_TO_Q)
+                        add_fwd(key);
+                    else if (arc.type == CellArc::SETUP || arc.type == CellArc::HOLD)
+                        add_bwd(key);
                 }
             }
         }
     }
+
+    // Grow the cones, giving up once they are large enough that a full run would be faster
+    size_t max_cone_size = ports.size() / 4;
+    for (size_t i = 0; i < fwd_cone.size(); i++) {
+        CellPortKey p = fwd_cone.at(i);
+        for_each_fanout(p, add_fwd);
+        if (fwd_cone.size() > max_cone_size) {
+            clear_cones();
+            return false;
+        }
+    }
+    for (size_t i = 0; i < bwd_cone.size(); i++) {
+        CellPortKey p = bwd_cone.at(i);
+        for_each_fanin(p, add_bwd);
+        if (fwd_cone.size() + bwd_cone.size() > max_cone_size) {
+            clear_cones();
+            return false;
+        }
+    }
+
+    // Visit the cone, and the ports just outside it that push times into it, in the same relative order as a full
+    // walk; so that the result is identical
+    auto visit_order = [&](const std::vector<CellPortKey> &cone, bool forward) {
+        std::vector<std::pair<int, CellPortKey>> order;
+        auto add_port = [&](const CellPortKey &key) { order.emplace_back(ports.at(key).topo_index, key); };
+        for (auto &p : cone) {
+            add_port(p);
+            if (forward)
+                for_each_fanin(p, add_port);
+            else
+                for_each_fanout(p, add_port);
+        }
+        std::sort(order.begin(), order.end());
+        order.erase(std::unique(order.begin(), order.end()), order.end());
+        return order;
+    };
+
+    for (auto &p : fwd_cone)
+        reset_port_times(ports.at(p), true, false);
+    for (auto &p : bwd_cone)
+        reset_port_times(ports.at(p), false, true);
+
+    for (domain_id_t dom_id = 0; dom_id < domain_id_t(domains.size()); ++dom_id) {
+        auto &dom = domains.at(dom_id);
+        for (auto &sp : dom.startpoints)
+            if (ports.at(sp.first).in_fwd_cone)
+                init_startpoint_arrival(dom_id, sp);
+        for (auto &ep : dom.endpoints)
+            if (ports.at(ep.first).in_bwd_cone)
+                init_endpoint_required(dom_id, ep);
+    }
+    for (auto &entry : visit_order(fwd_cone, true))
+        propagate_arrival(entry.second, true);
+    auto bwd_order = visit_order(bwd_cone, false);
+    for (auto &entry : reversed_range(bwd_order))
+        propagate_required(entry.second, true);
+
+    // Slack only changes inside the cones, but the worst slack per domain pair (and so all criticalities) might move
+    std::vector<delay_t> old_worst_slack;
+    for (auto &dp : domain_pairs)
+        old_worst_slack.push_back(dp.worst_setup_slack);
+    for (auto &p : fwd_cone)
+        compute_port_slack(ports.at(p));
+    for (auto &p : bwd_cone)
+        if (!ports.at(p).in_fwd_cone)
+            compute_port_slack(ports.at(p));
+    compute_worst_slack();
+
+    bool worst_changed = false;
+    for (size_t i = 0; i < domain_pairs.size(); i++)
+        if (domain_pairs.at(i).worst_setup_slack != old_worst_slack.at(i))
+            worst_changed = true;
+    if (worst_changed) {
+        for (auto &port : ports) {
+            port.second.worst_crit = 0;
+            for (auto &pdp : port.second.domain_pairs)
+                pdp.second.criticality = 0;
+        }
+        compute_criticality();
+    } else {
+        for (auto &p : fwd_cone)
+            compute_port_criticality(ports.at(p));
+        for (auto &p : bwd_cone)
+            if (!ports.at(p).in_fwd_cone)
+                compute_port_criticality(ports.at(p));
+    }
+
+    clear_cones();
+    return true;
 }
 
-dict<domain_id_t, delay_t> TimingAnalyser::max_delay_by_domain_pairs()
+dict<domain_id_t, delay_t> TimingAnalyser::max_delay_by_domain_pairs(int corner)
 {
     dict<domain_id_t, delay_t> domain_delay;
 
@@ -687,12 +1174,10 @@ dict<domain_id_t, delay_t> TimingAnalyser::max_delay_by_domain_pairs()
                 auto clocks = std::make_pair(launch.key.clock, capture.key.clock);
                 auto same_clock = capture_id == launch_id;
                 auto related_clocks = clock_delays.count(clocks) > 0;
-                delay_t clock_to_clock = 0;
-                if (related_clocks) {
-                    clock_to_clock = clock_delays.at(clocks);
-                }
+                delay_t clock_to_clock = clock_to_clock_delay(clocks.first, clocks.second, corner);
 
-                auto delay = arr.value.maxDelay() - req.value.minDelay() + clock_to_clock;
+                auto delay = arr.by_corner[corner].value.maxDelay() - req.by_corner[corner].value.minDelay() +
+                             clock_to_clock;
 
                 // If domains are unrelated or not the same clock we need to make sure
                 // to remove the clock delays from the arrival and required times
@@ -700,20 +1185,22 @@ dict<domain_id_t, delay_t> TimingAnalyser::max_delay_by_domain_pairs()
                 if (with_clock_skew && !same_clock && !related_clocks) {
                     for (auto &fanin : ep_port.cell_arcs) {
                         if (fanin.type == CellArc::SETUP) {
-                            auto clock_delay = ports.at(CellPortKey(ep.first.cell, fanin.other_port)).route_delay;
+                            auto clock_delay =
+                                    ports.at(CellPortKey(ep.first.cell, fanin.other_port)).route_delay[corner];
                             delay += clock_delay.minDelay();
                         }
                     }
 
                     // walk back to startpoint
-                    auto crit_path = walk_crit_path(domain_pair_id(launch_id, capture_id), ep.first, true);
+                    auto crit_path = walk_crit_path(domain_pair_id(launch_id, capture_id), ep.first, true, corner);
                     auto first_inp = crit_path.back();
                     const auto &sp = first_inp.cell->ports.at(first_inp.port).net->driver;
                     auto &sp_port = ports.at(CellPortKey{sp.cell->name, sp.port});
 
                     for (auto &fanin : sp_port.cell_arcs) {
                         if (fanin.type == CellArc::CLK_TO_Q) {
-                            auto clock_delay = ports.at(CellPortKey(sp.cell->name, fanin.other_port)).route_delay;
+                            auto clock_delay =
+                                    ports.at(CellPortKey(sp.cell->name, fanin.other_port)).route_delay[corner];
                             delay -= clock_delay.maxDelay();
                         }
                     }
@@ -730,61 +1217,93 @@ dict<domain_id_t, delay_t> TimingAnalyser::max_delay_by_domain_pairs()
 }
 
 void TimingAnalyser::compute_slack()
+{
+    for_each_in_order(0, int(topological_order.size()), [&](CellPortKey p) { compute_port_slack(ports.at(p)); });
+    compute_worst_slack();
+}
+
+delay_t TimingAnalyser::port_setup_slack(const PerPort &pd, const PerDomainPair &dp, int corner) const
+{
+    auto &arr = pd.arrival.at(dp.key.launch).by_corner[corner];
+    auto &req = pd.required.at(dp.key.capture).by_corner[corner];
+    return 0 - (arr.value.maxDelay() - req.value.minDelay() + dp.clock_to_clock[corner].maxDelay());
+}
+
+delay_t TimingAnalyser::port_hold_slack(const PerPort &pd, const PerDomainPair &dp, int corner) const
+{
+    auto &arr = pd.arrival.at(dp.key.launch).by_corner[corner];
+    auto &req = pd.required.at(dp.key.capture).by_corner[corner];
+    return arr.value.minDelay() - req.value.maxDelay() + dp.clock_to_clock[corner].maxDelay();
+}
+
+void TimingAnalyser::compute_port_slack(PerPort &pd)
+{
+    for (auto &pdp : pd.domain_pairs) {
+        auto &dp = domain_pairs.at(pdp.first);
+        auto &arr = pd.arrival.at(dp.key.launch);
+        auto &req = pd.required.at(dp.key.capture);
+        // Keep the worst corner, so that optimisation is against that
+        pdp.second.setup_slack = std::numeric_limits<delay_t>::max();
+        pdp.second.hold_slack = std::numeric_limits<delay_t>::max();
+        for (int c = 0; c < int(corners.size()); c++) {
+            delay_t setup_slack = port_setup_slack(pd, dp, c);
+            if (setup_slack < pdp.second.setup_slack) {
+                pdp.second.setup_slack = setup_slack;
+                pdp.second.setup_corner = c;
+            }
+            if (setup_only)
+                continue;
+            delay_t hold_slack = port_hold_slack(pd, dp, c);
+            if (hold_slack < pdp.second.hold_slack) {
+                pdp.second.hold_slack = hold_slack;
+                pdp.second.hold_corner = c;
+            }
+        }
+        pdp.second.max_path_length = arr.path_length + req.path_length;
+        if (dp.key.launch == dp.key.capture)
+            pd.worst_setup_slack = std::min(pd.worst_setup_slack, dp.period.minDelay() + pdp.second.setup_slack);
+        if (!setup_only)
+            pd.worst_hold_slack = std::min(pd.worst_hold_slack, pdp.second.hold_slack);
+    }
+}
+
+void TimingAnalyser::compute_worst_slack()
 {
     for (auto &dp : domain_pairs) {
         dp.worst_setup_slack = std::numeric_limits<delay_t>::max();
         dp.worst_hold_slack = std::numeric_limits<delay_t>::max();
     }
-    for (auto p : topological_order) {
-        auto &pd = ports.at(p);
-        for (auto &pdp : pd.domain_pairs) {
+    // Ports that weren't visited still have their slack reset to the maximum, so the order doesn't matter here
+    for (auto &port : ports) {
+        for (auto &pdp : port.second.domain_pairs) {
             auto &dp = domain_pairs.at(pdp.first);
-
-            // Get clock names
-            const auto &launch_clock = domains.at(dp.key.launch).key.clock;
-            const auto &capture_clock = domains.at(dp.key.capture).key.clock;
-
-            // Get clock-to-clock delay if any
-            delay_t clock_to_clock = 0;
-            auto clocks = std::make_pair(launch_clock, capture_clock);
-            if (clock_delays.count(clocks)) {
-                clock_to_clock = clock_delays.at(clocks);
-            }
-
-            auto &arr = pd.arrival.at(dp.key.launch);
-            auto &req = pd.required.at(dp.key.capture);
-            pdp.second.setup_slack = 0 - (arr.value.maxDelay() - req.value.minDelay() + clock_to_clock);
-            if (!setup_only)
-                pdp.second.hold_slack = arr.value.minDelay() - req.value.maxDelay() + clock_to_clock;
-            pdp.second.max_path_length = arr.path_length + req.path_length;
-            if (dp.key.launch == dp.key.capture)
-                pd.worst_setup_slack = std::min(pd.worst_setup_slack, dp.period.minDelay() + pdp.second.setup_slack);
             dp.worst_setup_slack = std::min(dp.worst_setup_slack, pdp.second.setup_slack);
-            if (!setup_only) {
-                pd.worst_hold_slack = std::min(pd.worst_hold_slack, pdp.second.hold_slack);
+            if (!setup_only)
                 dp.worst_hold_slack = std::min(dp.worst_hold_slack, pdp.second.hold_slack);
-            }
         }
     }
 }
 
 void TimingAnalyser::compute_criticality()
 {
-    for (auto p : topological_order) {
-        auto &pd = ports.at(p);
-        for (auto &pdp : pd.domain_pairs) {
-            auto &dp = domain_pairs.at(pdp.first);
-            // Do not set criticality for asynchronous paths
-            if (domains.at(dp.key.launch).key.is_async() || domains.at(dp.key.capture).key.is_async())
-                continue;
+    for_each_in_order(0, int(topological_order.size()),
+                      [&](CellPortKey p) { compute_port_criticality(ports.at(p)); });
+}
 
-            float crit =
-                    1.0f - (float(pdp.second.setup_slack) - float(dp.worst_setup_slack)) / float(-dp.worst_setup_slack);
-            crit = std::min(crit, 1.0f);
-            crit = std::max(crit, 0.0f);
-            pdp.second.criticality = crit;
-            pd.worst_crit = std::max(pd.worst_crit, crit);
-        }
+void TimingAnalyser::compute_port_criticality(PerPort &pd)
+{
+    for (auto &pdp : pd.domain_pairs) {
+        auto &dp = domain_pairs.at(pdp.first);
+        // Do not set criticality for asynchronous paths
+        if (domains.at(dp.key.launch).key.is_async() || domains.at(dp.key.capture).key.is_async())
+            continue;
+
+        float crit =
+                1.0f - (float(pdp.second.setup_slack) - float(dp.worst_setup_slack)) / float(-dp.worst_setup_slack);
+        crit = std::min(crit, 1.0f);
+        crit = std::max(crit, 0.0f);
+        pdp.second.criticality = crit;
+        pd.worst_crit = std::max(pd.worst_crit, crit);
     }
 }
 
@@ -799,6 +1318,12 @@ void TimingAnalyser::build_detailed_net_timing_report()
             const NetInfo *net = port_info(ep.first).net;
 
             for (auto &arr : pd.arrival) {
+                // The range of delays over all corners
+                DelayPair delay = arr.second.by_corner[0].value;
+                for (auto &ct : arr.second.by_corner) {
+                    delay.min_delay = std::min(delay.min_delay, ct.value.min_delay);
+                    delay.max_delay = std::max(delay.max_delay, ct.value.max_delay);
+                }
                 auto &launch = domains.at(arr.first).key;
                 for (auto &req : pd.required) {
                     auto &capture = domains.at(req.first).key;
@@ -809,7 +1334,7 @@ void TimingAnalyser::build_detailed_net_timing_report()
                     sink_timing.clock_pair.end.clock = capture.clock;
                     sink_timing.clock_pair.end.edge = capture.edge;
                     sink_timing.cell_port = std::make_pair(pd.cell_port.cell, pd.cell_port.port);
-                    sink_timing.delay = arr.second.value;
+                    sink_timing.delay = delay;
 
                     net_timings[net->name].push_back(sink_timing);
                 }
@@ -818,7 +1343,7 @@ void TimingAnalyser::build_detailed_net_timing_report()
     }
 }
 
-std::vector<CellPortKey> TimingAnalyser::get_worst_eps(domain_id_t domain_pair, int count)
+std::vector<CellPortKey> TimingAnalyser::get_worst_eps(domain_id_t domain_pair, int count, int corner)
 {
     std::vector<CellPortKey> worst_eps;
     delay_t last_slack = std::numeric_limits<delay_t>::lowest();
@@ -831,7 +1356,7 @@ std::vector<CellPortKey> TimingAnalyser::get_worst_eps(domain_id_t domain_pair,
             auto &pd = ports.at(ep.first);
             if (!pd.domain_pairs.count(domain_pair))
                 continue;
-            delay_t ep_slack = pd.domain_pairs.at(domain_pair).setup_slack;
+            delay_t ep_slack = port_setup_slack(pd, dp, corner);
             if (ep_slack < next_slack && ep_slack > last_slack) {
                 next = ep.first;
                 next_slack = ep_slack;
@@ -845,7 +1370,8 @@ std::vector<CellPortKey> TimingAnalyser::get_worst_eps(domain_id_t domain_pair,
     return worst_eps;
 }
 
-std::vector<PortRef> TimingAnalyser::walk_crit_path(domain_id_t domain_pair, CellPortKey endpoint, bool longest_path)
+std::vector<PortRef> TimingAnalyser::walk_crit_path(domain_id_t domain_pair, CellPortKey endpoint, bool longest_path,
+                                                    int corner)
 {
     const auto &dp = domain_pairs.at(domain_pair);
 
@@ -875,10 +1401,11 @@ std::vector<PortRef> TimingAnalyser::walk_crit_path(domain_id_t domain_pair, Cel
         if (!ports.at(cursor).arrival.count(dp.key.launch))
             break;
 
+        auto &arr = ports.at(cursor).arrival.at(dp.key.launch).by_corner[corner];
         if (longest_path) {
-            cursor = ports.at(cursor).arrival.at(dp.key.launch).bwd_max;
+            cursor = arr.bwd_max;
         } else {
-            cursor = ports.at(cursor).arrival.at(dp.key.launch).bwd_min;
+            cursor = arr.bwd_min;
         }
         is_startpoint = portClass == TMG_REGISTER_OUTPUT || portClass == TMG_STARTPOINT;
     } while (!is_startpoint);
@@ -887,9 +1414,12 @@ std::vector<PortRef> TimingAnalyser::walk_crit_path(domain_id_t domain_pair, Cel
 }
 
 CriticalPath TimingAnalyser::build_critical_path_report(domain_id_t domain_pair, CellPortKey endpoint,
-                                                        bool longest_path)
+                                                        bool longest_path, int corner)
 {
     CriticalPath report;
+    const auto &tc = corners.at(corner);
+    if (corners.size() > 1)
+        report.corner = tc.name;
 
     const auto &dp = domain_pairs.at(domain_pair);
     const auto &launch = domains.at(dp.key.launch).key;
@@ -915,7 +1445,7 @@ CriticalPath TimingAnalyser::build_critical_path_report(domain_id_t domain_pair,
         }
     }
 
-    auto crit_path_rev = walk_crit_path(domain_pair, endpoint, longest_path);
+    auto crit_path_rev = walk_crit_path(domain_pair, endpoint, longest_path, corner);
     auto crit_path = boost::adaptors::reverse(crit_path_rev);
 
     // Get timing and clocking info on the startpoint
@@ -974,7 +1504,7 @@ CriticalPath TimingAnalyser::build_critical_path_report(domain_id_t domain_pair,
     auto same_clock = launch.clock == capture.clock;
 
     if (related_clock) {
-        delay_t clock_delay = clock_delays.at(clock_pair);
+        delay_t clock_delay = clock_to_clock_delay(launch.clock, capture.clock, corner);
         if (!is_zero_delay(clock_delay)) {
             CriticalPath::Segment seg_c2c;
             seg_c2c.type = CriticalPath::Segment::Type::CLK_TO_CLK;
@@ -991,7 +1521,7 @@ CriticalPath TimingAnalyser::build_critical_path_report(domain_id_t domain_pair,
         auto clock_delay_launch = ctx->getNetinfoRouteDelay(sp_clk_net, PortRef{sp_cell, sp_clk_info.clock_port});
         auto clock_delay_capture = ctx->getNetinfoRouteDelay(ep_clk_net, PortRef{ep_cell, ep_clk_info.clock_port});
 
-        delay_t clock_skew = clock_delay_launch - clock_delay_capture;
+        delay_t clock_skew = derate(DelayPair(clock_delay_launch - clock_delay_capture), tc.route_derate).maxDelay();
 
         if (!is_zero_delay(clock_skew)) {
             CriticalPath::Segment seg_skew;
@@ -1033,13 +1563,14 @@ CriticalPath TimingAnalyser::build_critical_path_report(domain_id_t domain_pair,
             seg_logic.type = CriticalPath::Segment::Type::LOGIC;
         }
 
-        seg_logic.delay = longest_path ? comb_delay.maxDelay() : comb_delay.minDelay();
+        DelayPair comb_corner = derate(comb_delay.delayPair(), tc.cell_derate);
+        seg_logic.delay = longest_path ? comb_corner.maxDelay() : comb_corner.minDelay();
         seg_logic.from = std::make_pair(prev_cell->name, prev_port);
         seg_logic.to = std::make_pair(driver_cell->name, driver.port);
         seg_logic.net = IdString();
         report.segments.push_back(seg_logic);
 
-        auto net_delay = DelayPair(ctx->getNetinfoRouteDelay(net, sink));
+        auto net_delay = derate(DelayPair(ctx->getNetinfoRouteDelay(net, sink)), tc.route_derate);
 
         CriticalPath::Segment seg_route;
         seg_route.type = CriticalPath::Segment::Type::ROUTING;
@@ -1059,10 +1590,10 @@ CriticalPath TimingAnalyser::build_critical_path_report(domain_id_t domain_pair,
         seg_logic.delay = 0;
         if (longest_path) {
             seg_logic.type = CriticalPath::Segment::Type::SETUP;
-            seg_logic.delay += ep_clk_info.setup.maxDelay();
+            seg_logic.delay += derate(ep_clk_info.setup, tc.cell_derate).maxDelay();
         } else {
             seg_logic.type = CriticalPath::Segment::Type::HOLD;
-            seg_logic.delay -= ep_clk_info.hold.maxDelay();
+            seg_logic.delay -= derate(ep_clk_info.hold, tc.cell_derate).maxDelay();
         }
         seg_logic.from = std::make_pair(prev_cell->name, prev_port);
         seg_logic.to = seg_logic.from;
@@ -1084,44 +1615,67 @@ void TimingAnalyser::build_crit_path_reports()
         result.min_delay_violations = get_min_delay_violations();
     }
 
-    auto delay_by_domain = max_delay_by_domain_pairs();
-
     for (int i = 0; i < int(domains.size()); i++) {
         empty_clocks.insert(domains.at(i).key.clock);
     }
 
-    for (int i = 0; i < int(domain_pairs.size()); i++) {
-        auto &dp = domain_pairs.at(i);
-        auto &launch = domains.at(dp.key.launch).key;
-        auto &capture = domains.at(dp.key.capture).key;
+    // With more than one corner, the overall results are for the worst corner of each clock, and the results for each
+    // corner are reported too
+    bool multi_corner = corners.size() > 1;
+    if (multi_corner) {
+        result.corners.resize(corners.size());
+        for (int c = 0; c < int(corners.size()); c++)
+            result.corners.at(c).name = corners.at(c).name;
+    }
 
-        if (launch.clock != capture.clock || launch.is_async())
-            continue;
+    for (int c = 0; c < int(corners.size()); c++) {
+        auto delay_by_domain = max_delay_by_domain_pairs(c);
 
-        auto path_delay = delay_by_domain.at(i);
+        for (int i = 0; i < int(domain_pairs.size()); i++) {
+            auto &dp = domain_pairs.at(i);
+            auto &launch = domains.at(dp.key.launch).key;
+            auto &capture = domains.at(dp.key.capture).key;
 
-        double Fmax;
+            if (launch.clock != capture.clock || launch.is_async())
+                continue;
 
-        if (launch.edge == capture.edge)
-            Fmax = 1000 / ctx->getDelayNS(path_delay);
-        else
-            Fmax = 500 / ctx->getDelayNS(path_delay);
+            auto path_delay = delay_by_domain.at(i);
+
+            double Fmax;
+
+            if (launch.edge == capture.edge)
+                Fmax = 1000 / ctx->getDelayNS(path_delay);
+            else
+                Fmax = 500 / ctx->getDelayNS(path_delay);
+
+            bool worst_overall = !clock_fmax.count(launch.clock) || Fmax < clock_fmax.at(launch.clock).achieved;
+            bool worst_in_corner = multi_corner && (!result.corners.at(c).clock_fmax.count(launch.clock) ||
+                                                    Fmax < result.corners.at(c).clock_fmax.at(launch.clock).achieved);
+            if (!worst_overall && !worst_in_corner)
+                continue;
 
-        if (!clock_fmax.count(launch.clock) || Fmax < clock_fmax.at(launch.clock).achieved) {
             float target = ctx->setting<float>("target_freq") / 1e6;
             if (ctx->nets.at(launch.clock)->clkconstr)
                 target = 1000 / ctx->getDelayNS(ctx->nets.at(launch.clock)->clkconstr->period.minDelay());
 
-            auto worst_endpoint = get_worst_eps(i, 1);
+            auto worst_endpoint = get_worst_eps(i, 1, c);
             if (worst_endpoint.empty())
                 continue;
 
-            clock_fmax[launch.clock].achieved = Fmax;
-            clock_fmax[launch.clock].constraint = target;
-
-            clock_reports[launch.clock] = build_critical_path_report(i, worst_endpoint.at(0), true);
+            auto report = build_critical_path_report(i, worst_endpoint.at(0), true, c);
 
-            empty_clocks.erase(launch.clock);
+            if (worst_overall) {
+                clock_fmax[launch.clock].achieved = Fmax;
+                clock_fmax[launch.clock].constraint = target;
+                clock_reports[launch.clock] = report;
+                empty_clocks.erase(launch.clock);
+            }
+            if (worst_in_corner) {
+                auto &corner_result = result.corners.at(c);
+                corner_result.clock_fmax[launch.clock].achieved = Fmax;
+                corner_result.clock_fmax[launch.clock].constraint = target;
+                corner_result.clock_paths[launch.clock] = report;
+            }
         }
     }
 
@@ -1133,11 +1687,25 @@ void TimingAnalyser::build_crit_path_reports()
         if (launch.clock == capture.clock && !launch.is_async())
             continue;
 
-        auto worst_endpoint = get_worst_eps(i, 1);
-        if (worst_endpoint.empty())
+        // Report the corner with the worst slack
+        CellPortKey worst_endpoint;
+        int worst_corner = 0;
+        delay_t worst_slack = std::numeric_limits<delay_t>::max();
+        for (int c = 0; c < int(corners.size()); c++) {
+            auto eps = get_worst_eps(i, 1, c);
+            if (eps.empty())
+                continue;
+            delay_t slack = port_setup_slack(ports.at(eps.at(0)), dp, c);
+            if (worst_endpoint == CellPortKey() || slack < worst_slack) {
+                worst_endpoint = eps.at(0);
+                worst_corner = c;
+                worst_slack = slack;
+            }
+        }
+        if (worst_endpoint == CellPortKey())
             continue;
 
-        xclock_reports.emplace_back(build_critical_path_report(i, worst_endpoint.at(0), true));
+        xclock_reports.emplace_back(build_critical_path_report(i, worst_endpoint, true, worst_corner));
     }
 
     auto cmp_crit_path = [&](const CriticalPath &ra, const CriticalPath &rb) {
@@ -1187,7 +1755,11 @@ void TimingAnalyser::build_slack_histogram_report()
                     if (launch.edge != capture.edge)
                         clk_period = clk_period / 2;
 
-                    delay_t delay = arr.second.value.maxDelay() - req.second.value.minDelay();
+                    // Worst corner
+                    delay_t delay = std::numeric_limits<delay_t>::lowest();
+                    for (int c = 0; c < int(corners.size()); c++)
+                        delay = std::max(delay, arr.second.by_corner[c].value.maxDelay() -
+                                                        req.second.by_corner[c].value.minDelay());
                     delay_t slack = clk_period - delay;
 
                     int slack_ps = ctx->getDelayNS(slack) * 1000;
@@ -1229,15 +1801,20 @@ std::vector<CriticalPath> TimingAnalyser::get_min_delay_violations()
                     continue;
                 }
 
-                delay_t clock_to_clock = 0;
-                if (related_clocks) {
-                    clock_to_clock = clock_delays.at(clocks);
+                // Worst corner
+                int hold_corner = 0;
+                delay_t hold_slack = std::numeric_limits<delay_t>::max();
+                for (int c = 0; c < int(corners.size()); c++) {
+                    delay_t slack = arr.by_corner[c].value.minDelay() - req.by_corner[c].value.maxDelay() +
+                                    clock_to_clock_delay(launch_clock, capture_clock, c);
+                    if (slack < hold_slack) {
+                        hold_slack = slack;
+                        hold_corner = c;
+                    }
                 }
 
-                auto hold_slack = arr.value.minDelay() - req.value.maxDelay() + clock_to_clock;
-
                 if (hold_slack <= 0) {
-                    auto report = build_critical_path_report(dom_pair_id, ep.first, false);
+                    auto report = build_critical_path_report(dom_pair_id, ep.first, false, hold_corner);
                     violations.emplace_back(report);
                 }
             }
@@ -21,7 +21,10 @@
 #ifndef TIMING_H
 #define TIMING_H
 
+#include <memory>
 #include "nextpnr.h"
+#include "sso_array.h"
+#include "thread_pool.h"
 
 NEXTPNR_NAMESPACE_BEGIN
 
@@ -60,6 +63,18 @@ struct ClockDomainKey
 
 typedef int domain_id_t;
 
+// A timing corner. Arches only provide a single delay model, so corners are expressed as derating factors on the cell
+// and routing delays it gives
+struct TimingCorner
+{
+    IdString name;
+    float cell_derate = 1.0f, route_derate = 1.0f;
+};
+
+// The corners set with the "timing/corners" setting, as "name:cell_derate[:route_derate]" separated by commas; or a
+// single corner with no derating if it isn't set
+std::vector<TimingCorner> get_timing_corners(const Context *ctx);
+
 struct ClockDomainPairKey
 {
     domain_id_t launch, capture;
@@ -84,6 +99,7 @@ struct TimingAnalyser
     // model), but want to re-run STA with their own calculated delays
     void set_route_delay(CellPortKey port, DelayPair value);
 
+    // Criticalities and slacks are for the worst corner at each port
     float get_criticality(CellPortKey port) const { return ports.at(port).worst_crit; }
     float get_setup_slack(CellPortKey port) const { return ports.at(port).worst_setup_slack; }
     float get_domain_setup_slack(CellPortKey port) const
@@ -98,6 +114,8 @@ struct TimingAnalyser
 
     TimingResult &get_timing_result() { return result; }
 
+    const std::vector<TimingCorner> &get_corners() const { return corners; }
+
     // Enable analysis of clock skew between FFs.
     bool with_clock_skew = false;
 
@@ -105,11 +123,19 @@ struct TimingAnalyser
     bool have_loops = false;
     bool updated_domains = false;
 
+    // Only re-propagate arrival and required times through the cones of ports whose route delay changed since the last
+    // run, falling back to a full analysis if that isn't possible or the cones cover a large part of the design
+    bool incremental = false;
+
   private:
     void init_ports();
     void get_cell_delays();
     void get_route_delays();
     void topo_sort();
+    // Reorder topological_order by depth, so that no port depends on another in the same level
+    void levelize();
+    // Fill in comb_arcs and sorted_users once levelize has fixed the order
+    void setup_pull_lists();
     void setup_port_domains();
     void identify_related_domains();
 
@@ -121,44 +147,65 @@ struct TimingAnalyser
     void compute_slack();
     void compute_criticality();
 
+    // Update times only for the ports affected by changed_ports; returns false if a full run is needed instead
+    bool run_incremental();
+
     // Walk the endpoint back to a startpoint and get back the input ports walked
     // and the startpoint.
-    std::vector<PortRef> walk_crit_path(domain_id_t domain_pair, CellPortKey endpoint, bool longest_path);
+    std::vector<PortRef> walk_crit_path(domain_id_t domain_pair, CellPortKey endpoint, bool longest_path, int corner);
 
     void build_detailed_net_timing_report();
     // longest_path indicate whether to follow the longest or shortest path from endpoint to startpoint
     // longest paths are interesting for setup violations and shortest paths are interesting for hold violations
-    CriticalPath build_critical_path_report(domain_id_t domain_pair, CellPortKey endpoint, bool longest_path);
+    CriticalPath build_critical_path_report(domain_id_t domain_pair, CellPortKey endpoint, bool longest_path,
+                                            int corner);
     void build_crit_path_reports();
     void build_slack_histogram_report();
 
     std::vector<CriticalPath> get_min_delay_violations();
 
-    dict<domain_id_t, delay_t> max_delay_by_domain_pairs();
+    dict<domain_id_t, delay_t> max_delay_by_domain_pairs(int corner);
 
-    // get the N worst endpoints for a given domain pair
-    std::vector<CellPortKey> get_worst_eps(domain_id_t domain_pair, int count);
+    // get the N worst endpoints for a given domain pair, at a corner
+    std::vector<CellPortKey> get_worst_eps(domain_id_t domain_pair, int count, int corner);
 
-    // Set arrival/required times if more/less than the current value
-    void set_arrival_time(CellPortKey target, domain_id_t domain, DelayPair arrival, int path_length,
+    // Set arrival/required times if more/less than the current value, for each corner; arrival(c) and required(c) give
+    // the new value for corner c
+    template <typename Tf>
+    void set_arrival_time(CellPortKey target, domain_id_t domain, Tf arrival, int path_length,
                           CellPortKey prev = CellPortKey());
-    void set_required_time(CellPortKey target, domain_id_t domain, DelayPair required, int path_length,
+    template <typename Tf>
+    void set_required_time(CellPortKey target, domain_id_t domain, Tf required, int path_length,
                            CellPortKey prev = CellPortKey());
 
+    // A delay for each corner. One inline entry keeps the usual single corner analysis free of extra allocations
+    typedef SSOArray<DelayPair, 1> CornerDelays;
+    CornerDelays corner_delays(DelayPair value, bool route) const;
+    // The delay between two related clocks at a corner, or 0 if they aren't related. This is the delay through the
+    // combinational cells between the common driver and each clock, so it takes the cell derate; routing on the clock
+    // network is covered by the clock skew analysis instead
+    delay_t clock_to_clock_delay(IdString launch_clock, IdString capture_clock, int corner) const;
+
     // To avoid storing the domain tag structure (which could get large when considering more complex constrained tag
     // cases), assign each domain an ID and use that instead
     // An arrival or required time entry. Stores both the min/max delays; and the traversal to reach them for critical
-    // path reporting
-    struct ArrivReqTime
+    // path reporting, for each corner
+    struct CornerTime
     {
         DelayPair value;
         CellPortKey bwd_min, bwd_max;
+    };
+    struct ArrivReqTime
+    {
+        SSOArray<CornerTime, 1> by_corner;
         int path_length;
     };
     // Data per port-domain tuple
     struct PortDomainPairData
     {
+        // worst over all corners, and the corner it was found at
         delay_t setup_slack = std::numeric_limits<delay_t>::max(), hold_slack = std::numeric_limits<delay_t>::max();
+        int setup_corner = 0, hold_corner = 0;
         int max_path_length = 0;
         float criticality = 0;
     };
@@ -178,16 +225,24 @@ struct TimingAnalyser
         } type;
 
         IdString other_port;
-        DelayQuad value;
+        // delay for each corner
+        CornerDelays value;
         // Clock polarity, not used for combinational arcs
         ClockEdge edge;
 
-        CellArc(ArcType type, IdString other_port, DelayQuad value)
+        CellArc(ArcType type, IdString other_port, CornerDelays value)
                 : type(type), other_port(other_port), value(value), edge(RISING_EDGE) {};
-        CellArc(ArcType type, IdString other_port, DelayQuad value, ClockEdge edge)
+        CellArc(ArcType type, IdString other_port, CornerDelays value, ClockEdge edge)
                 : type(type), other_port(other_port), value(value), edge(edge) {};
     };
 
+    // A combinational arc stored on another port of the same cell, as that port and the index into its cell_arcs
+    struct CombArcRef
+    {
+        CellPortKey port;
+        int arc;
+    };
+
     // Timing data for every cell port
     struct PerPort
     {
@@ -199,12 +254,21 @@ struct TimingAnalyser
         dict<domain_id_t, PortDomainPairData> domain_pairs;
         // cell timing arcs to (outputs)/from (inputs)  from this port
         std::vector<CellArc> cell_arcs;
-        // routing delay into this port (input ports only)
-        DelayPair route_delay{0};
+        // for the levelized walks: the combinational arcs stored on other ports that end at (outputs)/start from
+        // (inputs) this port, and the net users of an output, in the order propagate_arrival/propagate_required visit
+        // them
+        std::vector<CombArcRef> comb_arcs;
+        std::vector<CellPortKey> sorted_users;
+        // routing delay into this port for each corner (input ports only)
+        CornerDelays route_delay;
         // worst criticality and slack across domain pairs
         float worst_crit = 0;
         delay_t worst_setup_slack = std::numeric_limits<delay_t>::max(),
                 worst_hold_slack = std::numeric_limits<delay_t>::max();
+        // position in topological_order
+        int topo_index = -1;
+        // incremental analysis state
+        bool route_delay_changed = false, in_fwd_cone = false, in_bwd_cone = false;
     };
 
     struct PerDomain
@@ -221,8 +285,32 @@ struct TimingAnalyser
         ClockDomainPairKey key;
         DelayPair period{0};
         delay_t worst_setup_slack, worst_hold_slack;
+        // delay between the launch and capture clocks for each corner, if they are related
+        CornerDelays clock_to_clock;
     };
 
+    void reset_port_times(PerPort &pd, bool arrival, bool required);
+    void init_startpoint_arrival(domain_id_t domain, const std::pair<CellPortKey, IdString> &sp);
+    void init_endpoint_required(domain_id_t domain, const std::pair<CellPortKey, IdString> &ep);
+    // Push times from a port to the next ports in the timing graph; if cone_only then just to those in the current
+    // incremental update cone
+    void propagate_arrival(CellPortKey port, bool cone_only);
+    void propagate_required(CellPortKey port, bool cone_only);
+    // Gather times into a port from all the ports that would push to it, in the same order as they would; used for the
+    // levelized walks, where each port in a level only writes to itself
+    void pull_arrival(CellPortKey port);
+    void pull_required(CellPortKey port);
+    delay_t port_setup_slack(const PerPort &pd, const PerDomainPair &dp, int corner) const;
+    delay_t port_hold_slack(const PerPort &pd, const PerDomainPair &dp, int corner) const;
+    void compute_port_slack(PerPort &pd);
+    void compute_worst_slack();
+    void compute_port_criticality(PerPort &pd);
+
+    template <typename Tf> void for_each_fanin(const CellPortKey &port, Tf func);
+    template <typename Tf> void for_each_fanout(const CellPortKey &port, Tf func);
+    // Call func for each port in topological_order[begin, end), on the thread pool if the range is large enough
+    template <typename Tf> void for_each_in_order(int begin, int end, Tf func);
+
     CellInfo *cell_info(const CellPortKey &key);
     PortInfo &port_info(const CellPortKey &key);
 
@@ -242,11 +330,22 @@ struct TimingAnalyser
     dict<std::pair<IdString, IdString>, delay_t> clock_delays;
 
     std::vector<CellPortKey> topological_order;
+    // Start of each level in topological_order, plus a final entry for the end; empty if there are loops
+    std::vector<int> level_starts;
+    // Only created for designs big enough to benefit from parallel walks
+    std::unique_ptr<ThreadPool> thread_pool;
+
+    // Input ports with a route delay changed since the last run
+    std::vector<CellPortKey> changed_ports;
+    // Whether every time is consistent with the route delays as of the last run
+    bool times_valid = false;
 
     domain_id_t async_clock_id;
 
     Context *ctx;
 
+    std::vector<TimingCorner> corners;
+
     TimingResult result;
 };
 
@@ -71,6 +71,8 @@ static void log_crit_paths(const Context *ctx, TimingResult &result)
     auto print_path_report = [ctx](const CriticalPath &path) {
         delay_t total(0), logic_total(0), route_total(0);
 
+        if (path.corner != IdString())
+            log_info("At timing corner '%s':\n", path.corner.c_str(ctx));
         log_info("      type curr  total name\n");
         for (const auto &segment : path.segments) {
 
@@ -236,6 +238,19 @@ static void log_fmax(Context *ctx, TimingResult &result, bool warn_on_failure)
     }
     log_break();
 
+    // Per-corner Fmax, the above being the worst of these
+    if (!result.corners.empty()) {
+        for (auto &corner : result.corners) {
+            for (auto &clock : corner.clock_fmax) {
+                const auto &clock_name = clock.first.str(ctx);
+                const int width = max_width - clock_name.size();
+                log_info("Max frequency at corner '%s' for clock %*s'%s': %.02f MHz\n", corner.name.c_str(ctx), width,
+                         "", clock_name.c_str(), clock.second.achieved);
+            }
+        }
+        log_break();
+    }
+
     // Clock to clock delays for xpaths
     dict<ClockPair, delay_t> xclock_delays;
     for (auto &report : result.xclock_paths) {
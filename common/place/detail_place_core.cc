@@ -48,24 +48,61 @@ PlacePartition::PlacePartition(Context *ctx)
     }
 }
 
-void PlacePartition::split(Context *ctx, bool yaxis, float pivot, PlacePartition &l, PlacePartition &r)
+void PlacePartition::split(Context *ctx, bool yaxis, float pivot, float slack, PlacePartition &l, PlacePartition &r)
 {
-    std::sort(cells.begin(), cells.end(), [&](CellInfo *a, CellInfo *b) {
-        Loc l0 = ctx->getBelLocation(a->bel), l1 = ctx->getBelLocation(b->bel);
-        return yaxis ? (l0.y < l1.y) : (l0.x < l1.x);
-    });
+    auto coord = [&](const CellInfo *cell) {
+        Loc loc = ctx->getBelLocation(cell->bel);
+        return yaxis ? loc.y : loc.x;
+    };
+    std::sort(cells.begin(), cells.end(), [&](CellInfo *a, CellInfo *b) { return coord(a) < coord(b); });
     size_t pivot_point = size_t(cells.size() * pivot);
+    int pivot_coord = (pivot_point == 0) ? (yaxis ? y1 : x1) : coord(cells.at(pivot_point - 1));
+    if (!cells.empty() && slack > 0) {
+        int lo = coord(cells.front()), hi = coord(cells.back());
+        // Span of each net over the cells in this partition; as cells are sorted the first one seen is the minimum
+        dict<IdString, std::pair<int, int>> net_span;
+        for (auto cell : cells) {
+            int c = coord(cell);
+            for (auto &port : cell->ports) {
+                if (!port.second.net)
+                    continue;
+                auto fnd = net_span.find(port.second.net->name);
+                if (fnd == net_span.end())
+                    net_span.emplace(port.second.net->name, std::make_pair(c, c));
+                else
+                    fnd->second.second = c;
+            }
+        }
+        // crossings[c - lo] is the number of nets cut by a boundary between c and c + 1
+        std::vector<int> crossings(hi - lo + 1, 0);
+        for (auto &span : net_span) {
+            ++crossings.at(span.second.first - lo);
+            --crossings.at(span.second.second - lo);
+        }
+        for (size_t i = 1; i < crossings.size(); i++)
+            crossings.at(i) += crossings.at(i - 1);
+        // Of the boundaries that keep the cell count within slack of the pivot, pick the one cutting fewest nets
+        size_t min_count = size_t(cells.size() * std::max(0.0f, pivot - slack));
+        size_t max_count = size_t(cells.size() * std::min(1.0f, pivot + slack));
+        int best_crossings = std::numeric_limits<int>::max();
+        for (size_t i = 0; i < cells.size(); i++) {
+            int c = coord(cells.at(i));
+            if ((i + 1) < cells.size() && coord(cells.at(i + 1)) == c)
+                continue;
+            if ((i + 1) < min_count)
+                continue;
+            if ((i + 1) > max_count)
+                break;
+            if (crossings.at(c - lo) < best_crossings) {
+                best_crossings = crossings.at(c - lo);
+                pivot_coord = c;
+            }
+        }
+    }
     l.cells.clear();
     r.cells.clear();
-    l.cells.reserve(pivot_point);
-    r.cells.reserve(cells.size() - pivot_point);
-    int pivot_coord = (pivot_point == 0) ? (yaxis ? y1 : x1)
-                                         : (yaxis ? ctx->getBelLocation(cells.at(pivot_point - 1)->bel).y
-                                                  : ctx->getBelLocation(cells.at(pivot_point - 1)->bel).x);
-    for (size_t i = 0; i < cells.size(); i++) {
-        Loc loc = ctx->getBelLocation(cells.at(i)->bel);
-        ((yaxis ? loc.y : loc.x) <= pivot_coord ? l.cells : r.cells).push_back(cells.at(i));
-    }
+    for (size_t i = 0; i < cells.size(); i++)
+        (coord(cells.at(i)) <= pivot_coord ? l.cells : r.cells).push_back(cells.at(i));
     if (yaxis) {
         l.x0 = r.x0 = x0;
         l.x1 = r.x1 = x1;
@@ -85,15 +122,16 @@ void PlacePartition::split(Context *ctx, bool yaxis, float pivot, PlacePartition
 
 void DetailPlacerState::update_global_costs()
 {
-    last_bounds.resize(flat_nets.size());
-    last_tmg_costs.resize(flat_nets.size());
+    netlist.update_all();
+    last_bounds.resize(netlist.nets.size());
+    last_tmg_costs.resize(netlist.nets.size());
     total_wirelen = 0;
     total_timing_cost = 0;
-    for (size_t i = 0; i < flat_nets.size(); i++) {
-        NetInfo *ni = flat_nets.at(i);
+    for (size_t i = 0; i < netlist.nets.size(); i++) {
+        NetInfo *ni = netlist.nets.at(i);
         if (skip_net(ni))
             continue;
-        last_bounds.at(i) = NetBB::compute(ctx, ni);
+        last_bounds.at(i) = netlist.net_bounds<NetBB>(netlist.locs, int(i));
         total_wirelen += last_bounds.at(i).hpwl(base_cfg);
         if (!timing_skip_net(ni)) {
             auto &tc = last_tmg_costs.at(i);
@@ -106,56 +144,11 @@ void DetailPlacerState::update_global_costs()
     }
 }
 
-NetBB NetBB::compute(const Context *ctx, const NetInfo *net, const dict<IdString, BelId> *cell2bel)
-{
-    NetBB result{};
-    if (!net->driver.cell)
-        return result;
-    auto bel_loc = [&](const CellInfo *cell) {
-        if (cell->isPseudo())
-            return cell->getLocation();
-        BelId bel = cell2bel ? cell2bel->at(cell->name) : cell->bel;
-        return ctx->getBelLocation(bel);
-    };
-    result.nx0 = result.nx1 = result.ny0 = result.ny1 = 1;
-    Loc drv_loc = bel_loc(net->driver.cell);
-    result.x0 = result.x1 = drv_loc.x;
-    result.y0 = result.y1 = drv_loc.y;
-    for (auto &usr : net->users) {
-        Loc l = bel_loc(usr.cell);
-        if (l.x == result.x0)
-            ++result.nx0; // on the edge
-        else if (l.x < result.x0) {
-            result.x0 = l.x; // extends the edge
-            result.nx0 = 1;
-        }
-        if (l.x == result.x1)
-            ++result.nx1; // on the edge
-        else if (l.x > result.x1) {
-            result.x1 = l.x; // extends the edge
-            result.nx1 = 1;
-        }
-        if (l.y == result.y0)
-            ++result.ny0; // on the edge
-        else if (l.y < result.y0) {
-            result.y0 = l.y; // extends the edge
-            result.ny0 = 1;
-        }
-        if (l.y == result.y1)
-            ++result.ny1; // on the edge
-        else if (l.y > result.y1) {
-            result.y1 = l.y; // extends the edge
-            result.ny1 = 1;
-        }
-    }
-    return result;
-}
-
 void DetailPlacerThreadState::set_partition(const PlacePartition &part)
 {
     p = part;
     thread_nets.clear();
-    thread_net_idx.resize(g.flat_nets.size());
+    thread_net_idx.resize(g.netlist.nets.size());
     std::fill(thread_net_idx.begin(), thread_net_idx.end(), -1);
     // Determine the set of nets that are within the thread; and therefore we care about
     for (auto thread_cell : part.cells) {
@@ -177,16 +170,11 @@ void DetailPlacerThreadState::set_partition(const PlacePartition &part)
         ignored_nets.push_back(g.skip_net(tn));
         tmg_ignored_nets.push_back(g.timing_skip_net(tn));
     }
-    // Set up the original cell-bel map for all nets inside the thread
-    local_cell2bel.clear();
-    for (NetInfo *net : thread_nets) {
-        if (net->driver.cell && !net->driver.cell->isPseudo())
-            local_cell2bel[net->driver.cell->name] = net->driver.cell->bel;
-        for (auto &usr : net->users) {
-            if (!usr.cell->isPseudo())
-                local_cell2bel[usr.cell->name] = usr.cell->bel;
-        }
-    }
+    // Set up the original cell bels and pin locations
+    local_cell_bels.resize(g.netlist.cells.size());
+    for (size_t i = 0; i < g.netlist.cells.size(); i++)
+        local_cell_bels.at(i) = g.netlist.cells.at(i)->bel;
+    local_locs = g.netlist.locs;
 }
 
 void DetailPlacerThreadState::setup_initial_state()
@@ -276,8 +264,11 @@ void DetailPlacerThreadState::revert_move()
         }
         arch_state_dirty = false;
     }
-    for (auto &entry : moved_cells)
-        local_cell2bel[entry.first] = entry.second.first;
+    for (auto &entry : moved_cells) {
+        int cell_idx = ctx->cells.at(entry.first)->udata;
+        local_cell_bels.at(cell_idx) = entry.second.first;
+        g.netlist.set_cell_loc(local_locs, cell_idx, ctx->getBelLocation(entry.second.first));
+    }
 }
 
 void DetailPlacerThreadState::commit_move()
@@ -408,10 +399,10 @@ void DetailPlacerThreadState::compute_total_change()
     auto &xa = axes.at(0), &ya = axes.at(1);
     for (auto &bc : xa.bounds_changed_nets)
         if (xa.already_bounds_changed.at(bc) == FULL_RECOMPUTE)
-            new_net_bounds.at(bc) = NetBB::compute(ctx, thread_nets.at(bc), &local_cell2bel);
+            new_net_bounds.at(bc) = g.netlist.net_bounds<NetBB>(local_locs, thread_nets.at(bc)->udata);
     for (auto &bc : ya.bounds_changed_nets)
         if (xa.already_bounds_changed.at(bc) != FULL_RECOMPUTE && ya.already_bounds_changed.at(bc) == FULL_RECOMPUTE)
-            new_net_bounds.at(bc) = NetBB::compute(ctx, thread_nets.at(bc), &local_cell2bel);
+            new_net_bounds.at(bc) = g.netlist.net_bounds<NetBB>(local_locs, thread_nets.at(bc)->udata);
     for (auto &bc : xa.bounds_changed_nets)
         wirelen_delta += (new_net_bounds.at(bc).hpwl(g.base_cfg) - net_bounds.at(bc).hpwl(g.base_cfg));
     for (auto &bc : ya.bounds_changed_nets)
@@ -420,7 +411,7 @@ void DetailPlacerThreadState::compute_total_change()
     if (g.base_cfg.timing_driven) {
         NPNR_ASSERT(new_timing_costs.empty());
         for (auto arc : timing_changed_arcs) {
-            double new_cost = g.get_timing_cost(thread_nets.at(arc.first), arc.second, &local_cell2bel);
+            double new_cost = g.get_timing_cost(thread_nets.at(arc.first), arc.second, &local_cell_bels);
             timing_delta += (new_cost - arc_tmg_cost.at(arc.first).at(arc.second.idx()));
             new_timing_costs.push_back(new_cost);
         }
@@ -455,7 +446,8 @@ bool DetailPlacerThreadState::add_to_move(CellInfo *cell, BelId old_bel, BelId n
         return false;
     NPNR_ASSERT(!moved_cells.count(cell->name));
     moved_cells[cell->name] = std::make_pair(old_bel, new_bel);
-    local_cell2bel[cell->name] = new_bel;
+    local_cell_bels.at(cell->udata) = new_bel;
+    g.netlist.set_cell_loc(local_locs, cell->udata, ctx->getBelLocation(new_bel));
     compute_changes_for_cell(cell, old_bel, new_bel);
     return true;
 }
@@ -48,6 +48,7 @@ aborts the entire move transaction.
 
 #include "detail_place_cfg.h"
 #include "fast_bels.h"
+#include "place_netlist.h"
 #include "timing.h"
 
 #include <queue>
@@ -64,7 +65,9 @@ struct PlacePartition
     std::vector<CellInfo *> cells;
     PlacePartition() = default;
     explicit PlacePartition(Context *ctx);
-    void split(Context *ctx, bool yaxis, float pivot, PlacePartition &l, PlacePartition &r);
+    // Split along one axis with about pivot of the cells going to l. If slack is nonzero, the boundary may be moved
+    // by up to that fraction of the cells to reduce the number of nets that cross it.
+    void split(Context *ctx, bool yaxis, float pivot, float slack, PlacePartition &l, PlacePartition &r);
 };
 
 typedef int64_t wirelen_t;
@@ -79,17 +82,17 @@ struct NetBB
     {
         return wirelen_t(cfg.hpwl_scale_x * (x1 - x0) + cfg.hpwl_scale_y * (y1 - y0));
     }
-    static NetBB compute(const Context *ctx, const NetInfo *net, const dict<IdString, BelId> *cell2bel = nullptr);
 };
 
 struct DetailPlacerState
 {
     explicit DetailPlacerState(Context *ctx, DetailPlaceCfg &cfg)
-            : ctx(ctx), base_cfg(cfg), bels(ctx, false, 64), tmg(ctx) {};
+            : ctx(ctx), base_cfg(cfg), bels(ctx, false, 64), netlist(ctx), tmg(ctx) {};
     Context *ctx;
     DetailPlaceCfg &base_cfg;
     FastBels bels;
-    std::vector<NetInfo *> flat_nets; // flat array of all nets in the design for fast referencing by index
+    // Flat view of all nets and cells in the design for fast referencing by index, with committed pin locations
+    PlaceNetlist netlist;
     std::vector<NetBB> last_bounds;
     std::vector<std::vector<double>> last_tmg_costs;
     dict<IdString, NetBB> region_bounds;
@@ -102,8 +105,9 @@ struct DetailPlacerState
     std::shared_timed_mutex archapi_mutex;
 #endif
 
+    // cell_bels, if given, is the bel of each cell by netlist index
     inline double get_timing_cost(const NetInfo *net, store_index<PortRef> user,
-                                  const dict<IdString, BelId> *cell2bel = nullptr)
+                                  const std::vector<BelId> *cell_bels = nullptr)
     {
         if (!net->driver.cell)
             return 0;
@@ -119,8 +123,8 @@ struct DetailPlacerState
             break;
         }
         float crit = tmg.get_criticality(CellPortKey(sink));
-        BelId src_bel = cell2bel ? cell2bel->at(net->driver.cell->name) : net->driver.cell->bel;
-        BelId dst_bel = cell2bel ? cell2bel->at(sink.cell->name) : sink.cell->bel;
+        BelId src_bel = cell_bels ? cell_bels->at(net->driver.cell->udata) : net->driver.cell->bel;
+        BelId dst_bel = cell_bels ? cell_bels->at(sink.cell->udata) : sink.cell->bel;
         double delay = ctx->getDelayNS(ctx->predictDelay(src_bel, driver_pin, dst_bel, sink_pin));
         return delay * std::pow(crit, base_cfg.crit_exp);
     }
@@ -166,8 +170,9 @@ struct DetailPlacerThreadState
     std::vector<std::vector<double>> arc_tmg_cost;
     std::vector<bool> ignored_nets, tmg_ignored_nets;
     bool arch_state_dirty = false;
-    // Our local cell-bel map; that won't be affected by out-of-partition moves
-    dict<IdString, BelId> local_cell2bel;
+    // Our local cell bels and pin locations, by netlist index; that won't be affected by out-of-partition moves
+    std::vector<BelId> local_cell_bels;
+    PlaceNetlist::PinLocs local_locs;
 
     // Data on an inflight move
     dict<IdString, std::pair<BelId, BelId>> moved_cells; // cell -> (old; new)
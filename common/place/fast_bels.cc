@@ -0,0 +1,111 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2018  Claire Xenia Wolf <claire@yosyshq.com>
+ *  Copyright (C) 2018  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "fast_bels.h"
+#include "thread_pool.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+FastBelsCache &FastBelsCache::get(Context *ctx)
+{
+    if (!ctx->fast_bels_cache)
+        ctx->fast_bels_cache = std::make_shared<FastBelsCache>();
+    return *ctx->fast_bels_cache;
+}
+
+void FastBelsCache::prepare(Context *ctx, const std::vector<IdString> &new_types,
+                            const std::vector<BelBucketId> &new_buckets)
+{
+    // Create the entries up front, so that the workers only fill in their own
+    std::vector<std::pair<IdString, Entry *>> type_work;
+    for (auto cell_type : new_types)
+        if (!cell_types.count(cell_type))
+            type_work.emplace_back(cell_type, nullptr);
+    std::vector<std::pair<BelBucketId, Entry *>> bucket_work;
+    for (auto bucket : new_buckets)
+        if (!buckets.count(bucket))
+            bucket_work.emplace_back(bucket, nullptr);
+    for (auto &work : type_work)
+        cell_types[work.first];
+    for (auto &work : bucket_work)
+        buckets[work.first];
+    for (auto &work : type_work)
+        work.second = &cell_types.at(work.first);
+    for (auto &work : bucket_work)
+        work.second = &buckets.at(work.first);
+
+    int count = int(type_work.size() + bucket_work.size());
+    if (count == 0)
+        return;
+    auto scan = [&](int i) {
+        if (i < int(type_work.size())) {
+            for (auto bel : ctx->getBels())
+                if (ctx->isValidBelForCellType(type_work.at(i).first, bel))
+                    type_work.at(i).second->bels.push_back(bel);
+        } else {
+            auto &work = bucket_work.at(i - type_work.size());
+            for (auto bel : ctx->getBels())
+                if (ctx->getBelBucketForBel(bel) == work.first)
+                    work.second->bels.push_back(bel);
+        }
+    };
+    if (count == 1) {
+        scan(0);
+    } else {
+        ThreadPool pool(std::min(count, std::max(1, ctx->setting<int>("threads", 8))));
+        pool.run(count, scan);
+    }
+}
+
+FastBelsCache::Entry &FastBelsCache::getCellType(Context *ctx, IdString cell_type)
+{
+    if (!cell_types.count(cell_type))
+        prepare(ctx, {cell_type}, {});
+    return cell_types.at(cell_type);
+}
+
+FastBelsCache::Entry &FastBelsCache::getBelBucket(Context *ctx, BelBucketId bucket)
+{
+    if (!buckets.count(bucket))
+        prepare(ctx, {}, {bucket});
+    return buckets.at(bucket);
+}
+
+std::shared_ptr<FastBelsGrid> FastBelsCache::getGrid(Context *ctx, Entry &entry, bool flat)
+{
+    auto &grid = flat ? entry.flat_grid : entry.grid;
+    if (!grid) {
+        grid = std::make_shared<FastBelsGrid>();
+        for (auto bel : entry.bels)
+            addToGrid(*grid, flat ? Loc(0, 0, 0) : ctx->getBelLocation(bel), bel);
+    }
+    return grid;
+}
+
+void FastBelsCache::addToGrid(FastBelsGrid &grid, Loc loc, BelId bel)
+{
+    if (int(grid.size()) < (loc.x + 1))
+        grid.resize(loc.x + 1);
+    if (int(grid.at(loc.x).size()) < (loc.y + 1))
+        grid.at(loc.x).resize(loc.y + 1);
+    grid.at(loc.x).at(loc.y).push_back(bel);
+}
+
+NEXTPNR_NAMESPACE_END
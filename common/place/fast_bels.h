@@ -21,14 +21,50 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include "nextpnr.h"
 
 NEXTPNR_NAMESPACE_BEGIN
 
+// Bels by x and then y location
+typedef std::vector<std::vector<std::vector<BelId>>> FastBelsGrid;
+
+// The bels that can take each cell type or bel bucket, shared between every FastBels on a Context through
+// ctx->fast_bels_cache. Which bels are valid for a type doesn't depend on the placement, so each type is only
+// scanned once per Context; bel availability does, so it is left to FastBels.
+struct FastBelsCache
+{
+    struct Entry
+    {
+        // Valid bels, in getBels() order
+        std::vector<BelId> bels;
+        // The bels by location, and with all of them at (0, 0); built when first needed
+        std::shared_ptr<FastBelsGrid> grid, flat_grid;
+    };
+
+    static FastBelsCache &get(Context *ctx);
+
+    // Scan for any of these types and buckets that aren't cached yet, in parallel
+    void prepare(Context *ctx, const std::vector<IdString> &cell_types, const std::vector<BelBucketId> &buckets);
+
+    Entry &getCellType(Context *ctx, IdString cell_type);
+    Entry &getBelBucket(Context *ctx, BelBucketId bucket);
+
+    // The shared grid of an entry, with all bels at (0, 0) if flat is set
+    std::shared_ptr<FastBelsGrid> getGrid(Context *ctx, Entry &entry, bool flat);
+    static void addToGrid(FastBelsGrid &grid, Loc loc, BelId bel);
+
+  private:
+    dict<IdString, Entry> cell_types;
+    dict<BelBucketId, Entry> buckets;
+};
+
 // FastBels is a lookup class that provides a fast lookup for finding BELs
 // that support a given cell type.
 struct FastBels
 {
+    typedef FastBelsGrid FastBelsData;
+
     struct TypeData
     {
         size_t type_index;
@@ -55,40 +91,10 @@ struct FastBels
         fast_bels_by_cell_type.resize(type_idx + 1);
         auto &bel_data = fast_bels_by_cell_type.at(type_idx);
         NPNR_ASSERT(bel_data.get() == nullptr);
-        bel_data = std::make_unique<FastBelsData>();
-
-        for (auto bel : ctx->getBels()) {
-            if (!ctx->isValidBelForCellType(cell_type, bel)) {
-                continue;
-            }
-
-            cell_type_data.number_of_possible_bels += 1;
-        }
-
-        for (auto bel : ctx->getBels()) {
-            if (check_bel_available && !ctx->checkBelAvail(bel)) {
-                continue;
-            }
-
-            if (!ctx->isValidBelForCellType(cell_type, bel)) {
-                continue;
-            }
-
-            Loc loc = ctx->getBelLocation(bel);
-            if (minBelsForGridPick >= 0 && cell_type_data.number_of_possible_bels < minBelsForGridPick) {
-                loc.x = loc.y = 0;
-            }
-
-            if (int(bel_data->size()) < (loc.x + 1)) {
-                bel_data->resize(loc.x + 1);
-            }
 
-            if (int(bel_data->at(loc.x).size()) < (loc.y + 1)) {
-                bel_data->at(loc.x).resize(loc.y + 1);
-            }
-
-            bel_data->at(loc.x).at(loc.y).push_back(bel);
-        }
+        auto &cached = FastBelsCache::get(ctx).getCellType(ctx, cell_type);
+        cell_type_data.number_of_possible_bels = int(cached.bels.size());
+        bel_data = buildGrid(cached);
     }
 
     void addBelBucket(BelBucketId partition)
@@ -106,43 +112,29 @@ struct FastBels
         fast_bels_by_partition_type.resize(type_idx + 1);
         auto &bel_data = fast_bels_by_partition_type.at(type_idx);
         NPNR_ASSERT(bel_data.get() == nullptr);
-        bel_data = std::make_unique<FastBelsData>();
-
-        for (auto bel : ctx->getBels()) {
-            if (ctx->getBelBucketForBel(bel) != partition) {
-                continue;
-            }
-
-            type_data.number_of_possible_bels += 1;
-        }
-
-        for (auto bel : ctx->getBels()) {
-            if (check_bel_available && !ctx->checkBelAvail(bel)) {
-                continue;
-            }
-
-            if (ctx->getBelBucketForBel(bel) != partition) {
-                continue;
-            }
-
-            Loc loc = ctx->getBelLocation(bel);
-            if (minBelsForGridPick >= 0 && type_data.number_of_possible_bels < minBelsForGridPick) {
-                loc.x = loc.y = 0;
-            }
 
-            if (int(bel_data->size()) < (loc.x + 1)) {
-                bel_data->resize(loc.x + 1);
-            }
-
-            if (int(bel_data->at(loc.x).size()) < (loc.y + 1)) {
-                bel_data->at(loc.x).resize(loc.y + 1);
-            }
-
-            bel_data->at(loc.x).at(loc.y).push_back(bel);
-        }
+        auto &cached = FastBelsCache::get(ctx).getBelBucket(ctx, partition);
+        type_data.number_of_possible_bels = int(cached.bels.size());
+        bel_data = buildGrid(cached);
     }
 
-    typedef std::vector<std::vector<std::vector<BelId>>> FastBelsData;
+    // Add several cell types and buckets at once, scanning the bels for those not yet cached in parallel
+    void addTypes(const pool<IdString> &cell_types_to_add, const pool<BelBucketId> &buckets_to_add)
+    {
+        std::vector<IdString> new_types;
+        for (auto cell_type : cell_types_to_add)
+            if (!cell_types.count(cell_type))
+                new_types.push_back(cell_type);
+        std::vector<BelBucketId> new_buckets;
+        for (auto bucket : buckets_to_add)
+            if (!partition_types.count(bucket))
+                new_buckets.push_back(bucket);
+        FastBelsCache::get(ctx).prepare(ctx, new_types, new_buckets);
+        for (auto cell_type : new_types)
+            addCellType(cell_type);
+        for (auto bucket : new_buckets)
+            addBelBucket(bucket);
+    }
 
     int getBelsForCellType(IdString cell_type, FastBelsData **data)
     {
@@ -179,10 +171,26 @@ struct FastBels
     const int minBelsForGridPick;
 
     dict<IdString, TypeData> cell_types;
-    std::vector<std::unique_ptr<FastBelsData>> fast_bels_by_cell_type;
+    std::vector<std::shared_ptr<FastBelsData>> fast_bels_by_cell_type;
 
     dict<BelBucketId, TypeData> partition_types;
-    std::vector<std::unique_ptr<FastBelsData>> fast_bels_by_partition_type;
+    std::vector<std::shared_ptr<FastBelsData>> fast_bels_by_partition_type;
+
+  private:
+    std::shared_ptr<FastBelsData> buildGrid(FastBelsCache::Entry &cached)
+    {
+        bool flat = minBelsForGridPick >= 0 && int(cached.bels.size()) < minBelsForGridPick;
+        // Without an availability check the grid is the same for every placer, so share the cached one
+        if (!check_bel_available)
+            return FastBelsCache::get(ctx).getGrid(ctx, cached, flat);
+        auto grid = std::make_shared<FastBelsData>();
+        for (auto bel : cached.bels) {
+            if (!ctx->checkBelAvail(bel))
+                continue;
+            FastBelsCache::addToGrid(*grid, flat ? Loc(0, 0, 0) : ctx->getBelLocation(bel), bel);
+        }
+        return grid;
+    }
 };
 
 NEXTPNR_NAMESPACE_END
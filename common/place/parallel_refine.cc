@@ -24,12 +24,12 @@
 
 #include "detail_place_core.h"
 #include "scope_lock.h"
+#include "thread_pool.h"
 
 #include <chrono>
 #include <mutex>
 #include <queue>
 #include <shared_mutex>
-#include <thread>
 
 NEXTPNR_NAMESPACE_BEGIN
 
@@ -369,13 +369,9 @@ struct ParallelRefine
     Context *ctx;
     GlobalState g;
     std::vector<ThreadState> t;
-    ParallelRefine(Context *ctx, ParallelRefineCfg cfg) : ctx(ctx), g(ctx, cfg)
+    ThreadPool thread_pool;
+    ParallelRefine(Context *ctx, ParallelRefineCfg cfg) : ctx(ctx), g(ctx, cfg), thread_pool(cfg.threads)
     {
-        g.flat_nets.reserve(ctx->nets.size());
-        for (auto &net : ctx->nets) {
-            net.second->udata = g.flat_nets.size();
-            g.flat_nets.push_back(net.second.get());
-        }
         // Setup per thread context
         for (int i = 0; i < cfg.threads; i++) {
             t.emplace_back(ctx, g, i);
@@ -415,36 +411,35 @@ struct ParallelRefine
                 g.cluster2cells[cell.second->cluster].push_back(cell.second.get());
         }
 
-        for (auto cell_type : cell_types_in_use) {
-            g.bels.addCellType(cell_type);
-        }
+        g.bels.addTypes(cell_types_in_use, {});
     };
     std::vector<PlacePartition> parts;
+    // Recursively bisect part into count partitions, giving each side a share of the cells in proportion to its
+    // share of the threads
+    void bisect(PlacePartition &part, int count, bool yaxis)
+    {
+        if (count == 1) {
+            parts.push_back(std::move(part));
+            return;
+        }
+        int l_count = count / 2;
+        // Randomly permute pivot every iteration so we get different thread boundaries
+        const float delta = 0.05, slack = 0.02;
+        float pivot = float(l_count) / count + delta * (ctx->rng(10000) / 10000.0f - 0.5f);
+        PlacePartition l, r;
+        part.split(ctx, yaxis, pivot, slack, l, r);
+        bisect(l, l_count, !yaxis);
+        bisect(r, count - l_count, !yaxis);
+    }
+
     void do_partition()
     {
         parts.clear();
-        parts.emplace_back(ctx);
-        bool yaxis = false;
-        while (parts.size() < t.size()) {
-            std::vector<PlacePartition> next(parts.size() * 2);
-            for (size_t i = 0; i < parts.size(); i++) {
-                // Randomly permute pivot every iteration so we get different thread boundaries
-                const float delta = 0.1;
-                float pivot = (0.5 - (delta / 2)) + (delta / 2) * (ctx->rng(10000) / 10000.0f);
-                parts.at(i).split(ctx, yaxis, pivot, next.at(i * 2), next.at(i * 2 + 1));
-            }
-            std::swap(parts, next);
-            yaxis = !yaxis;
-        }
+        PlacePartition root(ctx);
+        bisect(root, int(t.size()), false);
 
         NPNR_ASSERT(parts.size() == t.size());
-        // TODO: thread pool to make this worthwhile...
-        std::vector<std::thread> workers;
-        for (size_t i = 0; i < t.size(); i++) {
-            workers.emplace_back([i, this]() { t.at(i).set_partition(parts.at(i)); });
-        }
-        for (auto &w : workers)
-            w.join();
+        thread_pool.run(int(t.size()), [this](int i) { t.at(i).set_partition(parts.at(i)); });
     }
 
     void run()
@@ -496,15 +491,21 @@ struct ParallelRefine
             if (done)
                 break;
 
+            ProfileScope prof_iter(ctx->profiler, "refine/iter");
             do_partition();
 
-            std::vector<std::thread> workers;
-            workers.reserve(t.size());
-            for (int j = 0; j < int(t.size()); j++)
-                workers.emplace_back([this, j]() { t.at(j).run_iter(); });
-            for (auto &w : workers)
-                w.join();
-            g.tmg.run();
+            {
+                ProfileScope prof_scope(ctx->profiler, "refine/moves");
+                thread_pool.run(int(t.size()), [this](int j) { t.at(j).run_iter(); });
+            }
+            int64_t iter_moves = 0;
+            for (auto &t_data : t)
+                iter_moves += t_data.n_move;
+            ctx->profiler.add_count("refine/moves_evaluated", iter_moves);
+            {
+                ProfileScope prof_scope(ctx->profiler, "refine/timing");
+                g.tmg.run();
+            }
             g.update_global_costs();
             iter++;
             ctx->yield();
@@ -518,11 +519,8 @@ struct ParallelRefine
 ParallelRefineCfg::ParallelRefineCfg(Context *ctx) : DetailPlaceCfg(ctx)
 {
     threads = ctx->setting<int>("threads", 8);
-    // snap to nearest power of two; and minimum thread size
-    int actual_threads = 1;
-    while ((actual_threads * 2) <= threads && (int(ctx->cells.size()) / (actual_threads * 2)) >= min_thread_size)
-        actual_threads *= 2;
-    threads = actual_threads;
+    // minimum thread size
+    threads = std::max(1, std::min(threads, int(ctx->cells.size()) / min_thread_size));
 }
 
 bool parallel_refine(Context *ctx, ParallelRefineCfg cfg)
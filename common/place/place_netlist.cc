@@ -0,0 +1,95 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021-22  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "place_netlist.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+PlaceNetlist::PlaceNetlist(Context *ctx) : ctx(ctx)
+{
+    nets.reserve(ctx->nets.size());
+    old_net_udata.reserve(ctx->nets.size());
+    for (auto &net : ctx->nets) {
+        old_net_udata.push_back(net.second->udata);
+        net.second->udata = int(nets.size());
+        nets.push_back(net.second.get());
+    }
+    cells.reserve(ctx->cells.size());
+    old_cell_udata.reserve(ctx->cells.size());
+    for (auto &cell : ctx->cells) {
+        old_cell_udata.push_back(cell.second->udata);
+        cell.second->udata = int(cells.size());
+        cells.push_back(cell.second.get());
+    }
+    // Pins of each net
+    std::vector<int> cell_pin_count(cells.size(), 0);
+    net_pin_start.reserve(nets.size() + 1);
+    for (int i = 0; i < int(nets.size()); i++) {
+        NetInfo *ni = nets.at(i);
+        net_pin_start.push_back(int(pin_net.size()));
+        pin_net.push_back(i);
+        pin_cell.push_back(ni->driver.cell ? ni->driver.cell->udata : -1);
+        pin_net.resize(pin_net.size() + ni->users.capacity(), i);
+        pin_cell.resize(pin_cell.size() + ni->users.capacity(), -1);
+        for (auto usr : ni->users.enumerate())
+            pin_cell.at(user_pin(i, usr.index)) = usr.value.cell->udata;
+    }
+    net_pin_start.push_back(int(pin_net.size()));
+    // Pins of each cell, as a counting sort of pin_cell
+    for (int cell : pin_cell)
+        if (cell != -1)
+            ++cell_pin_count.at(cell);
+    cell_pin_start.resize(cells.size() + 1);
+    cell_pin_start.at(0) = 0;
+    for (size_t i = 0; i < cells.size(); i++)
+        cell_pin_start.at(i + 1) = cell_pin_start.at(i) + cell_pin_count.at(i);
+    cell_pins.resize(cell_pin_start.back());
+    std::vector<int> cursor(cell_pin_start.begin(), cell_pin_start.end() - 1);
+    for (int pin = 0; pin < num_pins(); pin++)
+        if (pin_cell.at(pin) != -1)
+            cell_pins.at(cursor.at(pin_cell.at(pin))++) = pin;
+    locs.x.resize(num_pins(), unplaced);
+    locs.y.resize(num_pins(), unplaced);
+    update_all();
+}
+
+PlaceNetlist::~PlaceNetlist()
+{
+    for (size_t i = 0; i < nets.size(); i++)
+        nets.at(i)->udata = old_net_udata.at(i);
+    for (size_t i = 0; i < cells.size(); i++)
+        cells.at(i)->udata = old_cell_udata.at(i);
+}
+
+Loc PlaceNetlist::cell_loc(const CellInfo *cell) const
+{
+    if (cell->isPseudo())
+        return cell->getLocation();
+    if (cell->bel == BelId())
+        return Loc(unplaced, unplaced, 0);
+    return ctx->getBelLocation(cell->bel);
+}
+
+void PlaceNetlist::update_all()
+{
+    for (auto cell : cells)
+        update_cell(cell);
+}
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,139 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021-22  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef PLACE_NETLIST_H
+#define PLACE_NETLIST_H
+
+#include <limits>
+#include <vector>
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+/*
+A flat view of the netlist for evaluating placement costs, so that finding the bounding box of a net is a walk over
+contiguous arrays rather than following users to cells to bels to locations.
+
+Nets and cells are numbered in the order of ctx->nets and ctx->cells, with the index stored in their udata; the
+original udata is restored when the view is destroyed. Each net has a contiguous range of pins: first the driver,
+then one for each user slot, so the pin for a user is found directly from its store_index. Pins with no cell (a net
+without a driver, or an unused user slot) have a pin_cell of -1.
+
+Pin locations are kept apart from the topology, so that threads can each keep their own copy of them. The placer must
+keep the locations up to date as it moves cells, with update_cell or set_cell_loc.
+*/
+struct PlaceNetlist
+{
+    // x location of a pin whose cell isn't placed
+    static constexpr int unplaced = std::numeric_limits<int>::min();
+
+    struct PinLocs
+    {
+        std::vector<int> x, y;
+    };
+
+    explicit PlaceNetlist(Context *ctx);
+    ~PlaceNetlist();
+
+    PlaceNetlist(const PlaceNetlist &) = delete;
+    PlaceNetlist &operator=(const PlaceNetlist &) = delete;
+
+    Context *ctx;
+    std::vector<NetInfo *> nets;
+    std::vector<CellInfo *> cells;
+
+    // The pins of net n are [net_pin_start[n], net_pin_start[n + 1])
+    std::vector<int> net_pin_start;
+    std::vector<int> pin_net, pin_cell;
+    // The pins of cell c are cell_pins[cell_pin_start[c]] to cell_pins[cell_pin_start[c + 1] - 1]
+    std::vector<int> cell_pin_start, cell_pins;
+
+    // Locations as of the last committed move
+    PinLocs locs;
+
+    int num_pins() const { return int(pin_net.size()); }
+    int driver_pin(int net) const { return net_pin_start[net]; }
+    int user_pin(int net, store_index<PortRef> user) const { return net_pin_start[net] + 1 + user.idx(); }
+    store_index<PortRef> pin_user(int pin) const
+    {
+        return store_index<PortRef>(pin - net_pin_start[pin_net[pin]] - 1);
+    }
+
+    // Current location of a cell, with x set to unplaced if it has no bel
+    Loc cell_loc(const CellInfo *cell) const;
+    void set_cell_loc(PinLocs &l, int cell, Loc loc) const
+    {
+        for (int i = cell_pin_start[cell]; i < cell_pin_start[cell + 1]; i++) {
+            l.x[cell_pins[i]] = loc.x;
+            l.y[cell_pins[i]] = loc.y;
+        }
+    }
+    void update_cell(const CellInfo *cell) { set_cell_loc(locs, cell->udata, cell_loc(cell)); }
+    void update_all();
+
+    // Bounding box of the placed pins of a net, and the number of pins on each edge. BB is NetBB or similar.
+    template <typename BB> BB net_bounds(const PinLocs &l, int net) const
+    {
+        BB bb{};
+        int drv = net_pin_start[net], end = net_pin_start[net + 1];
+        if (pin_cell[drv] == -1 || l.x[drv] == unplaced)
+            return bb;
+        bb.x0 = bb.x1 = l.x[drv];
+        bb.y0 = bb.y1 = l.y[drv];
+        bb.nx0 = bb.nx1 = bb.ny0 = bb.ny1 = 1;
+        for (int pin = drv + 1; pin < end; pin++) {
+            int x = l.x[pin], y = l.y[pin];
+            if (pin_cell[pin] == -1 || x == unplaced)
+                continue;
+            if (x == bb.x0)
+                ++bb.nx0;
+            else if (x < bb.x0) {
+                bb.x0 = x;
+                bb.nx0 = 1;
+            }
+            if (x == bb.x1)
+                ++bb.nx1;
+            else if (x > bb.x1) {
+                bb.x1 = x;
+                bb.nx1 = 1;
+            }
+            if (y == bb.y0)
+                ++bb.ny0;
+            else if (y < bb.y0) {
+                bb.y0 = y;
+                bb.ny0 = 1;
+            }
+            if (y == bb.y1)
+                ++bb.ny1;
+            else if (y > bb.y1) {
+                bb.y1 = y;
+                bb.ny1 = 1;
+            }
+        }
+        return bb;
+    }
+
+  private:
+    std::vector<decltype(NetInfo::udata)> old_net_udata;
+    std::vector<decltype(CellInfo::udata)> old_cell_udata;
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif
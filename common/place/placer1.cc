@@ -42,6 +42,7 @@
 #include "fast_bels.h"
 #include "log.h"
 #include "place_common.h"
+#include "place_netlist.h"
 #include "scope_lock.h"
 #include "timing.h"
 #include "util.h"
@@ -65,7 +66,8 @@ class SAPlacer
 
   public:
     SAPlacer(Context *ctx, Placer1Cfg cfg)
-            : ctx(ctx), fast_bels(ctx, /*check_bel_available=*/false, cfg.minBelsForGridPick), cfg(cfg), tmg(ctx)
+            : ctx(ctx), netlist(ctx), fast_bels(ctx, /*check_bel_available=*/false, cfg.minBelsForGridPick), cfg(cfg),
+              tmg(ctx)
     {
         for (auto bel : ctx->getBels()) {
             Loc loc = ctx->getBelLocation(bel);
@@ -82,21 +84,10 @@ class SAPlacer
             cell_types_in_use.insert(cell_type);
         }
 
-        for (auto cell_type : cell_types_in_use) {
-            fast_bels.addCellType(cell_type);
-        }
+        fast_bels.addTypes(cell_types_in_use, {});
 
         net_bounds.resize(ctx->nets.size());
-        net_arc_tcost.resize(ctx->nets.size());
-        old_udata.reserve(ctx->nets.size());
-        net_by_udata.reserve(ctx->nets.size());
-        decltype(NetInfo::udata) n = 0;
-        for (auto &net : ctx->nets) {
-            old_udata.emplace_back(net.second->udata);
-            net_arc_tcost.at(n).resize(net.second->users.capacity());
-            net.second->udata = n++;
-            net_by_udata.push_back(net.second.get());
-        }
+        pin_tcost.resize(netlist.num_pins());
         for (auto &region : ctx->region) {
             Region *r = region.second.get();
             BoundingBox bb;
@@ -128,12 +119,6 @@ class SAPlacer
         }
     }
 
-    ~SAPlacer()
-    {
-        for (auto &net : ctx->nets)
-            net.second->udata = old_udata[net.second->udata];
-    }
-
     bool place(bool refine = false)
     {
         log_break();
@@ -258,6 +243,7 @@ class SAPlacer
         temp = refine ? 1e-7 : cfg.startTemp;
 
         // Main simulated annealing loop
+        ProfileScope prof_anneal(ctx->profiler, "placer1/anneal");
         for (int iter = 1;; iter++) {
             n_move = n_accept = 0;
             improved = false;
@@ -285,11 +271,12 @@ class SAPlacer
                         try_swap_chain(cb, try_base);
                 }
             }
+            ctx->profiler.add_count("placer1/moves_evaluated", n_move);
 
             if (ctx->debug) {
                 // Verify correctness of incremental wirelen updates
                 for (size_t i = 0; i < net_bounds.size(); i++) {
-                    auto net = net_by_udata[i];
+                    auto net = netlist.nets[i];
                     if (ignore_net(net))
                         continue;
                     auto &incr = net_bounds.at(i), gold = get_net_bounds(net);
@@ -370,8 +357,10 @@ class SAPlacer
             }
 
             // Invoke timing analysis to obtain criticalities
-            if (cfg.timing_driven)
+            if (cfg.timing_driven) {
+                ProfileScope prof_scope(ctx->profiler, "placer1/timing");
                 tmg.run();
+            }
             // Need to rebuild costs after criticalities change
             setup_costs();
             // Reset incremental bounds
@@ -556,8 +545,10 @@ class SAPlacer
         return true;
     swap_fail:
         ctx->bindBel(oldBel, cell, STRENGTH_WEAK);
+        netlist.update_cell(cell);
         if (other_cell != nullptr) {
             ctx->bindBel(newBel, other_cell, STRENGTH_WEAK);
+            netlist.update_cell(other_cell);
             if (cfg.netShareWeight > 0)
                 update_nets_by_tile(other_cell, ctx->getBelLocation(oldBel), ctx->getBelLocation(newBel));
         }
@@ -578,8 +569,10 @@ class SAPlacer
             ctx->unbindBel(newBel);
         ctx->unbindBel(oldBel);
         ctx->bindBel(newBel, cell, (cell->cluster != ClusterId()) ? STRENGTH_STRONG : STRENGTH_WEAK);
+        netlist.update_cell(cell);
         if (bound != nullptr) {
             ctx->bindBel(oldBel, bound, (bound->cluster != ClusterId()) ? STRENGTH_STRONG : STRENGTH_WEAK);
+            netlist.update_cell(bound);
             if (cfg.netShareWeight > 0)
                 update_nets_by_tile(bound, ctx->getBelLocation(newBel), ctx->getBelLocation(oldBel));
         }
@@ -722,6 +715,7 @@ class SAPlacer
             log_info("%d bind %s %s\n", __LINE__, ctx->nameOfBel(cell_pair.second), cell->name.c_str(ctx));
 #endif
             ctx->bindBel(cell_pair.second, cell, STRENGTH_WEAK);
+            netlist.update_cell(cell);
         }
         return false;
     }
@@ -785,48 +779,8 @@ class SAPlacer
     // Get the bounding box for a net
     inline BoundingBox get_net_bounds(NetInfo *net)
     {
-        BoundingBox bb;
         NPNR_ASSERT(net->driver.cell != nullptr);
-        Loc dloc = net->driver.cell->getLocation();
-        bb.x0 = dloc.x;
-        bb.x1 = dloc.x;
-        bb.y0 = dloc.y;
-        bb.y1 = dloc.y;
-        bb.nx0 = 1;
-        bb.nx1 = 1;
-        bb.ny0 = 1;
-        bb.ny1 = 1;
-        for (auto user : net->users) {
-            if (!user.cell->isPseudo() && user.cell->bel == BelId())
-                continue;
-            Loc uloc = user.cell->getLocation();
-            if (bb.x0 == uloc.x)
-                ++bb.nx0;
-            else if (uloc.x < bb.x0) {
-                bb.x0 = uloc.x;
-                bb.nx0 = 1;
-            }
-            if (bb.x1 == uloc.x)
-                ++bb.nx1;
-            else if (uloc.x > bb.x1) {
-                bb.x1 = uloc.x;
-                bb.nx1 = 1;
-            }
-            if (bb.y0 == uloc.y)
-                ++bb.ny0;
-            else if (uloc.y < bb.y0) {
-                bb.y0 = uloc.y;
-                bb.ny0 = 1;
-            }
-            if (bb.y1 == uloc.y)
-                ++bb.ny1;
-            else if (uloc.y > bb.y1) {
-                bb.y1 = uloc.y;
-                bb.ny1 = 1;
-            }
-        }
-
-        return bb;
+        return netlist.net_bounds<BoundingBox>(netlist.locs, net->udata);
     }
 
     // Get the timing cost for an arc of a net
@@ -846,14 +800,14 @@ class SAPlacer
     // Set up the cost maps
     void setup_costs()
     {
-        for (auto &net : ctx->nets) {
-            NetInfo *ni = net.second.get();
+        netlist.update_all();
+        for (auto ni : netlist.nets) {
             if (ignore_net(ni))
                 continue;
             net_bounds[ni->udata] = get_net_bounds(ni);
             if (cfg.timing_driven && int(ni->users.entries()) < cfg.timingFanoutThresh)
                 for (auto usr : ni->users.enumerate())
-                    net_arc_tcost[ni->udata][usr.index.idx()] = get_timing_cost(ni, usr.value);
+                    pin_tcost[netlist.user_pin(ni->udata, usr.index)] = get_timing_cost(ni, usr.value);
         }
     }
 
@@ -870,11 +824,8 @@ class SAPlacer
     double total_timing_cost()
     {
         double cost = 0;
-        for (const auto &net : net_arc_tcost) {
-            for (auto arc_cost : net) {
-                cost += arc_cost;
-            }
-        }
+        for (auto arc_cost : pin_tcost)
+            cost += arc_cost;
         return cost;
     }
 
@@ -891,13 +842,14 @@ class SAPlacer
         };
 
         std::vector<decltype(NetInfo::udata)> bounds_changed_nets_x, bounds_changed_nets_y;
-        std::vector<std::pair<decltype(NetInfo::udata), store_index<PortRef>>> changed_arcs;
+        // Arcs are identified by the netlist pin of their sink
+        std::vector<int> changed_arcs;
 
         std::vector<BoundChangeType> already_bounds_changed_x, already_bounds_changed_y;
-        std::vector<std::vector<bool>> already_changed_arcs;
+        std::vector<bool> already_changed_arcs;
 
         std::vector<BoundingBox> new_net_bounds;
-        std::vector<std::pair<std::pair<decltype(NetInfo::udata), store_index<PortRef>>, double>> new_arc_costs;
+        std::vector<std::pair<int, double>> new_arc_costs;
 
         wirelen_t wirelen_delta = 0;
         double timing_delta = 0;
@@ -906,10 +858,7 @@ class SAPlacer
         {
             already_bounds_changed_x.resize(p->ctx->nets.size());
             already_bounds_changed_y.resize(p->ctx->nets.size());
-            already_changed_arcs.resize(p->ctx->nets.size());
-            for (auto &net : p->ctx->nets) {
-                already_changed_arcs.at(net.second->udata).resize(net.second->users.capacity());
-            }
+            already_changed_arcs.resize(p->netlist.num_pins());
             new_net_bounds = p->net_bounds;
         }
 
@@ -923,8 +872,8 @@ class SAPlacer
                 new_net_bounds[bc] = p->net_bounds[bc];
                 already_bounds_changed_y[bc] = NO_CHANGE;
             }
-            for (const auto &tc : changed_arcs)
-                already_changed_arcs[tc.first][tc.second.idx()] = false;
+            for (int tc : changed_arcs)
+                already_changed_arcs[tc] = false;
             bounds_changed_nets_x.clear();
             bounds_changed_nets_y.clear();
             changed_arcs.clear();
@@ -939,6 +888,7 @@ class SAPlacer
     {
         Loc curr_loc = ctx->getBelLocation(cell->bel);
         Loc old_loc = ctx->getBelLocation(old_bel);
+        netlist.set_cell_loc(netlist.locs, cell->udata, curr_loc);
         // Check net bounds
         for (const auto &port : cell->ports) {
             NetInfo *pn = port.second.net;
@@ -1074,16 +1024,17 @@ class SAPlacer
                     int cc;
                     TimingPortClass cls = ctx->getPortTimingClass(cell, port.first, cc);
                     if (cls != TMG_IGNORE)
-                        for (auto usr : pn->users.enumerate())
-                            if (!mc.already_changed_arcs[pn->udata][usr.index.idx()]) {
-                                mc.changed_arcs.emplace_back(std::make_pair(pn->udata, usr.index));
-                                mc.already_changed_arcs[pn->udata][usr.index.idx()] = true;
+                        for (int pin = netlist.driver_pin(pn->udata) + 1; pin < netlist.net_pin_start[pn->udata + 1];
+                             pin++)
+                            if (netlist.pin_cell[pin] != -1 && !mc.already_changed_arcs[pin]) {
+                                mc.changed_arcs.push_back(pin);
+                                mc.already_changed_arcs[pin] = true;
                             }
                 } else if (port.second.type == PORT_IN) {
-                    auto usr_idx = port.second.user_idx;
-                    if (!mc.already_changed_arcs[pn->udata][usr_idx.idx()]) {
-                        mc.changed_arcs.emplace_back(std::make_pair(pn->udata, usr_idx));
-                        mc.already_changed_arcs[pn->udata][usr_idx.idx()] = true;
+                    int pin = netlist.user_pin(pn->udata, port.second.user_idx);
+                    if (!mc.already_changed_arcs[pin]) {
+                        mc.changed_arcs.push_back(pin);
+                        mc.already_changed_arcs[pin] = true;
                     }
                 }
             }
@@ -1094,12 +1045,12 @@ class SAPlacer
     {
         for (const auto &bc : md.bounds_changed_nets_x) {
             if (md.already_bounds_changed_x[bc] == MoveChangeData::FULL_RECOMPUTE)
-                md.new_net_bounds[bc] = get_net_bounds(net_by_udata[bc]);
+                md.new_net_bounds[bc] = get_net_bounds(netlist.nets[bc]);
         }
         for (const auto &bc : md.bounds_changed_nets_y) {
             if (md.already_bounds_changed_x[bc] != MoveChangeData::FULL_RECOMPUTE &&
                 md.already_bounds_changed_y[bc] == MoveChangeData::FULL_RECOMPUTE)
-                md.new_net_bounds[bc] = get_net_bounds(net_by_udata[bc]);
+                md.new_net_bounds[bc] = get_net_bounds(netlist.nets[bc]);
         }
 
         for (const auto &bc : md.bounds_changed_nets_x)
@@ -1109,13 +1060,13 @@ class SAPlacer
                 md.wirelen_delta += md.new_net_bounds[bc].hpwl(cfg) - net_bounds[bc].hpwl(cfg);
 
         if (cfg.timing_driven) {
-            for (const auto &tc : md.changed_arcs) {
-                double old_cost = net_arc_tcost.at(tc.first).at(tc.second.idx());
-                double new_cost =
-                        get_timing_cost(net_by_udata.at(tc.first), net_by_udata.at(tc.first)->users.at(tc.second));
-                md.new_arc_costs.emplace_back(std::make_pair(tc, new_cost));
+            for (int tc : md.changed_arcs) {
+                double old_cost = pin_tcost.at(tc);
+                NetInfo *net = netlist.nets.at(netlist.pin_net.at(tc));
+                double new_cost = get_timing_cost(net, net->users.at(netlist.pin_user(tc)));
+                md.new_arc_costs.emplace_back(tc, new_cost);
                 md.timing_delta += (new_cost - old_cost);
-                md.already_changed_arcs[tc.first][tc.second.idx()] = false;
+                md.already_changed_arcs[tc] = false;
             }
         }
     }
@@ -1127,7 +1078,7 @@ class SAPlacer
         for (const auto &bc : md.bounds_changed_nets_y)
             net_bounds[bc] = md.new_net_bounds[bc];
         for (const auto &tc : md.new_arc_costs)
-            net_arc_tcost[tc.first.first].at(tc.first.second.idx()) = tc.second;
+            pin_tcost[tc.first] = tc.second;
         curr_wirelen_cost += md.wirelen_delta;
         curr_timing_cost += md.timing_delta;
     }
@@ -1195,8 +1146,8 @@ class SAPlacer
 
     // Map nets to their bounding box (so we can skip recompute for moves that do not exceed the bounds
     std::vector<BoundingBox> net_bounds;
-    // Map net arcs to their timing cost (criticality * delay ns)
-    std::vector<std::vector<double>> net_arc_tcost;
+    // Map net arcs, by the netlist pin of their sink, to their timing cost (criticality * delay ns)
+    std::vector<double> pin_tcost;
 
     // Fast lookup for cell to clusters
     dict<ClusterId, std::vector<CellInfo *>> cluster2cell;
@@ -1206,6 +1157,7 @@ class SAPlacer
     double last_timing_cost, curr_timing_cost;
 
     Context *ctx;
+    PlaceNetlist netlist;
     float temp = 10;
     float crit_exp = 8;
     float lambda = 0.5;
@@ -1216,8 +1168,6 @@ class SAPlacer
     dict<IdString, BoundingBox> region_bounds;
     FastBels fast_bels;
     pool<BelId> locked_bels;
-    std::vector<NetInfo *> net_by_udata;
-    std::vector<decltype(NetInfo::udata)> old_udata;
     bool require_legal = true;
     const int legalise_dia = 4;
     Placer1Cfg cfg;
@@ -34,12 +34,15 @@
 #include "placer_heap.h"
 #include <Eigen/Core>
 #include <Eigen/IterativeLinearSolvers>
+#include <array>
 #include <boost/optional.hpp>
 #include <chrono>
 #include <deque>
 #include <fstream>
+#include <functional>
 #include <numeric>
 #include <queue>
+#include <shared_mutex>
 #include <tuple>
 #include "fast_bels.h"
 #include "log.h"
@@ -48,6 +51,7 @@
 #include "place_common.h"
 #include "placer1.h"
 #include "scope_lock.h"
+#include "thread_pool.h"
 #include "timing.h"
 #include "util.h"
 
@@ -130,6 +134,138 @@ template <typename T> struct EquationSystem
         // for (int i = 0; i < int(x.size()); i++)
         //    log_info("x[%d] = %f\n", i, x.at(i));
     }
+
+    // CSR copy of A and work vectors for solve_parallel, kept between solves so their storage is reused. As A is
+    // symmetric, its columns can be used directly as rows.
+    std::vector<int> row_start, col_idx;
+    std::vector<T> values, inv_diag, r, z, p, q;
+    std::vector<std::array<T, 3>> partials;
+
+    void build_csr()
+    {
+        int n = int(A.size());
+        // If every row still has the same number of entries, the row offsets can stay as they are
+        bool same_shape = int(row_start.size()) == (n + 1);
+        for (int i = 0; same_shape && i < n; i++)
+            same_shape = (row_start.at(i + 1) - row_start.at(i)) == int(A.at(i).size());
+        if (!same_shape) {
+            row_start.resize(n + 1);
+            row_start.at(0) = 0;
+            for (int i = 0; i < n; i++)
+                row_start.at(i + 1) = row_start.at(i) + int(A.at(i).size());
+            col_idx.resize(row_start.at(n));
+            values.resize(row_start.at(n));
+        }
+        inv_diag.resize(n);
+        for (int i = 0; i < n; i++) {
+            int k = row_start.at(i);
+            T diag = 0;
+            for (auto &el : A.at(i)) {
+                col_idx[k] = el.first;
+                values[k] = el.second;
+                if (el.first == i)
+                    diag = el.second;
+                ++k;
+            }
+            inv_diag[i] = (diag != 0) ? (1 / diag) : 1;
+        }
+    }
+
+    // Jacobi-preconditioned conjugate gradient, the same method as Eigen's default ConjugateGradient, with the
+    // vector operations split into fixed size chunks that are run on pool (or serially if it is null). Partial sums
+    // are always combined in chunk order, so the result doesn't depend on the number of threads.
+    void solve_parallel(std::vector<T> &x, float tolerance, ThreadPool *pool)
+    {
+        if (x.empty())
+            return;
+        NPNR_ASSERT(x.size() == A.size());
+        const int n = int(A.size());
+        const int chunk_size = 2048;
+        const int chunks = (n + chunk_size - 1) / chunk_size;
+        build_csr();
+        r.resize(n);
+        z.resize(n);
+        p.resize(n);
+        q.resize(n);
+        partials.resize(chunks);
+
+        auto for_chunks = [&](auto func) {
+            auto do_chunk = [&](int c) { func(c, c * chunk_size, std::min(n, (c + 1) * chunk_size)); };
+            if (pool != nullptr) {
+                pool->run(chunks, do_chunk);
+            } else {
+                for (int c = 0; c < chunks; c++)
+                    do_chunk(c);
+            }
+        };
+        auto sum_partials = [&](int i) {
+            T sum = 0;
+            for (auto &partial : partials)
+                sum += partial[i];
+            return sum;
+        };
+        auto row_dot = [&](int i, const std::vector<T> &v) {
+            T sum = 0;
+            for (int k = row_start[i]; k < row_start[i + 1]; k++)
+                sum += values[k] * v[col_idx[k]];
+            return sum;
+        };
+
+        // r = b - Ax; z = M^-1 r; p = z
+        for_chunks([&](int c, int begin, int end) {
+            T rr = 0, bb = 0, rz = 0;
+            for (int i = begin; i < end; i++) {
+                r[i] = rhs[i] - row_dot(i, x);
+                z[i] = inv_diag[i] * r[i];
+                p[i] = z[i];
+                rr += r[i] * r[i];
+                bb += rhs[i] * rhs[i];
+                rz += r[i] * z[i];
+            }
+            partials[c] = {rr, bb, rz};
+        });
+        T rr = sum_partials(0), bb = sum_partials(1), rz = sum_partials(2);
+        if (bb == 0) {
+            std::fill(x.begin(), x.end(), T());
+            return;
+        }
+        const T threshold = T(tolerance) * T(tolerance) * bb;
+        for (int iter = 0; iter < 2 * n && rr >= threshold; iter++) {
+            // q = Ap
+            for_chunks([&](int c, int begin, int end) {
+                T pq = 0;
+                for (int i = begin; i < end; i++) {
+                    q[i] = row_dot(i, p);
+                    pq += p[i] * q[i];
+                }
+                partials[c] = {pq, 0, 0};
+            });
+            T alpha = rz / sum_partials(0);
+            // x += alpha * p; r -= alpha * q; z = M^-1 r
+            for_chunks([&](int c, int begin, int end) {
+                T rr = 0, rz = 0;
+                for (int i = begin; i < end; i++) {
+                    x[i] += alpha * p[i];
+                    r[i] -= alpha * q[i];
+                    z[i] = inv_diag[i] * r[i];
+                    rr += r[i] * r[i];
+                    rz += r[i] * z[i];
+                }
+                partials[c] = {rr, rz, 0};
+            });
+            rr = sum_partials(0);
+            if (rr < threshold)
+                break;
+            T rz_new = sum_partials(1);
+            T beta = rz_new / rz;
+            rz = rz_new;
+            // p = z + beta * p
+            for_chunks([&](int c, int begin, int end) {
+                for (int i = begin; i < end; i++)
+                    p[i] = z[i] + beta * p[i];
+            });
+        }
+    }
 };
 
 } // namespace
@@ -141,6 +277,14 @@ class HeAPPlacer
             : ctx(ctx), cfg(cfg), fast_bels(ctx, /*check_bel_available=*/true, -1), tmg(ctx)
     {
         Eigen::initParallel();
+        // The x and y axes are already solved in parallel, so each gets half of the threads
+        int axis_threads = cfg.solverThreads / 2;
+        if (cfg.parallelSolver && axis_threads > 1)
+            for (auto &solve_pool : solve_pools)
+                solve_pool = std::make_unique<ThreadPool>(axis_threads);
+        // Legalise by region whenever asked to, even with one thread, so that the result doesn't depend on the count
+        if (cfg.parallelLegalise)
+            legalise_pool = std::make_unique<ThreadPool>(std::max(1, cfg.solverThreads));
         tmg.setup_only = true;
         tmg.setup();
 
@@ -163,6 +307,7 @@ class HeAPPlacer
                  int(place_cells.size()), int(hpwl));
         for (int i = 0; i < 4; i++) {
             setup_solve_cells();
+            ProfileScope prof_scope(ctx->profiler, "heap/solve");
             auto solve_startt = std::chrono::high_resolution_clock::now();
 #ifdef NPNR_DISABLE_THREADS
             build_solve_direction(false, -1);
@@ -229,20 +374,24 @@ class HeAPPlacer
                 setup_solve_cells(&run);
                 if (solve_cells.empty())
                     continue;
+                ProfileScope prof_iter(ctx->profiler, "heap/iter");
                 // Heuristic: don't bother with threading below a certain size
                 auto solve_startt = std::chrono::high_resolution_clock::now();
 
                 // Build the connectivity matrix and run the solver; multithreaded between x and y axes if applicable
+                {
+                    ProfileScope prof_scope(ctx->profiler, "heap/solve");
 #ifndef NPNR_DISABLE_THREADS
-                if (solve_cells.size() >= 500) {
-                    boost::thread xaxis([&]() { build_solve_direction(false, (iter == 0) ? -1 : iter); });
-                    build_solve_direction(true, (iter == 0) ? -1 : iter);
-                    xaxis.join();
-                } else
+                    if (solve_cells.size() >= 500) {
+                        boost::thread xaxis([&]() { build_solve_direction(false, (iter == 0) ? -1 : iter); });
+                        build_solve_direction(true, (iter == 0) ? -1 : iter);
+                        xaxis.join();
+                    } else
 #endif
-                {
-                    build_solve_direction(false, (iter == 0) ? -1 : iter);
-                    build_solve_direction(true, (iter == 0) ? -1 : iter);
+                    {
+                        build_solve_direction(false, (iter == 0) ? -1 : iter);
+                        build_solve_direction(true, (iter == 0) ? -1 : iter);
+                    }
                 }
                 auto solve_endt = std::chrono::high_resolution_clock::now();
                 solve_time += std::chrono::duration<double>(solve_endt - solve_startt).count();
@@ -252,18 +401,24 @@ class HeAPPlacer
                 update_all_chains();
 
                 // Run the spreader
-                for (const auto &group : cfg.cellGroups)
-                    CutSpreader(this, group).run();
-
-                for (auto type : run)
-                    if (std::all_of(cfg.cellGroups.begin(), cfg.cellGroups.end(),
-                                    [type](const pool<BelBucketId> &grp) { return !grp.count(type); }))
-                        CutSpreader(this, {type}).run();
+                {
+                    ProfileScope prof_scope(ctx->profiler, "heap/spread");
+                    for (const auto &group : cfg.cellGroups)
+                        CutSpreader(this, group).run();
+
+                    for (auto type : run)
+                        if (std::all_of(cfg.cellGroups.begin(), cfg.cellGroups.end(),
+                                        [type](const pool<BelBucketId> &grp) { return !grp.count(type); }))
+                            CutSpreader(this, {type}).run();
+                }
 
                 // Run strict legalisation to find a valid bel for all cells
                 update_all_chains();
                 spread_hpwl = total_hpwl();
-                legalise_placement_strict(true);
+                {
+                    ProfileScope prof_scope(ctx->profiler, "heap/legalise");
+                    legalise_placement_strict(true);
+                }
                 update_all_chains();
 
                 legal_hpwl = total_hpwl();
@@ -277,8 +432,10 @@ class HeAPPlacer
             }
 
             // Update timing weights
-            if (cfg.timing_driven)
+            if (cfg.timing_driven) {
+                ProfileScope prof_scope(ctx->profiler, "heap/timing");
                 tmg.run();
+            }
 
             if (legal_hpwl < best_hpwl) {
                 best_hpwl = legal_hpwl;
@@ -396,6 +553,16 @@ class HeAPPlacer
 
     TimingAnalyser tmg;
 
+    // Thread pools for the parallel solver, for the x and y axes
+    std::unique_ptr<ThreadPool> solve_pools[2];
+
+    // Thread pool for the parallel strict legaliser, and the size in tiles of the regions it works on
+    std::unique_ptr<ThreadPool> legalise_pool;
+#if !defined(NPNR_DISABLE_THREADS)
+    // Guards Arch API calls from the parallel strict legaliser
+    std::shared_timed_mutex archapi_mutex;
+#endif
+
     dict<IdString, BoundingBox> constraint_region_bounds;
 
     // In some cases, we can't use bindBel because we allow overlap in the earlier stages. So we use this custom
@@ -487,12 +654,7 @@ class HeAPPlacer
             buckets_in_use.insert(bucket);
         }
 
-        for (auto cell_type : cell_types_in_use) {
-            fast_bels.addCellType(cell_type);
-        }
-        for (auto bucket : buckets_in_use) {
-            fast_bels.addBelBucket(bucket);
-        }
+        fast_bels.addTypes(cell_types_in_use, buckets_in_use);
 
         // Determine bounding boxes of region constraints
         for (auto &region : ctx->region) {
@@ -523,8 +685,9 @@ class HeAPPlacer
     // Build and solve in one direction
     void build_solve_direction(bool yaxis, int iter)
     {
+        // Kept across iterations so that the solver can reuse its storage
+        EquationSystem<double> esx(solve_cells.size(), solve_cells.size());
         for (int i = 0; i < 5; i++) {
-            EquationSystem<double> esx(solve_cells.size(), solve_cells.size());
             build_equations(esx, yaxis, iter);
             solve_equations(esx, yaxis);
         }
@@ -803,7 +966,11 @@ class HeAPPlacer
         auto cell_pos = [&](CellInfo *cell) { return yaxis ? cell_locs.at(cell->name).y : cell_locs.at(cell->name).x; };
         std::vector<double> vals;
         std::transform(solve_cells.begin(), solve_cells.end(), std::back_inserter(vals), cell_pos);
-        es.solve(vals, cfg.solverTolerance);
+        if (cfg.parallelSolver)
+            es.solve_parallel(vals, cfg.solverTolerance, solve_pools[yaxis].get());
+        else
+            es.solve(vals, cfg.solverTolerance);
+        ctx->profiler.add_count("heap/equations_solved", int64_t(vals.size()));
         for (size_t i = 0; i < vals.size(); i++)
             if (yaxis) {
                 cell_locs.at(solve_cells.at(i)->name).rawy = vals.at(i);
@@ -861,12 +1028,56 @@ class HeAPPlacer
         // At the moment we don't follow the full HeAP algorithm using cuts for legalisation, instead using
         // the simple greedy largest-macro-first approach.
         std::priority_queue<std::pair<int, IdString>> remaining;
-        for (auto cell : solve_cells) {
-            remaining.emplace(chain_size[cell->name], cell->name);
+        if (legalise_pool != nullptr && std::max(max_x, max_y) + 1 >= 2 * cfg.legaliseRegionSize) {
+            // Macros go first, serially, as they can span regions. The rest are legalised by region, in parallel,
+            // leaving only those that didn't fit in their region for the serial legaliser.
+            for (auto cell : solve_cells)
+                if (cell->cluster != ClusterId())
+                    remaining.emplace(chain_size[cell->name], cell->name);
+            legalise_queue(remaining, require_validity);
+            std::vector<CellInfo *> deferred;
+            legalise_regions(require_validity, deferred);
+            for (auto cell : deferred)
+                remaining.emplace(chain_size[cell->name], cell->name);
+        } else {
+            for (auto cell : solve_cells) {
+                remaining.emplace(chain_size[cell->name], cell->name);
+            }
         }
+        legalise_queue(remaining, require_validity);
+
+        auto endt = std::chrono::high_resolution_clock::now();
+        sl_time += std::chrono::duration<float>(endt - startt).count();
+    }
+
+    // Greedily legalise a queue of cells, largest macro first
+    void legalise_queue(std::priority_queue<std::pair<int, IdString>> &remaining, bool require_validity)
+    {
         int ripup_radius = 2;
         int total_iters = 0;
         int total_iters_noreset = 0;
+
+        LegaliseOps ops;
+        ops.bound_cell = [&](BelId bel, bool &avail) {
+            avail = ctx->checkBelAvail(bel);
+            return ctx->getBoundBelCell(bel);
+        };
+        ops.bind = [&](BelId bel, CellInfo *cell, PlaceStrength strength) { ctx->bindBel(bel, cell, strength); };
+        ops.unbind = [&](BelId bel) { ctx->unbindBel(bel); };
+        ops.location_valid = [&](BelId bel) { return ctx->isBelLocationValid(bel); };
+        ops.location = [&](BelId bel) { return ctx->getBelLocation(bel); };
+        ops.cluster_placement = [&](ClusterId cluster, BelId root_bel,
+                                    std::vector<std::pair<CellInfo *, BelId>> &placement) {
+            return ctx->getClusterPlacement(cluster, root_bel, placement);
+        };
+        ops.test_region = [&](CellInfo *cell, BelId bel) { return cell->testRegion(bel); };
+        ops.may_ripup = []() { return true; };
+        ops.ripped_up = [&](CellInfo *cell) { remaining.emplace(chain_size[cell->name], cell->name); };
+        ops.placed = [&](CellInfo *cell, Loc loc) {
+            cell_locs[cell->name].x = loc.x;
+            cell_locs[cell->name].y = loc.y;
+        };
+
         while (!remaining.empty()) {
             auto top = remaining.top();
             remaining.pop();
@@ -876,15 +1087,6 @@ class HeAPPlacer
             if (ci->bel != BelId())
                 continue;
             // log_info("   Legalising %s (%s) %d\n", top.second.c_str(ctx), ci->type.c_str(ctx), top.first);
-            FastBels::FastBelsData *fb;
-            fast_bels.getBelsForCellType(ci->type, &fb);
-            int radius = 0;
-            int iter = 0;
-            int iter_at_radius = 0;
-            int total_iters_for_cell = 0;
-            bool placed = false;
-            BelId bestBel;
-            int best_inp_len = std::numeric_limits<int>::max();
 
             total_iters++;
             total_iters_noreset++;
@@ -897,220 +1099,409 @@ class HeAPPlacer
                 log_error("Unable to find legal placement for all cells, design is probably at utilisation limit.\n");
             }
 
-            while (!placed) {
-                if (cfg.cell_placement_timeout > 0 && total_iters_for_cell > cfg.cell_placement_timeout)
-                    log_error("Unable to find legal placement for cell '%s' of type '%s' after %d attempts, check "
-                              "constraints and "
-                              "utilisation. Use `--placer-heap-cell-placement-timeout` to change the number of "
-                              "attempts.\n",
-                              ctx->nameOf(ci), ci->type.c_str(ctx), total_iters_for_cell);
-
-                // Determine a search radius around the solver location (which increases over time) that is clamped to
-                // the region constraint for the cell (if applicable)
-                int rx = radius, ry = radius;
-
-                if (ci->region != nullptr) {
-                    rx = std::min(radius, (constraint_region_bounds[ci->region->name].x1 -
-                                           constraint_region_bounds[ci->region->name].x0) /
-                                                          2 +
-                                                  1);
-                    ry = std::min(radius, (constraint_region_bounds[ci->region->name].y1 -
-                                           constraint_region_bounds[ci->region->name].y0) /
-                                                          2 +
-                                                  1);
-                }
+            int attempts = 0;
+            if (!legalise_cell(ci, 0, 0, max_x, max_y, *ctx, ops, ripup_radius, cfg.cell_placement_timeout,
+                               require_validity, attempts))
+                log_error("Unable to find legal placement for cell '%s' of type '%s' after %d attempts, check "
+                          "constraints and "
+                          "utilisation. Use `--placer-heap-cell-placement-timeout` to change the number of "
+                          "attempts.\n",
+                          ctx->nameOf(ci), ci->type.c_str(ctx), attempts);
+        }
+    }
+
+    // How legalise_cell looks at and changes the placement, so the same search can legalise the whole grid serially or
+    // regions of it in parallel
+    struct LegaliseOps
+    {
+        // The cell bound to a bel, also setting avail to whether the bel is available
+        std::function<CellInfo *(BelId, bool &)> bound_cell;
+        std::function<void(BelId, CellInfo *, PlaceStrength)> bind;
+        std::function<void(BelId)> unbind;
+        std::function<bool(BelId)> location_valid;
+        std::function<Loc(BelId)> location;
+        std::function<bool(ClusterId, BelId, std::vector<std::pair<CellInfo *, BelId>> &)> cluster_placement;
+        std::function<bool(CellInfo *, BelId)> test_region;
+        // Whether an unavailable bel may be taken by ripping up its cell
+        std::function<bool()> may_ripup;
+        // Called for each cell ripped up to make room, which then needs legalising again
+        std::function<void(CellInfo *)> ripped_up;
+        // Called with the new location of each cell placed
+        std::function<void(CellInfo *, Loc)> placed;
+    };
+
+    // Search for a legal location for a cell, and for the rest of its macro if it has one, within the tiles (x0, y0) to
+    // (x1, y1). Random locations are tried around the solver location, with the radius growing over time, keeping the
+    // one with the shortest inputs. Returns false if the cell wasn't placed after max_attempts tries (if non-zero);
+    // attempts is set to the number of tries made either way.
+    bool legalise_cell(CellInfo *ci, int x0, int y0, int x1, int y1, DeterministicRNG &rng, const LegaliseOps &ops,
+                       int ripup_radius, int max_attempts, bool require_validity, int &attempts)
+    {
+        FastBels::FastBelsData *fb;
+        fast_bels.getBelsForCellType(ci->type, &fb);
+        const auto &solver_loc = cell_locs.at(ci->name);
+        int cx = std::min(x1, std::max(x0, solver_loc.x));
+        int cy = std::min(y1, std::max(y0, solver_loc.y));
+        const int max_radius = std::max(x1 - x0, y1 - y0);
+        int radius = 0;
+        int iter = 0;
+        int iter_at_radius = 0;
+        int &total_iters_for_cell = attempts;
+        total_iters_for_cell = 0;
+        BelId bestBel;
+        int best_inp_len = std::numeric_limits<int>::max();
+
+        while (true) {
+            if (max_attempts > 0 && total_iters_for_cell > max_attempts)
+                return false;
 
-                // Pick a random X and Y location within our search radius
-                int nx = ctx->rng(2 * rx + 1) + std::max(cell_locs.at(ci->name).x - rx, 0);
-                int ny = ctx->rng(2 * ry + 1) + std::max(cell_locs.at(ci->name).y - ry, 0);
-
-                iter++;
-                iter_at_radius++;
-                if (iter >= (10 * (radius + 1))) {
-                    // No luck yet, increase radius
-                    radius = std::min(std::max(max_x, max_y), radius + 1);
-                    while (radius < std::max(max_x, max_y)) {
-                        // Keep increasing the radius until it will actually increase the number of cells we are
-                        // checking (e.g. BRAM and DSP will not be in all cols/rows), so we don't waste effort
-                        for (int x = std::max(0, cell_locs.at(ci->name).x - radius);
-                             x <= std::min(max_x, cell_locs.at(ci->name).x + radius); x++) {
-                            if (x >= int(fb->size()))
+            // Determine a search radius around the solver location (which increases over time) that is clamped to
+            // the region constraint for the cell (if applicable)
+            int rx = radius, ry = radius;
+
+            if (ci->region != nullptr) {
+                rx = std::min(radius, (constraint_region_bounds[ci->region->name].x1 -
+                                       constraint_region_bounds[ci->region->name].x0) /
+                                                      2 +
+                                              1);
+                ry = std::min(radius, (constraint_region_bounds[ci->region->name].y1 -
+                                       constraint_region_bounds[ci->region->name].y0) /
+                                                      2 +
+                                              1);
+            }
+
+            // Pick a random X and Y location within our search radius
+            int nx = rng.rng(2 * rx + 1) + std::max(cx - rx, x0);
+            int ny = rng.rng(2 * ry + 1) + std::max(cy - ry, y0);
+
+            iter++;
+            iter_at_radius++;
+            if (iter >= (10 * (radius + 1))) {
+                // No luck yet, increase radius
+                radius = std::min(max_radius, radius + 1);
+                while (radius < max_radius) {
+                    // Keep increasing the radius until it will actually increase the number of cells we are
+                    // checking (e.g. BRAM and DSP will not be in all cols/rows), so we don't waste effort
+                    for (int x = std::max(x0, cx - radius); x <= std::min(x1, cx + radius); x++) {
+                        if (x >= int(fb->size()))
+                            break;
+                        for (int y = std::max(y0, cy - radius); y <= std::min(y1, cy + radius); y++) {
+                            if (y >= int(fb->at(x).size()))
                                 break;
-                            for (int y = std::max(0, cell_locs.at(ci->name).y - radius);
-                                 y <= std::min(max_y, cell_locs.at(ci->name).y + radius); y++) {
-                                if (y >= int(fb->at(x).size()))
-                                    break;
-                                if (fb->at(x).at(y).size() > 0)
-                                    goto notempty;
-                            }
+                            if (fb->at(x).at(y).size() > 0)
+                                goto notempty;
                         }
-                        radius = std::min(std::max(max_x, max_y), radius + 1);
                     }
-                notempty:
-                    iter_at_radius = 0;
-                    iter = 0;
+                    radius = std::min(max_radius, radius + 1);
                 }
-                // If our randomly chosen cooridnate is out of bounds; or points to a tile with no relevant bels; ignore
-                // it
-                if (nx < 0 || nx > max_x)
-                    continue;
-                if (ny < 0 || ny > max_y)
-                    continue;
-
-                if (nx >= int(fb->size()))
-                    continue;
-                if (ny >= int(fb->at(nx).size()))
-                    continue;
-                if (fb->at(nx).at(ny).empty())
-                    continue;
+            notempty:
+                iter_at_radius = 0;
+                iter = 0;
+            }
+            // If our randomly chosen cooridnate is out of bounds; or points to a tile with no relevant bels; ignore
+            // it
+            if (nx < x0 || nx > x1)
+                continue;
+            if (ny < y0 || ny > y1)
+                continue;
 
-                // The number of attempts to find a location to try
-                int need_to_explore = 2 * radius;
+            if (nx >= int(fb->size()))
+                continue;
+            if (ny >= int(fb->at(nx).size()))
+                continue;
+            if (fb->at(nx).at(ny).empty())
+                continue;
 
-                // If we have found at least one legal location; and made enough attempts; assume it's good enough and
-                // finish
-                if (iter_at_radius >= need_to_explore && bestBel != BelId()) {
-                    CellInfo *bound = ctx->getBoundBelCell(bestBel);
-                    if (bound != nullptr) {
-                        ctx->unbindBel(bound->bel);
-                        remaining.emplace(chain_size[bound->name], bound->name);
-                    }
-                    ctx->bindBel(bestBel, ci, STRENGTH_WEAK);
-                    placed = true;
-                    Loc loc = ctx->getBelLocation(bestBel);
-                    cell_locs[ci->name].x = loc.x;
-                    cell_locs[ci->name].y = loc.y;
-                    break;
+            // The number of attempts to find a location to try
+            int need_to_explore = 2 * radius;
+
+            // If we have found at least one legal location; and made enough attempts; assume it's good enough and
+            // finish
+            if (iter_at_radius >= need_to_explore && bestBel != BelId()) {
+                bool avail;
+                CellInfo *bound = ops.bound_cell(bestBel, avail);
+                if (bound != nullptr) {
+                    ops.unbind(bound->bel);
+                    ops.ripped_up(bound);
                 }
+                ops.bind(bestBel, ci, STRENGTH_WEAK);
+                ops.placed(ci, ops.location(bestBel));
+                return true;
+            }
 
-                if (ci->cluster == ClusterId()) {
-                    // The case where we have no relative constraints
-                    for (auto sz : fb->at(nx).at(ny)) {
-                        // Look through all bels in this tile; checking region constraint if applicable
-                        if (!ci->testRegion(sz))
+            if (ci->cluster == ClusterId()) {
+                // The case where we have no relative constraints
+                for (auto sz : fb->at(nx).at(ny)) {
+                    // Look through all bels in this tile; checking region constraint if applicable
+                    if (!ops.test_region(ci, sz))
+                        continue;
+                    // Prefer available bels; unless we are dealing with a wide radius (e.g. difficult control sets)
+                    // or occasionally trigger a tiebreaker
+                    bool avail;
+                    CellInfo *bound = ops.bound_cell(sz, avail);
+                    if (!avail && !(ops.may_ripup() && (radius > ripup_radius || rng.rng(20000) < 10)))
+                        continue;
+                    if (bound != nullptr) {
+                        // Only rip up cells without constraints
+                        if (bound->cluster != ClusterId() || bound->belStrength > STRENGTH_WEAK)
                             continue;
-                        // Prefer available bels; unless we are dealing with a wide radius (e.g. difficult control sets)
-                        // or occasionally trigger a tiebreaker
-                        if (ctx->checkBelAvail(sz) || (radius > ripup_radius || ctx->rng(20000) < 10)) {
-                            CellInfo *bound = ctx->getBoundBelCell(sz);
-                            if (bound != nullptr) {
-                                // Only rip up cells without constraints
-                                if (bound->cluster != ClusterId() || bound->belStrength > STRENGTH_WEAK)
-                                    continue;
-                                ctx->unbindBel(bound->bel);
-                            }
-                            // Provisionally bind the bel
-                            ctx->bindBel(sz, ci, STRENGTH_WEAK);
-                            if (require_validity && !ctx->isBelLocationValid(sz)) {
-                                // New location is not legal; unbind the cell (and rebind the cell we ripped up if
-                                // applicable)
-                                ctx->unbindBel(sz);
-                                if (bound != nullptr)
-                                    ctx->bindBel(sz, bound, STRENGTH_WEAK);
-                            } else if (iter_at_radius < need_to_explore) {
-                                // It's legal, but we haven't tried enough locations yet
-                                ctx->unbindBel(sz);
-                                if (bound != nullptr)
-                                    ctx->bindBel(sz, bound, STRENGTH_WEAK);
-                                int input_len = 0;
-                                // Compute a fast input wirelength metric at this bel; and save if better than our last
-                                // try
-                                for (auto &port : ci->ports) {
-                                    auto &p = port.second;
-                                    if (p.type != PORT_IN || p.net == nullptr || p.net->driver.cell == nullptr)
-                                        continue;
-                                    CellInfo *drv = p.net->driver.cell;
-                                    auto drv_loc = cell_locs.find(drv->name);
-                                    if (drv_loc == cell_locs.end())
-                                        continue;
-                                    if (drv_loc->second.global)
-                                        continue;
-                                    input_len += std::abs(drv_loc->second.x - nx) + std::abs(drv_loc->second.y - ny);
-                                }
-                                if (input_len < best_inp_len) {
-                                    best_inp_len = input_len;
-                                    bestBel = sz;
-                                }
-                                break;
-                            } else {
-                                // It's legal, and we've tried enough. Finish.
-                                if (bound != nullptr)
-                                    remaining.emplace(chain_size[bound->name], bound->name);
-                                Loc loc = ctx->getBelLocation(sz);
-                                cell_locs[ci->name].x = loc.x;
-                                cell_locs[ci->name].y = loc.y;
-                                placed = true;
-                                break;
-                            }
-                        }
+                        ops.unbind(bound->bel);
                     }
-                } else {
-                    // We do have relative constraints
-                    for (auto sz : fb->at(nx).at(ny)) {
-                        // List of cells and their destination
-                        std::vector<std::pair<CellInfo *, BelId>> targets;
-                        // List of bels we placed things at; and the cell that was there before if applicable
-                        std::vector<std::pair<BelId, CellInfo *>> swaps_made;
-
-                        if (!ctx->getClusterPlacement(ci->cluster, sz, targets))
-                            continue;
-
-                        for (auto &target : targets) {
-                            // Check it satisfies the region constraint if applicable
-                            if (!target.first->testRegion(target.second))
-                                goto fail;
-                            CellInfo *bound = ctx->getBoundBelCell(target.second);
-                            // Chains cannot overlap; so if we have to ripup a cell make sure it isn't part of a chain
-                            if (bound != nullptr)
-                                if (bound->cluster != ClusterId() || bound->belStrength > STRENGTH_WEAK)
-                                    goto fail;
+                    // Provisionally bind the bel
+                    ops.bind(sz, ci, STRENGTH_WEAK);
+                    if (require_validity && !ops.location_valid(sz)) {
+                        // New location is not legal; unbind the cell (and rebind the cell we ripped up if
+                        // applicable)
+                        ops.unbind(sz);
+                        if (bound != nullptr)
+                            ops.bind(sz, bound, STRENGTH_WEAK);
+                    } else if (iter_at_radius < need_to_explore) {
+                        // It's legal, but we haven't tried enough locations yet
+                        ops.unbind(sz);
+                        if (bound != nullptr)
+                            ops.bind(sz, bound, STRENGTH_WEAK);
+                        int input_len = 0;
+                        // Compute a fast input wirelength metric at this bel; and save if better than our last
+                        // try
+                        for (auto &port : ci->ports) {
+                            auto &p = port.second;
+                            if (p.type != PORT_IN || p.net == nullptr || p.net->driver.cell == nullptr)
+                                continue;
+                            CellInfo *drv = p.net->driver.cell;
+                            auto drv_loc = cell_locs.find(drv->name);
+                            if (drv_loc == cell_locs.end())
+                                continue;
+                            if (drv_loc->second.global)
+                                continue;
+                            input_len += std::abs(drv_loc->second.x - nx) + std::abs(drv_loc->second.y - ny);
                         }
-                        // Actually perform the move; keeping track of the moves we make so we can revert them if needed
-                        for (auto &target : targets) {
-                            CellInfo *bound = ctx->getBoundBelCell(target.second);
-                            if (bound != nullptr)
-                                ctx->unbindBel(target.second);
-                            ctx->bindBel(target.second, target.first, STRENGTH_STRONG);
-                            swaps_made.emplace_back(target.second, bound);
+                        if (input_len < best_inp_len) {
+                            best_inp_len = input_len;
+                            bestBel = sz;
                         }
-                        // Check that the move we have made is legal
-                        for (auto &sm : swaps_made) {
-                            if (!ctx->isBelLocationValid(sm.first))
+                        break;
+                    } else {
+                        // It's legal, and we've tried enough. Finish.
+                        if (bound != nullptr)
+                            ops.ripped_up(bound);
+                        ops.placed(ci, ops.location(sz));
+                        return true;
+                    }
+                }
+            } else {
+                // We do have relative constraints
+                for (auto sz : fb->at(nx).at(ny)) {
+                    // List of cells and their destination
+                    std::vector<std::pair<CellInfo *, BelId>> targets;
+                    // List of bels we placed things at; and the cell that was there before if applicable
+                    std::vector<std::pair<BelId, CellInfo *>> swaps_made;
+
+                    if (!ops.cluster_placement(ci->cluster, sz, targets))
+                        continue;
+
+                    for (auto &target : targets) {
+                        // Check it satisfies the region constraint if applicable
+                        if (!ops.test_region(target.first, target.second))
+                            goto fail;
+                        bool avail;
+                        CellInfo *bound = ops.bound_cell(target.second, avail);
+                        // Chains cannot overlap; so if we have to ripup a cell make sure it isn't part of a chain
+                        if (bound != nullptr)
+                            if (bound->cluster != ClusterId() || bound->belStrength > STRENGTH_WEAK)
                                 goto fail;
-                        }
+                    }
+                    // Actually perform the move; keeping track of the moves we make so we can revert them if needed
+                    for (auto &target : targets) {
+                        bool avail;
+                        CellInfo *bound = ops.bound_cell(target.second, avail);
+                        if (bound != nullptr)
+                            ops.unbind(target.second);
+                        ops.bind(target.second, target.first, STRENGTH_STRONG);
+                        swaps_made.emplace_back(target.second, bound);
+                    }
+                    // Check that the move we have made is legal
+                    for (auto &sm : swaps_made) {
+                        if (!ops.location_valid(sm.first))
+                            goto fail;
+                    }
 
-                        if (false) {
-                        fail:
-                            // If the move turned out to be illegal; revert all the moves we made
-                            for (auto &swap : swaps_made) {
-                                ctx->unbindBel(swap.first);
-                                if (swap.second != nullptr)
-                                    ctx->bindBel(swap.first, swap.second, STRENGTH_WEAK);
-                            }
-                            continue;
-                        }
-                        for (auto &target : targets) {
-                            Loc loc = ctx->getBelLocation(target.second);
-                            cell_locs[target.first->name].x = loc.x;
-                            cell_locs[target.first->name].y = loc.y;
-                            // log_info("%s %d %d %d\n", target.first->name.c_str(ctx), loc.x, loc.y, loc.z);
-                        }
+                    if (false) {
+                    fail:
+                        // If the move turned out to be illegal; revert all the moves we made
                         for (auto &swap : swaps_made) {
-                            // Where we have ripped up cells; add them to the queue
+                            ops.unbind(swap.first);
                             if (swap.second != nullptr)
-                                remaining.emplace(chain_size[swap.second->name], swap.second->name);
+                                ops.bind(swap.first, swap.second, STRENGTH_WEAK);
                         }
-
-                        placed = true;
-                        break;
+                        continue;
                     }
+                    for (auto &target : targets) {
+                        ops.placed(target.first, ops.location(target.second));
+                        // log_info("%s %d %d %d\n", target.first->name.c_str(ctx), loc.x, loc.y, loc.z);
+                    }
+                    for (auto &swap : swaps_made) {
+                        // Where we have ripped up cells; add them to the queue
+                        if (swap.second != nullptr)
+                            ops.ripped_up(swap.second);
+                    }
+
+                    return true;
                 }
+            }
+
+            total_iters_for_cell++;
+        }
+    }
 
-                total_iters_for_cell++;
+    // A tile region for the parallel strict legaliser
+    struct LegaliseRegion
+    {
+        int x0, y0, x1, y1;
+        DeterministicRNG rng;
+        // Cells whose solver location is in the region, with their chain size
+        std::vector<std::pair<int, IdString>> cells;
+        // Cells that couldn't be placed in the region, left for the serial legaliser
+        std::vector<CellInfo *> deferred;
+        // New cell locations, applied to cell_locs once all regions are done so that no region sees another's
+        std::vector<std::pair<IdString, Loc>> moved;
+    };
+
+    // Legalise the unplaced cells without macros by the region of their solver location, binding them only to bels in
+    // that region. The regions are done in four passes so that no two regions being legalised at once are adjacent;
+    // each has its own RNG, so the result doesn't depend on the number of threads.
+    void legalise_regions(bool require_validity, std::vector<CellInfo *> &deferred)
+    {
+        const int legalise_region_size = cfg.legaliseRegionSize;
+        int nx = (max_x + legalise_region_size) / legalise_region_size;
+        int ny = (max_y + legalise_region_size) / legalise_region_size;
+        std::vector<LegaliseRegion> regions(nx * ny);
+        for (int ry = 0; ry < ny; ry++)
+            for (int rx = 0; rx < nx; rx++) {
+                auto &r = regions.at(ry * nx + rx);
+                r.x0 = rx * legalise_region_size;
+                r.y0 = ry * legalise_region_size;
+                r.x1 = std::min(max_x, r.x0 + legalise_region_size - 1);
+                r.y1 = std::min(max_y, r.y0 + legalise_region_size - 1);
+                r.rng.rngseed(ctx->rng64());
             }
+        for (auto cell : solve_cells) {
+            if (cell->bel != BelId())
+                continue;
+            if (cell->cluster != ClusterId() || cell->region != nullptr) {
+                deferred.push_back(cell);
+                continue;
+            }
+            auto &loc = cell_locs.at(cell->name);
+            int rx = std::min(nx - 1, std::max(0, loc.x / legalise_region_size));
+            int ry = std::min(ny - 1, std::max(0, loc.y / legalise_region_size));
+            regions.at(ry * nx + rx).cells.emplace_back(chain_size[cell->name], cell->name);
+        }
+        std::vector<int> pass_regions;
+        for (int pass = 0; pass < 4; pass++) {
+            pass_regions.clear();
+            for (int ry = (pass >> 1); ry < ny; ry += 2)
+                for (int rx = (pass & 1); rx < nx; rx += 2)
+                    if (!regions.at(ry * nx + rx).cells.empty())
+                        pass_regions.push_back(ry * nx + rx);
+            legalise_pool->run(int(pass_regions.size()), [&](int i) {
+                legalise_region(regions.at(pass_regions.at(i)), require_validity);
+            });
+        }
+
+        for (auto &r : regions) {
+            for (auto &m : r.moved) {
+                auto &cl = cell_locs.at(m.first);
+                cl.x = m.second.x;
+                cl.y = m.second.y;
+            }
+            for (auto cell : r.deferred)
+                deferred.push_back(cell);
+        }
+    }
+
+    // The strict legaliser restricted to the bels of one region, running alongside other non-adjacent regions. Arch
+    // API calls are guarded by archapi_mutex; cells it can't place within a bounded number of attempts are deferred.
+    void legalise_region(LegaliseRegion &r, bool require_validity)
+    {
+        std::priority_queue<std::pair<int, IdString>> remaining;
+        for (auto &c : r.cells)
+            remaining.push(c);
+        const int ripup_radius = 2;
+        const int max_radius = std::max(r.x1 - r.x0, r.y1 - r.y0);
+        const int max_attempts = 20 * (max_radius + 1) * (max_radius + 1);
+        // Stop ripping up once the region is thrashing, and leave what's left to the serial legaliser
+        int ripups_left = 4 * int(r.cells.size()) + 16;
+
+        LegaliseOps ops;
+        ops.bound_cell = [&](BelId bel, bool &avail) {
+#if !defined(NPNR_DISABLE_THREADS)
+            std::shared_lock<std::shared_timed_mutex> l(archapi_mutex);
+#endif
+            avail = ctx->checkBelAvail(bel);
+            return ctx->getBoundBelCell(bel);
+        };
+        ops.bind = [&](BelId bel, CellInfo *cell, PlaceStrength strength) {
+#if !defined(NPNR_DISABLE_THREADS)
+            std::unique_lock<std::shared_timed_mutex> l(archapi_mutex);
+#endif
+            ctx->bindBel(bel, cell, strength);
+        };
+        ops.unbind = [&](BelId bel) {
+#if !defined(NPNR_DISABLE_THREADS)
+            std::unique_lock<std::shared_timed_mutex> l(archapi_mutex);
+#endif
+            ctx->unbindBel(bel);
+        };
+        ops.location_valid = [&](BelId bel) {
+#if !defined(NPNR_DISABLE_THREADS)
+            std::shared_lock<std::shared_timed_mutex> l(archapi_mutex);
+#endif
+            return ctx->isBelLocationValid(bel);
+        };
+        ops.location = [&](BelId bel) {
+#if !defined(NPNR_DISABLE_THREADS)
+            std::shared_lock<std::shared_timed_mutex> l(archapi_mutex);
+#endif
+            return ctx->getBelLocation(bel);
+        };
+        ops.cluster_placement = [&](ClusterId cluster, BelId root_bel,
+                                    std::vector<std::pair<CellInfo *, BelId>> &placement) {
+#if !defined(NPNR_DISABLE_THREADS)
+            std::shared_lock<std::shared_timed_mutex> l(archapi_mutex);
+#endif
+            return ctx->getClusterPlacement(cluster, root_bel, placement);
+        };
+        ops.test_region = [&](CellInfo *cell, BelId bel) {
+#if !defined(NPNR_DISABLE_THREADS)
+            std::shared_lock<std::shared_timed_mutex> l(archapi_mutex);
+#endif
+            return cell->testRegion(bel);
+        };
+        ops.may_ripup = [&]() { return ripups_left > 0; };
+        ops.ripped_up = [&](CellInfo *cell) {
+            --ripups_left;
+            auto fnd = chain_size.find(cell->name);
+            remaining.emplace(fnd == chain_size.end() ? 0 : fnd->second, cell->name);
+        };
+        ops.placed = [&](CellInfo *cell, Loc loc) { r.moved.emplace_back(cell->name, loc); };
+
+        while (!remaining.empty()) {
+            CellInfo *ci = ctx->cells.at(remaining.top().second).get();
+            remaining.pop();
+            if (ci->bel != BelId())
+                continue;
+            // Only tiles with bels for the cell count as attempts, so defer cells with none in the region at all
+            FastBels::FastBelsData *fb;
+            fast_bels.getBelsForCellType(ci->type, &fb);
+            bool have_bels = false;
+            for (int x = r.x0; x <= std::min(r.x1, int(fb->size()) - 1) && !have_bels; x++)
+                for (int y = r.y0; y <= std::min(r.y1, int(fb->at(x).size()) - 1) && !have_bels; y++)
+                    have_bels = !fb->at(x).at(y).empty();
+            int attempts = 0;
+            if (!have_bels || !legalise_cell(ci, r.x0, r.y0, r.x1, r.y1, r.rng, ops, ripup_radius, max_attempts,
+                                             require_validity, attempts))
+                r.deferred.push_back(ci);
         }
-        auto endt = std::chrono::high_resolution_clock::now();
-        sl_time += std::chrono::duration<float>(endt - startt).count();
     }
     // Implementation of the cut-based spreading as described in the HeAP/SimPL papers
 
@@ -1830,10 +2221,14 @@ PlacerHeapCfg::PlacerHeapCfg(Context *ctx)
     criticalityExponent = ctx->setting<int>("placerHeap/criticalityExponent");
     timingWeight = ctx->setting<int>("placerHeap/timingWeight");
     parallelRefine = ctx->setting<bool>("placerHeap/parallelRefine", false);
+    parallelLegalise = ctx->setting<bool>("placerHeap/parallelLegalise", false);
+    legaliseRegionSize = std::max(1, ctx->setting<int>("placerHeap/legaliseRegionSize", 16));
     netShareWeight = ctx->setting<float>("placerHeap/netShareWeight", 0);
 
     timing_driven = ctx->setting<bool>("timing_driven");
     solverTolerance = 1e-5;
+    parallelSolver = ctx->setting<bool>("placerHeap/parallelSolver", false);
+    solverThreads = ctx->setting<int>("threads", 8);
     placeAllAtOnce = false;
 
     int timeout_divisor = ctx->setting<int>("placerHeap/cellPlacementTimeout", 8);
@@ -40,9 +40,15 @@ struct PlacerHeapCfg
     float timingWeight;
     bool timing_driven;
     float solverTolerance;
+    // Use the built-in multithreaded CG solver rather than Eigen's; off by default, as it changes placement results
+    bool parallelSolver;
+    int solverThreads;
     bool placeAllAtOnce;
     float netShareWeight;
     bool parallelRefine;
+    // Legalise cells without macros by region, in parallel, with regions of this many tiles square
+    bool parallelLegalise;
+    int legaliseRegionSize;
     int cell_placement_timeout;
 
     int hpwl_scale_x, hpwl_scale_y;
@@ -35,6 +35,7 @@
 #include "place_common.h"
 #include "placer1.h"
 #include "scope_lock.h"
+#include "thread_pool.h"
 #include "timing.h"
 #include "util.h"
 
@@ -42,10 +43,6 @@
 
 #ifndef NPNR_DISABLE_THREADS
 #include <atomic>
-#include <condition_variable>
-#include <mutex>
-#include <thread>
-
 #endif
 
 NEXTPNR_NAMESPACE_BEGIN
@@ -67,24 +64,22 @@ struct PlacerGroup
 
     array2d<double> conc_density; // excludes fillers and dark nodes
     array2d<double> density;
-    // FFT related data (TODO: should these be per group?)
+    // FFT related data
     FFTArray density_fft;
     FFTArray electro_phi;
     FFTArray electro_fx, electro_fy;
 
     double init_potential = 0;
     double curr_potential = 0;
+
+    // MoveCells in this group
+    std::vector<int32_t> cells;
 };
 
 // Could be an actual concrete netlist cell; or just a spacer
 struct MoveCell
 {
     StaticRect rect;
-    // TODO: multiple contiguous vectors is probably faster than an array of structs, but also messier
-    RealPair pos, ref_pos, last_pos, last_ref_pos;
-    RealPair ref_wl_grad, wl_grad, last_wl_grad;
-    RealPair ref_dens_grad, dens_grad, last_dens_grad;
-    RealPair ref_total_grad, total_grad, last_total_grad;
     int32_t pin_count;
     int16_t group;
     int16_t bx, by; // bins
@@ -93,6 +88,25 @@ struct MoveCell
     bool is_dark : 1;
 };
 
+// Positions and gradients of all MoveCells, kept as one array per field (indexed like mcells) so that the
+// per-iteration kernels only stream through the fields they use
+struct MoveCellState
+{
+    std::vector<RealPair> pos, ref_pos, last_pos, last_ref_pos;
+    std::vector<RealPair> ref_wl_grad, wl_grad, last_wl_grad;
+    std::vector<RealPair> ref_dens_grad, dens_grad, last_dens_grad;
+    std::vector<RealPair> ref_total_grad, total_grad, last_total_grad;
+
+    void add(RealPair initial_pos)
+    {
+        for (auto field : {&pos, &ref_pos, &last_pos, &last_ref_pos, &ref_wl_grad, &wl_grad, &last_wl_grad,
+                           &ref_dens_grad, &dens_grad, &last_dens_grad, &ref_total_grad, &total_grad,
+                           &last_total_grad})
+            field->emplace_back();
+        pos.back() = initial_pos;
+    }
+};
+
 // Extra data for cells that aren't spacers
 struct ConcreteCell
 {
@@ -127,16 +141,20 @@ struct PlacerBin
     // ...
 };
 
-struct PlacerPort
+// Ports of all nets, stored contiguously net by net
+struct PlacerPorts
 {
     // for wirelength data
     static constexpr float invalid = std::numeric_limits<float>::lowest();
-
-    PortRef ref;
-    RealPair max_exp{invalid, invalid};
-    RealPair min_exp{invalid, invalid};
-    bool has_max_exp(Axis axis) const { return max_exp.at(axis) != invalid; }
-    bool has_min_exp(Axis axis) const { return min_exp.at(axis) != invalid; }
+    // cell values for ports whose cell isn't a MoveCell, and for unused user slots
+    static constexpr int32_t unmanaged = -1, empty = -2;
+
+    std::vector<PortRef> ref;
+    std::vector<int32_t> cell;
+    // per axis; location from the last bounds computation and weighted-average model exponents
+    std::vector<float> loc[2];
+    std::vector<float> max_exp[2];
+    std::vector<float> min_exp[2];
 };
 
 struct PlacerNet
@@ -147,97 +165,23 @@ struct PlacerNet
     RealPair min_exp, x_min_exp;
     RealPair max_exp, x_max_exp;
     RealPair wa_wl;
-    // lines up with user indexes; plus one for driver
-    std::vector<PlacerPort> ports;
+    // range in PlacerPorts; lines up with user indexes, plus one for driver
+    int32_t port_begin = 0, port_count = 0;
     int hpwl() { return (b1.x - b0.x) + (b1.y - b0.y); }
 };
 
-#ifdef NPNR_DISABLE_THREADS
-struct ThreadPool
+// Pins of the netlist cells managed by the placer on non-skipped nets, stored contiguously cell by cell
+struct PlacerPins
 {
-    ThreadPool(int) {};
-
-    void run(int N, std::function<void(int)> func)
-    {
-        for (int i = 0; i < N; i++)
-            func(i);
-    };
+    // per cell
+    std::vector<CellInfo *> cells;
+    std::vector<int32_t> pin_begin; // plus one at the end
+    std::vector<RealPair> wl_grad;
+    // per pin
+    std::vector<const PortInfo *> info;
+    std::vector<int32_t> net, port;
+    std::vector<float> weight; // timing weight
 };
-#else
-struct ThreadPool
-{
-    ThreadPool(int thread_count)
-    {
-        done.resize(thread_count, false);
-        for (int i = 0; i < thread_count; i++) {
-            threads.emplace_back([this, i]() { this->worker(i); });
-        }
-    }
-    std::vector<std::thread> threads;
-    std::condition_variable cv_start, cv_done;
-    std::mutex mutex;
-
-    bool work_available = false;
-    bool shutdown = false;
-    std::vector<bool> done;
-    std::function<void(int)> work;
-    int work_count;
-
-    ~ThreadPool()
-    {
-        {
-            std::lock_guard lk(mutex);
-            shutdown = true;
-        }
-        cv_start.notify_all();
-        for (auto &t : threads)
-            t.join();
-    }
-
-    void run(int N, std::function<void(int)> func)
-    {
-        {
-            std::lock_guard lk(mutex);
-            work = func;
-            work_count = N;
-            work_available = true;
-            std::fill(done.begin(), done.end(), false);
-        }
-        cv_start.notify_all();
-        {
-            std::unique_lock lk(mutex);
-            cv_done.wait(lk, [this] { return std::all_of(done.begin(), done.end(), [](bool x) { return x; }); });
-            work_available = false;
-        }
-    }
-
-    void worker(int idx)
-    {
-        while (true) {
-            std::unique_lock lk(mutex);
-            cv_start.wait(lk, [this, idx] { return (work_available && !done.at(idx)) || shutdown; });
-            if (shutdown) {
-                lk.unlock();
-                break;
-            } else if (work_available && !done.at(idx)) {
-                int work_per_thread = (work_count + int(threads.size()) - 1) / threads.size();
-                int begin = work_per_thread * idx;
-                int end = std::min(work_count, work_per_thread * (idx + 1));
-                lk.unlock();
-
-                for (int j = begin; j < end; j++) {
-                    work(j);
-                }
-
-                lk.lock();
-                done.at(idx) = true;
-                lk.unlock();
-                cv_done.notify_one();
-            }
-        }
-    }
-};
-#endif
 
 class StaticPlacer
 {
@@ -245,15 +189,19 @@ class StaticPlacer
     PlacerStaticCfg cfg;
 
     std::vector<MoveCell> mcells;
+    MoveCellState state;
     std::vector<ConcreteCell> ccells;
     std::vector<PlacerMacro> macros;
     std::vector<PlacerGroup> groups;
     std::vector<PlacerNet> nets;
+    PlacerPorts ports;
+    PlacerPins pins;
     idict<ClusterId> cluster2idx;
 
     FastBels fast_bels;
     TimingAnalyser tmg;
     ThreadPool pool;
+    int threads;
 
     int width, height;
     int iter = 0;
@@ -338,23 +286,61 @@ class StaticPlacer
 
             auto &nd = nets.back();
             nd.ni = ni;
-            nd.skip = (ni->driver.cell == nullptr);    // (or global buffer?)
-            nd.ports.resize(ni->users.capacity() + 1); // +1 for the driver
-            nd.ports.back().ref = ni->driver;
+            nd.skip = (ni->driver.cell == nullptr); // (or global buffer?)
+            nd.port_begin = ports.ref.size();
+            nd.port_count = ni->users.capacity() + 1; // +1 for the driver
+            ports.ref.resize(nd.port_begin + nd.port_count);
+            ports.ref.back() = ni->driver;
             for (auto usr : ni->users.enumerate()) {
-                nd.ports.at(usr.index.idx()).ref = usr.value;
+                ports.ref.at(nd.port_begin + usr.index.idx()) = usr.value;
             }
         }
+        ports.cell.reserve(ports.ref.size());
+        for (auto &ref : ports.ref) {
+            if (!ref.cell)
+                ports.cell.push_back(PlacerPorts::empty);
+            else
+                ports.cell.push_back(ref.cell->udata == -1 ? PlacerPorts::unmanaged : ref.cell->udata);
+        }
+        for (int axis = 0; axis < 2; axis++) {
+            ports.loc[axis].resize(ports.ref.size(), 0);
+            ports.min_exp[axis].resize(ports.ref.size(), PlacerPorts::invalid);
+            ports.max_exp[axis].resize(ports.ref.size(), PlacerPorts::invalid);
+        }
+        // Flatten the pins of the cells we compute wirelength gradients for
+        for (auto &cell : ctx->cells) {
+            CellInfo *ci = cell.second.get();
+            if (ci->udata == -1)
+                continue;
+            pins.cells.push_back(ci);
+            pins.pin_begin.push_back(pins.info.size());
+            for (auto &port : ci->ports) {
+                NetInfo *ni = port.second.net;
+                if (!ni)
+                    continue;
+                auto &nd = nets.at(ni->udata);
+                if (nd.skip)
+                    continue;
+                pins.info.push_back(&port.second);
+                pins.net.push_back(ni->udata);
+                pins.port.push_back(nd.port_begin +
+                                    (port.second.type == PORT_OUT ? (nd.port_count - 1) : port.second.user_idx.idx()));
+                pins.weight.push_back(1.0f);
+            }
+        }
+        pins.pin_begin.push_back(pins.info.size());
+        pins.wl_grad.resize(pins.cells.size());
     }
 
     int add_cell(StaticRect rect, int group, RealPair pos, CellInfo *ci = nullptr)
     {
         int idx = mcells.size();
         mcells.emplace_back();
+        state.add(pos);
+        groups.at(group).cells.push_back(idx);
         auto &m = mcells.back();
         m.rect = rect;
         m.group = group;
-        m.pos = pos;
         if (ci) {
             // Is a concrete cell (might be a macro, in which case ci is just one of them...)
             // Can't add concrete cells once we have spacers (we define it such that indices line up between mcells and
@@ -399,7 +385,7 @@ class StaticPlacer
                                     .c_str()); // already fixed
             return RealPair(ctx->getBelLocation(ci->bel), 0.5f);
         } else {
-            return ref ? mcells.at(ci->udata).ref_pos : mcells.at(ci->udata).pos;
+            return ref ? state.ref_pos.at(ci->udata) : state.pos.at(ci->udata);
         }
     }
 
@@ -448,9 +434,7 @@ class StaticPlacer
                 if (ci->bel != BelId()) {
                     // Currently; treat all ready-placed cells as fixed (eventually we might do incremental ripups
                     // here...)
-                    Loc loc = ctx->getBelLocation(ci->bel);
-                    mc.pos.x = loc.x + 0.5;
-                    mc.pos.y = loc.y + 0.5;
+                    state.pos.at(idx) = RealPair(ctx->getBelLocation(ci->bel), 0.5);
                     mc.is_fixed = true;
                 }
             }
@@ -494,9 +478,7 @@ class StaticPlacer
                     if (kv.second.front()->bel != BelId()) {
                         // Currently; treat all ready-placed cells as fixed (eventually we might do incremental ripups
                         // here...)
-                        Loc loc = ctx->getBelLocation(kv.second.front()->bel);
-                        mc.pos.x = loc.x + 0.5;
-                        mc.pos.y = loc.y + 0.5;
+                        state.pos.at(idx) = RealPair(ctx->getBelLocation(kv.second.front()->bel), 0.5);
                         mc.is_fixed = true;
                     }
                     for (auto ci : kv.second) {
@@ -566,8 +548,12 @@ class StaticPlacer
     int m;
     double bin_w, bin_h;
 
+    // The cos/sin tables for the transforms, shared by all groups. They are filled in by prepare_density_bins, so the
+    // transforms only ever read them and can run concurrently
     std::vector<float> cs_table_fft;
     std::vector<int> work_area_fft;
+    // Scratch space for up to four columns, per slice of a column pass
+    std::vector<std::vector<float>> fft_scratch;
 
     void prepare_density_bins()
     {
@@ -587,9 +573,16 @@ class StaticPlacer
         cs_table_fft.resize(m * 3 / 2, 0);
         work_area_fft.resize(std::round(std::sqrt(m)) + 2, 0);
         work_area_fft.at(0) = 0;
+        // a throwaway transform of the full size fills in the tables, just as the first ddct2d would
+        std::vector<float> init_fft(m, 0);
+        ddct(m, -1, init_fft.data(), work_area_fft.data(), cs_table_fft.data());
+        fft_scratch.assign(threads, std::vector<float>(4 * m, 0));
     }
 
-    template <typename TFunc> void iter_slithers(RealPair pos, StaticRect rect, TFunc func)
+    // Only bin rows in [y_begin, y_end) are visited
+    template <typename TFunc>
+    void iter_slithers(RealPair pos, StaticRect rect, TFunc func, int y_begin = 0,
+                       int y_end = std::numeric_limits<int>::max())
     {
         // compute the stamp over bins (this could probably be more efficient?)
 
@@ -606,7 +599,7 @@ class StaticPlacer
 
         double x0 = pos.x, x1 = pos.x + width;
         double y0 = pos.y, y1 = pos.y + height;
-        for (int y = int(y0 / bin_h); y <= int(y1 / bin_h); y++) {
+        for (int y = std::max(int(y0 / bin_h), y_begin); y <= std::min(int(y1 / bin_h), y_end - 1); y++) {
             for (int x = int(x0 / bin_w); x <= int(x1 / bin_w); x++) {
                 if (x < 0 || x >= m || y < 0 || y >= m)
                     continue;
@@ -624,23 +617,40 @@ class StaticPlacer
         }
     };
 
+    // Run func(i) for every MoveCell index, in fixed size chunks spread over the thread pool
+    template <typename TFunc> void for_each_mcell(TFunc func)
+    {
+        const int chunk_size = 1024;
+        const int n = int(mcells.size());
+        pool.run((n + chunk_size - 1) / chunk_size, [&](int chunk) {
+            for (int i = chunk * chunk_size; i < std::min(n, (chunk + 1) * chunk_size); i++)
+                func(i);
+        });
+    }
+
     void compute_density(int group, bool ref)
     {
         auto &g = groups.at(group);
-        // reset
-        for (auto entry : g.density)
-            entry.value = 0;
-        // populate
-        for (int idx = 0; idx < int(mcells.size()); idx++) {
-            auto &mc = mcells.at(idx);
-            if (mc.group != group)
-                continue;
-            // scale width and height to be at least one bin (local density smoothing from the eplace paper)
-            // TODO: should we really do this every iteration?
-
-            auto pos = ref ? mc.ref_pos : mc.pos;
-            iter_slithers(pos, mc.rect, [&](int x, int y, float area) { g.density.at(x, y) += area; });
-        }
+        const auto &cell_pos = ref ? state.ref_pos : state.pos;
+        // Each task owns a band of bin rows, so tasks never write the same bin and each bin still sums its cells in
+        // index order
+        const int bands = std::min(m, threads);
+        const int band_rows = (m + bands - 1) / bands;
+        pool.run(bands, [&](int band) {
+            int y_begin = band * band_rows, y_end = std::min(m, (band + 1) * band_rows);
+            // reset
+            for (int y = y_begin; y < y_end; y++)
+                for (int x = 0; x < m; x++)
+                    g.density.at(x, y) = 0;
+            // populate
+            for (int32_t idx : g.cells) {
+                // scale width and height to be at least one bin (local density smoothing from the eplace paper)
+                // TODO: should we really do this every iteration?
+                iter_slithers(
+                        cell_pos[idx], mcells[idx].rect,
+                        [&](int x, int y, float area) { g.density.at(x, y) += area; }, y_begin, y_end);
+            }
+        });
     }
 
     void compute_conc_density()
@@ -650,7 +660,7 @@ class StaticPlacer
         for (int idx = 0; idx < int(ccells.size()); idx++) {
             auto &mc = mcells.at(idx);
             auto &g = groups.at(mc.group);
-            auto loc = mc.pos;
+            auto loc = state.pos.at(idx);
             auto size = mc.rect;
 
             for (int dy = 0; dy <= int(size.h); dy++) {
@@ -689,28 +699,83 @@ class StaticPlacer
         log_info("overlap: %s\n", overlap_str.c_str());
     }
 
-    void run_fft(int group)
+    // A separable 2D transform of one array, with a DCT or (for a derivative) a DST along each axis
+    struct FFTJob
     {
+        FFTArray *array;
+        int isgn;
+        bool sin_x, sin_y;
+    };
+
+    // The 2D transforms of several arrays at once; equivalent to ddct2d, or ddsct2d with sin_x, or ddcst2d with
+    // sin_y, on each. The 1D transforms along y of every array, and then those along x, are spread over the thread
+    // pool.
+    void run_fft_jobs(const std::vector<FFTJob> &jobs)
+    {
+        auto transform = [&](bool sin, int isgn, float *a) {
+            if (sin)
+                ddst(m, isgn, a, work_area_fft.data(), cs_table_fft.data());
+            else
+                ddct(m, isgn, a, work_area_fft.data(), cs_table_fft.data());
+        };
+        // along y, where each x is contiguous
+        pool.run(int(jobs.size()) * m, [&](int i) {
+            const auto &job = jobs.at(i / m);
+            transform(job.sin_y, job.isgn, job.array->data()[i % m]);
+        });
+        // along x, gathering four columns at a time into the slice's scratch space
+        const int job_blocks = (m + 3) / 4;
+        const int blocks = int(jobs.size()) * job_blocks;
+        const int slices = std::min(blocks, threads);
+        pool.run(slices, [&](int slice) {
+            float *t = fft_scratch.at(slice).data();
+            for (int b = (slice * blocks) / slices; b < ((slice + 1) * blocks) / slices; b++) {
+                const auto &job = jobs.at(b / job_blocks);
+                float **a = job.array->data();
+                const int y0 = (b % job_blocks) * 4, ny = std::min(4, m - y0);
+                for (int x = 0; x < m; x++)
+                    for (int k = 0; k < ny; k++)
+                        t[k * m + x] = a[x][y0 + k];
+                for (int k = 0; k < ny; k++)
+                    transform(job.sin_x, job.isgn, t + k * m);
+                for (int x = 0; x < m; x++)
+                    for (int k = 0; k < ny; k++)
+                        a[x][y0 + k] = t[k * m + x];
+            }
+        });
+    }
+
+    // Compute the potential and field of every group from its density
+    void run_fft()
+    {
+        const int n_groups = int(groups.size());
         // get data into form that fft wants
-        auto &g = groups.at(group);
-        for (auto entry : g.density)
-            g.density_fft.at(entry.x, entry.y) = entry.value;
+        pool.run(n_groups, [&](int group) {
+            auto &g = groups.at(group);
+            for (auto entry : g.density)
+                g.density_fft.at(entry.x, entry.y) = entry.value;
+        });
         if (fft_debug || dump_density)
-            g.density_fft.write_csv(stringf("out_bin_density_%d_%d.csv", iter, group));
+            for (int group = 0; group < n_groups; group++)
+                groups.at(group).density_fft.write_csv(stringf("out_bin_density_%d_%d.csv", iter, group));
         // Based on
         // https://github.com/ALIGN-analoglayout/ALIGN-public/blob/master/PlaceRouteHierFlow/EA_placer/FFT/fft.cpp
         // initial DCT for coefficients
-        ddct2d(m, m, -1, g.density_fft.data(), nullptr, work_area_fft.data(), cs_table_fft.data());
-        // postprocess coefficients
-        for (int x = 0; x < m; x++)
+        std::vector<FFTJob> jobs;
+        for (auto &g : groups)
+            jobs.push_back(FFTJob{&g.density_fft, -1, false, false});
+        run_fft_jobs(jobs);
+        pool.run(n_groups * m, [&](int i) {
+            auto &g = groups.at(i / m);
+            const int x = i % m;
+            // postprocess coefficients
             g.density_fft.at(x, 0) *= 0.5f;
-        for (int y = 0; y < m; y++)
-            g.density_fft.at(0, y) *= 0.5f;
-        for (int x = 0; x < m; x++)
+            if (x == 0)
+                for (int y = 0; y < m; y++)
+                    g.density_fft.at(0, y) *= 0.5f;
             for (int y = 0; y < m; y++)
                 g.density_fft.at(x, y) *= (4.0f / (m * m));
-        // scale inputs to IDCT for potentials and field
-        for (int x = 0; x < m; x++) {
+            // scale inputs to IDCT for potentials and field
             float wx = pi * (x / float(m));
             float wx2 = wx * wx;
             for (int y = 0; y < m; y++) {
@@ -730,30 +795,49 @@ class StaticPlacer
                 g.electro_fx.at(x, y) = ex;
                 g.electro_fy.at(x, y) = ey;
             }
-        }
+        });
         // IDCT for potential; 2D derivatives for field
-        ddct2d(m, m, 1, g.electro_phi.data(), nullptr, work_area_fft.data(), cs_table_fft.data());
-        ddsct2d(m, m, 1, g.electro_fx.data(), nullptr, work_area_fft.data(), cs_table_fft.data());
-        ddcst2d(m, m, 1, g.electro_fy.data(), nullptr, work_area_fft.data(), cs_table_fft.data());
+        jobs.clear();
+        for (auto &g : groups) {
+            jobs.push_back(FFTJob{&g.electro_phi, 1, false, false});
+            jobs.push_back(FFTJob{&g.electro_fx, 1, true, false});
+            jobs.push_back(FFTJob{&g.electro_fy, 1, false, true});
+        }
+        run_fft_jobs(jobs);
         if (fft_debug) {
-            g.electro_phi.write_csv(stringf("out_bin_phi_%d_%d.csv", iter, group));
-            g.electro_fx.write_csv(stringf("out_bin_ex_%d_%d.csv", iter, group));
-            g.electro_fy.write_csv(stringf("out_bin_ey_%d_%d.csv", iter, group));
+            for (int group = 0; group < n_groups; group++) {
+                auto &g = groups.at(group);
+                g.electro_phi.write_csv(stringf("out_bin_phi_%d_%d.csv", iter, group));
+                g.electro_fx.write_csv(stringf("out_bin_ex_%d_%d.csv", iter, group));
+                g.electro_fy.write_csv(stringf("out_bin_ey_%d_%d.csv", iter, group));
+            }
         }
     }
 
+    // Gather the locations of a net's ports into ports.loc, and update its bounding box from them
     void compute_bounds(PlacerNet &net, Axis axis, bool ref)
     {
-        NetInfo *ni = net.ni;
-        auto drv_loc = cell_loc(ni->driver.cell, ref);
-        // seed with driver location
-        net.b1.at(axis) = net.b0.at(axis) = drv_loc.at(axis);
-        // iterate over users
-        for (auto &usr : ni->users) {
-            auto usr_loc = cell_loc(usr.cell, ref);
-            net.b1.at(axis) = std::max(net.b1.at(axis), usr_loc.at(axis));
-            net.b0.at(axis) = std::min(net.b0.at(axis), usr_loc.at(axis));
+        const auto &cell_pos = ref ? state.ref_pos : state.pos;
+        const int32_t *port_cell = ports.cell.data() + net.port_begin;
+        const PortRef *port_ref = ports.ref.data() + net.port_begin;
+        float *loc = ports.loc[int(axis)].data() + net.port_begin;
+        const int n = net.port_count;
+        // driver is the last port; unused user slots take its location so they don't affect the bounds
+        for (int j = n - 1; j >= 0; j--) {
+            if (port_cell[j] >= 0)
+                loc[j] = cell_pos[port_cell[j]].at(axis);
+            else if (port_cell[j] == PlacerPorts::unmanaged)
+                loc[j] = cell_loc(port_ref[j].cell, ref).at(axis);
+            else
+                loc[j] = loc[n - 1];
+        }
+        float b0 = loc[n - 1], b1 = loc[n - 1];
+        for (int j = 0; j < n; j++) {
+            b0 = std::min(b0, loc[j]);
+            b1 = std::max(b1, loc[j]);
         }
+        net.b0.at(axis) = b0;
+        net.b1.at(axis) = b1;
     }
 
     RealPair wl_coeff{0.5f, 0.5f};
@@ -766,89 +850,90 @@ class StaticPlacer
             auto axis = (i % 2) ? Axis::Y : Axis::X;
             if (net.skip)
                 return;
-            net.min_exp.at(axis) = 0;
-            net.x_min_exp.at(axis) = 0;
-            net.max_exp.at(axis) = 0;
-            net.x_max_exp.at(axis) = 0;
             // update bounding box
             compute_bounds(net, axis, ref);
+            const int32_t *port_cell = ports.cell.data() + net.port_begin;
+            const float *loc = ports.loc[int(axis)].data() + net.port_begin;
+            float *min_exp = ports.min_exp[int(axis)].data() + net.port_begin;
+            float *max_exp = ports.max_exp[int(axis)].data() + net.port_begin;
+            const float coeff = wl_coeff.at(axis);
             // compute rough center to subtract from exponents to avoid FP issues (from replace)
             float c = (net.b1.at(axis) + net.b0.at(axis)) / 2.f;
-            for (auto &port : net.ports) {
-                if (!port.ref.cell)
-                    continue;
-                RealPair loc = cell_loc(port.ref.cell, ref);
-                // update weighted-average model exponents
-                float emin = (c - loc.at(axis)) * wl_coeff.at(axis);
-                float emax = (loc.at(axis) - c) * wl_coeff.at(axis);
-
-                if (emin > min_wirelen_force) {
-                    port.min_exp.at(axis) = std::exp(emin);
-                    net.min_exp.at(axis) += port.min_exp.at(axis);
-                    net.x_min_exp.at(axis) += loc.at(axis) * port.min_exp.at(axis);
-                } else {
-                    port.min_exp.at(axis) = PlacerPort::invalid;
+            // update weighted-average model exponents
+            for (int j = 0; j < net.port_count; j++) {
+                float emin = (c - loc[j]) * coeff;
+                float emax = (loc[j] - c) * coeff;
+                bool used = port_cell[j] != PlacerPorts::empty;
+                min_exp[j] = (used && emin > min_wirelen_force) ? std::exp(emin) : PlacerPorts::invalid;
+                max_exp[j] = (used && emax > min_wirelen_force) ? std::exp(emax) : PlacerPorts::invalid;
+            }
+            float min_sum = 0, x_min_sum = 0, max_sum = 0, x_max_sum = 0;
+            for (int j = 0; j < net.port_count; j++) {
+                if (min_exp[j] != PlacerPorts::invalid) {
+                    min_sum += min_exp[j];
+                    x_min_sum += loc[j] * min_exp[j];
                 }
-                if (emax > min_wirelen_force) {
-                    port.max_exp.at(axis) = std::exp(emax);
-                    net.max_exp.at(axis) += port.max_exp.at(axis);
-                    net.x_max_exp.at(axis) += loc.at(axis) * port.max_exp.at(axis);
-                } else {
-                    port.max_exp.at(axis) = PlacerPort::invalid;
+                if (max_exp[j] != PlacerPorts::invalid) {
+                    max_sum += max_exp[j];
+                    x_max_sum += loc[j] * max_exp[j];
                 }
             }
-            net.wa_wl.at(axis) =
-                    (net.x_max_exp.at(axis) / net.max_exp.at(axis)) - (net.x_min_exp.at(axis) / net.min_exp.at(axis));
+            net.min_exp.at(axis) = min_sum;
+            net.x_min_exp.at(axis) = x_min_sum;
+            net.max_exp.at(axis) = max_sum;
+            net.x_max_exp.at(axis) = x_max_sum;
+            net.wa_wl.at(axis) = (x_max_sum / max_sum) - (x_min_sum / min_sum);
         });
     }
 
-    std::vector<std::pair<CellInfo *, RealPair>> gathered_wirelen_grad;
-
-    float wirelen_grad(CellInfo *cell, Axis axis, bool ref)
+    // Wirelength gradient for a cell in PlacerPins
+    float wirelen_grad(int cell, Axis axis, bool ref)
     {
         float gradient = 0;
-        if (cell->udata == -1)
-            return 0;
-        RealPair loc = cell_loc(cell, ref);
-        for (auto &port : cell->ports) {
-            NetInfo *ni = port.second.net;
-            if (!ni)
-                continue;
-            auto &nd = nets.at(ni->udata);
-            if (nd.skip)
-                continue;
-            auto &pd = nd.ports.at(port.second.type == PORT_OUT ? (nd.ports.size() - 1) : port.second.user_idx.idx());
+        const float coeff = wl_coeff.at(axis);
+        float loc = (ref ? state.ref_pos : state.pos).at(pins.cells.at(cell)->udata).at(axis);
+        for (int pin = pins.pin_begin.at(cell); pin < pins.pin_begin.at(cell + 1); pin++) {
+            const auto &nd = nets[pins.net[pin]];
+            float min_exp = ports.min_exp[int(axis)][pins.port[pin]];
+            float max_exp = ports.max_exp[int(axis)][pins.port[pin]];
             // From Replace
             // TODO: check these derivatives on paper
             double d_min = 0, d_max = 0;
-            if (pd.has_min_exp(axis)) {
+            if (min_exp != PlacerPorts::invalid) {
                 double min_sum = nd.min_exp.at(axis), x_min_sum = nd.x_min_exp.at(axis);
-                d_min = (min_sum * (pd.min_exp.at(axis) * (1.0f - wl_coeff.at(axis) * loc.at(axis))) +
-                         wl_coeff.at(axis) * pd.min_exp.at(axis) * x_min_sum) /
+                d_min = (min_sum * (min_exp * (1.0f - coeff * loc)) + coeff * min_exp * x_min_sum) /
                         (min_sum * min_sum);
             }
-            if (pd.has_max_exp(axis)) {
+            if (max_exp != PlacerPorts::invalid) {
                 double max_sum = nd.max_exp.at(axis), x_max_sum = nd.x_max_exp.at(axis);
-                d_max = (max_sum * (pd.max_exp.at(axis) * (1.0f + wl_coeff.at(axis) * loc.at(axis))) -
-                         wl_coeff.at(axis) * pd.max_exp.at(axis) * x_max_sum) /
+                d_max = (max_sum * (max_exp * (1.0f + coeff * loc)) - coeff * max_exp * x_max_sum) /
                         (max_sum * max_sum);
             }
-            float crit = 0.0;
-            if (cfg.timing_driven) {
-                if (port.second.type == PORT_IN) {
-                    crit = tmg.get_criticality(CellPortKey(cell->name, port.first));
-                } else if (port.second.type == PORT_OUT) {
-                    if (ni && ni->users.entries() < 5) {
-                        for (auto usr : ni->users)
+            gradient += pins.weight[pin] * (d_min - d_max);
+        }
+
+        return gradient;
+    }
+
+    // Timing weights only change when the timing analysis is rerun, so are computed once here for all pins
+    void update_pin_weights()
+    {
+        for (int cell = 0; cell < int(pins.cells.size()); cell++) {
+            CellInfo *ci = pins.cells.at(cell);
+            for (int pin = pins.pin_begin.at(cell); pin < pins.pin_begin.at(cell + 1); pin++) {
+                const PortInfo &port = *pins.info.at(pin);
+                float crit = 0.0;
+                if (port.type == PORT_IN) {
+                    crit = tmg.get_criticality(CellPortKey(ci->name, port.name));
+                } else if (port.type == PORT_OUT) {
+                    if (port.net->users.entries() < 5) {
+                        for (auto usr : port.net->users)
                             crit = std::max(crit, tmg.get_criticality(CellPortKey(usr)));
                     }
                 }
+                pins.weight.at(pin) = 1.0 + 5 * std::pow(crit, 2);
             }
-            float weight = 1.0 + 5 * std::pow(crit, 2);
-            gradient += weight * (d_min - d_max);
         }
-
-        return gradient;
     }
 
     std::vector<float> dens_penalty;
@@ -856,59 +941,50 @@ class StaticPlacer
 
     void update_gradients(bool ref = true, bool set_prev = true, bool init_penalty = false)
     {
-        // TODO: skip non-group cells more efficiently?
-        pool.run(groups.size(), [&](int group) {
+        ProfileScope prof_scope(ctx->profiler, "static/gradients");
+        for (int group = 0; group < int(groups.size()); group++)
             compute_density(group, ref);
-            run_fft(group);
-        });
+        run_fft();
         update_nets(ref);
+        auto &wl_grad = ref ? state.ref_wl_grad : state.wl_grad;
+        auto &dens_grad = ref ? state.ref_dens_grad : state.dens_grad;
+        auto &total_grad = ref ? state.ref_total_grad : state.total_grad;
+        const auto &cell_pos = ref ? state.ref_pos : state.pos;
         // First loop: back up gradients if required; set to zero; and compute density gradient
-        for (auto &cell : mcells) {
+        for_each_mcell([&](int i) {
+            auto &cell = mcells[i];
             auto &g = groups.at(cell.group);
             if (set_prev && ref) {
-                cell.last_wl_grad = cell.ref_wl_grad;
-                cell.last_dens_grad = cell.ref_dens_grad;
-                cell.last_total_grad = cell.ref_total_grad;
+                state.last_wl_grad[i] = state.ref_wl_grad[i];
+                state.last_dens_grad[i] = state.ref_dens_grad[i];
+                state.last_total_grad[i] = state.ref_total_grad[i];
             }
             // wirelength gradient updated based on cell instances in next loop
-            (ref ? cell.ref_wl_grad : cell.wl_grad) = RealPair(0, 0);
+            wl_grad[i] = RealPair(0, 0);
             // density grad based on bins - do we need to interpolate?
-            auto &grad = (ref ? cell.ref_dens_grad : cell.dens_grad);
-            grad = RealPair(0, 0);
-            iter_slithers((ref ? cell.ref_pos : cell.pos), cell.rect, [&](int x, int y, float area) {
+            RealPair grad(0, 0);
+            iter_slithers(cell_pos[i], cell.rect, [&](int x, int y, float area) {
                 grad += RealPair(g.electro_fx.at(x, y) * area, g.electro_fy.at(x, y) * area);
             });
+            dens_grad[i] = grad;
             // total gradient computed at the end
-            (ref ? cell.ref_total_grad : cell.total_grad) = RealPair(0, 0);
-        }
-        if (gathered_wirelen_grad.empty()) {
-            for (auto &cell : ctx->cells) {
-                CellInfo *ci = cell.second.get();
-                if (ci->udata == -1)
-                    continue;
-                gathered_wirelen_grad.emplace_back(ci, RealPair());
-            }
-        }
+            total_grad[i] = RealPair(0, 0);
+        });
         // Compute wirelength gradients for cells in parallel, this is a slow part
-        pool.run(gathered_wirelen_grad.size(), [&](int i) {
-            auto &entry = gathered_wirelen_grad.at(i);
-            CellInfo *ci = entry.first;
-            float wl_gx = wirelen_grad(ci, Axis::X, ref);
-            float wl_gy = wirelen_grad(ci, Axis::Y, ref);
-            entry.second = RealPair(wl_gx, wl_gy);
+        pool.run(pins.cells.size(), [&](int i) {
+            float wl_gx = wirelen_grad(i, Axis::X, ref);
+            float wl_gy = wirelen_grad(i, Axis::Y, ref);
+            pins.wl_grad.at(i) = RealPair(wl_gx, wl_gy);
         });
         // Second loop: sum up wirelength gradients across concrete cell instances
-        for (auto entry : gathered_wirelen_grad) {
-            auto &mc = mcells.at(entry.first->udata);
-            (ref ? mc.ref_wl_grad : mc.wl_grad) += entry.second;
-        }
+        for (int i = 0; i < int(pins.cells.size()); i++)
+            wl_grad.at(pins.cells.at(i)->udata) += pins.wl_grad.at(i);
         if (init_penalty) {
             // set initial density penalty
             double wirelen_sum = 0, force_sum = 0;
             for (int i = 0; i < int(ccells.size()); i++) {
-                auto mc = mcells.at(i);
-                wirelen_sum += std::abs(mc.ref_wl_grad.x) + std::abs(mc.ref_wl_grad.y);
-                force_sum += std::abs(mc.ref_dens_grad.x) + std::abs(mc.ref_dens_grad.y);
+                wirelen_sum += std::abs(state.ref_wl_grad.at(i).x) + std::abs(state.ref_wl_grad.at(i).y);
+                force_sum += std::abs(state.ref_dens_grad.at(i).x) + std::abs(state.ref_dens_grad.at(i).y);
             }
             const float eta = 1e-1;
             float init_dens_penalty = eta * (wirelen_sum / force_sum);
@@ -918,24 +994,20 @@ class StaticPlacer
         }
         // Third loop: compute total gradient, and precondition
         // TODO: ALM as well as simple penalty
-        for (auto &cell : mcells) {
+        for_each_mcell([&](int i) {
+            auto &cell = mcells[i];
 #if 0
             if (!cell.is_spacer) {
-                printf("%d (%f, %f) wirelen_grad: (%f,%f) density_grad: (%f,%f)\n", iter, cell.ref_pos.x,
-                       cell.ref_pos.y, cell.ref_wl_grad.x, cell.ref_wl_grad.y, cell.ref_dens_grad.x,
-                       cell.ref_dens_grad.y);
+                printf("%d (%f, %f) wirelen_grad: (%f,%f) density_grad: (%f,%f)\n", iter, state.ref_pos[i].x,
+                       state.ref_pos[i].y, state.ref_wl_grad[i].x, state.ref_wl_grad[i].y, state.ref_dens_grad[i].x,
+                       state.ref_dens_grad[i].y);
             }
 #endif
             // Preconditioner from replace for now
 
             float precond = std::max(1.0f, float(cell.pin_count) + dens_penalty[cell.group] * cell.rect.area());
-            if (ref) {
-                cell.ref_total_grad =
-                        ((cell.ref_wl_grad * -1) - cell.ref_dens_grad * dens_penalty[cell.group]) / precond;
-            } else {
-                cell.total_grad = ((cell.wl_grad * -1) - cell.dens_grad * dens_penalty[cell.group]) / precond;
-            }
-        }
+            total_grad[i] = ((wl_grad[i] * -1) - dens_grad[i] * dens_penalty[cell.group]) / precond;
+        });
     }
 
     float steplen = 0.01;
@@ -945,15 +1017,15 @@ class StaticPlacer
         float coord_dist = 0;
         float grad_dist = 0;
         int n = 0;
-        for (auto &cell : mcells) {
-            if (cell.is_fixed || cell.is_dark)
+        for (int i = 0; i < int(mcells.size()); i++) {
+            if (mcells[i].is_fixed || mcells[i].is_dark)
                 continue;
-            coord_dist += (cell.ref_pos.x - cell.last_ref_pos.x) * (cell.ref_pos.x - cell.last_ref_pos.x);
-            coord_dist += (cell.ref_pos.y - cell.last_ref_pos.y) * (cell.ref_pos.y - cell.last_ref_pos.y);
-            grad_dist +=
-                    (cell.ref_total_grad.x - cell.last_total_grad.x) * (cell.ref_total_grad.x - cell.last_total_grad.x);
-            grad_dist +=
-                    (cell.ref_total_grad.y - cell.last_total_grad.y) * (cell.ref_total_grad.y - cell.last_total_grad.y);
+            RealPair d_pos = state.ref_pos[i] - state.last_ref_pos[i];
+            RealPair d_grad = state.ref_total_grad[i] - state.last_total_grad[i];
+            coord_dist += d_pos.x * d_pos.x;
+            coord_dist += d_pos.y * d_pos.y;
+            grad_dist += d_grad.x * d_grad.x;
+            grad_dist += d_grad.y * d_grad.y;
             n++;
         }
         coord_dist = std::sqrt(coord_dist / (2 * float(n)));
@@ -982,9 +1054,9 @@ class StaticPlacer
     {
         for (auto &group : groups)
             group.curr_potential = 0;
-        for (auto &cell : mcells) {
-            auto &g = groups.at(cell.group);
-            iter_slithers(cell.ref_pos, cell.rect,
+        for (int i = 0; i < int(mcells.size()); i++) {
+            auto &g = groups.at(mcells[i].group);
+            iter_slithers(state.ref_pos[i], mcells[i].rect,
                           [&](int x, int y, float area) { g.curr_potential += g.electro_phi.at(x, y) * area; });
         }
         if (init) {
@@ -1035,32 +1107,30 @@ class StaticPlacer
     {
         float initial_steplength = 0.01f;
         // Update current and previous gradients with initial solution
-        for (auto &cell : mcells) {
-            cell.ref_pos = cell.pos;
-        }
+        state.ref_pos = state.pos;
         while (true) {
             update_gradients(true, true, /* init_penalty */ true);
             // compute a "fake" previous position based on an arbitrary steplength and said gradients for nesterov
-            for (auto &cell : mcells) {
-                if (cell.is_fixed || cell.is_dark)
-                    continue;
+            for_each_mcell([&](int i) {
+                if (mcells[i].is_fixed || mcells[i].is_dark)
+                    return;
                 // save current position in last_pos
-                cell.last_pos = cell.pos;
-                cell.last_ref_pos = cell.ref_pos;
+                state.last_pos[i] = state.pos[i];
+                state.last_ref_pos[i] = state.ref_pos[i];
                 // compute previous position; but store it in current for gradient computation
-                cell.ref_pos = cell.pos - cell.ref_total_grad * initial_steplength;
-            }
+                state.ref_pos[i] = state.pos[i] - state.ref_total_grad[i] * initial_steplength;
+            });
             // Compute the previous gradients (albeit into the current state fields)
             update_gradients(true);
             // Now we have the fake previous state in the current state
-            for (auto &cell : mcells) {
-                if (cell.is_fixed || cell.is_dark)
-                    continue;
-                std::swap(cell.last_ref_pos, cell.ref_pos);
-                std::swap(cell.ref_total_grad, cell.last_total_grad);
-                std::swap(cell.ref_wl_grad, cell.last_wl_grad);
-                std::swap(cell.ref_dens_grad, cell.last_dens_grad);
-            }
+            for_each_mcell([&](int i) {
+                if (mcells[i].is_fixed || mcells[i].is_dark)
+                    return;
+                std::swap(state.last_ref_pos[i], state.ref_pos[i]);
+                std::swap(state.ref_total_grad[i], state.last_total_grad[i]);
+                std::swap(state.ref_wl_grad[i], state.last_wl_grad[i]);
+                std::swap(state.ref_dens_grad[i], state.last_dens_grad[i]);
+            });
             float next_steplen = get_steplen();
             log_info("initial steplen=%f next steplen = %f\n", initial_steplength, next_steplen);
             if (next_steplen != 0 && std::isfinite(next_steplen) && std::abs(next_steplen) < 1e10) {
@@ -1090,21 +1160,20 @@ class StaticPlacer
             const float area_epsilon = 0.05;
             RealPair pos(0, 0), ref_pos(0, 0);
             for (int c : macro.conc_cells) {
-                auto &mc = mcells.at(c);
-                float a = std::max(mc.rect.area(), area_epsilon);
-                pos += mc.pos * a;
-                ref_pos += mc.ref_pos * a;
+                float a = std::max(mcells.at(c).rect.area(), area_epsilon);
+                pos += state.pos.at(c) * a;
+                ref_pos += state.ref_pos.at(c) * a;
                 total_area += a;
             }
             pos /= total_area;
             ref_pos /= total_area;
             for (int c : macro.conc_cells) {
                 auto &cc = ccells.at(c);
-                auto &mc = mcells.at(c);
-                auto last_pos = mc.pos;
-                mc.pos = mc.pos * (1 - alpha) + (pos + RealPair(cc.chunk_dx, cc.chunk_dy)) * alpha;
-                mc.ref_pos = mc.ref_pos * (1 - alpha) + (ref_pos + RealPair(cc.chunk_dx, cc.chunk_dy)) * alpha;
-                dist += std::sqrt(std::pow(last_pos.x - mc.pos.x, 2) + std::pow(last_pos.y - mc.pos.y, 2));
+                auto &mc_pos = state.pos.at(c), &mc_ref_pos = state.ref_pos.at(c);
+                auto last_pos = mc_pos;
+                mc_pos = mc_pos * (1 - alpha) + (pos + RealPair(cc.chunk_dx, cc.chunk_dy)) * alpha;
+                mc_ref_pos = mc_ref_pos * (1 - alpha) + (ref_pos + RealPair(cc.chunk_dx, cc.chunk_dy)) * alpha;
+                dist += std::sqrt(std::pow(last_pos.x - mc_pos.x, 2) + std::pow(last_pos.y - mc_pos.y, 2));
             }
         }
         log_info("   update_chains distance %.2f\n", dist);
@@ -1121,17 +1190,18 @@ class StaticPlacer
         log_info("iter=%d steplen=%f a=%f penalty=[%s]\n", iter, steplen, nesterov_a, penalty_str.c_str());
         float a_next = (1.0f + std::sqrt(4.0f * nesterov_a * nesterov_a + 1)) / 2.0f;
         // Update positions using Nesterov's
-        for (auto &cell : mcells) {
-            if (cell.is_fixed || cell.is_dark)
-                continue;
+        for_each_mcell([&](int i) {
+            if (mcells[i].is_fixed || mcells[i].is_dark)
+                return;
             // save current position in last_pos
-            cell.last_ref_pos = cell.ref_pos;
-            cell.last_pos = cell.pos;
+            state.last_ref_pos[i] = state.ref_pos[i];
+            state.last_pos[i] = state.pos[i];
             // compute new position
-            cell.pos = clamp_loc(cell.ref_pos - cell.ref_total_grad * steplen);
+            state.pos[i] = clamp_loc(state.ref_pos[i] - state.ref_total_grad[i] * steplen);
             // compute reference position
-            cell.ref_pos = clamp_loc(cell.pos + (cell.pos - cell.last_pos) * ((nesterov_a - 1) / a_next));
-        }
+            state.ref_pos[i] =
+                    clamp_loc(state.pos[i] + (state.pos[i] - state.last_pos[i]) * ((nesterov_a - 1) / a_next));
+        });
         nesterov_a = a_next;
         update_chains();
         update_gradients(true);
@@ -1144,6 +1214,7 @@ class StaticPlacer
 
     void update_timing()
     {
+        ProfileScope prof_scope(ctx->profiler, "static/timing");
         if (!cfg.timing_driven)
             return;
         for (auto &net : nets) {
@@ -1159,6 +1230,7 @@ class StaticPlacer
             }
         }
         tmg.run(false);
+        update_pin_weights();
     }
 
     void legalise_step(bool dsp_bram)
@@ -1185,6 +1257,8 @@ class StaticPlacer
                 enqueue_legalise(cell.second.get());
         }
         log_info("Strict legalising %d cells...\n", int(to_legalise.size()));
+        ProfileScope prof_scope(ctx->profiler, "static/legalise");
+        ctx->profiler.add_count("static/cells_legalised", int64_t(to_legalise.size()));
         float pre_hpwl = system_hpwl();
         legalise_placement_strict(true);
         update_nets(true);
@@ -1263,8 +1337,8 @@ class StaticPlacer
                     cx = width / 2;
                     cy = height / 2;
                 } else {
-                    cx = int(mcells.at(ci->udata).pos.x);
-                    cy = int(mcells.at(ci->udata).pos.y);
+                    cx = int(state.pos.at(ci->udata).x);
+                    cy = int(state.pos.at(ci->udata).y);
                 }
                 int nx = ctx->rng(2 * rx + 1) + std::max(cx - rx, 0);
                 int ny = ctx->rng(2 * ry + 1) + std::max(cy - ry, 0);
@@ -1322,9 +1396,8 @@ class StaticPlacer
                     placed = true;
                     Loc loc = ctx->getBelLocation(bestBel);
                     if (ci->udata != -1) {
-                        auto &mc = mcells.at(ci->udata);
-                        mc.pos = mc.ref_pos = RealPair(loc, 0.5);
-                        mc.is_fixed = true;
+                        state.pos.at(ci->udata) = state.ref_pos.at(ci->udata) = RealPair(loc, 0.5);
+                        mcells.at(ci->udata).is_fixed = true;
                     }
                     break;
                 }
@@ -1368,8 +1441,8 @@ class StaticPlacer
                                     CellInfo *drv = p.net->driver.cell;
                                     if (drv->udata == -1)
                                         continue;
-                                    auto drv_loc = mcells.at(drv->udata);
-                                    input_len += std::abs(int(drv_loc.pos.x) - nx) + std::abs(int(drv_loc.pos.y) - ny);
+                                    auto drv_loc = state.pos.at(drv->udata);
+                                    input_len += std::abs(int(drv_loc.x) - nx) + std::abs(int(drv_loc.y) - ny);
                                 }
                                 if (input_len < best_inp_len) {
                                     best_inp_len = input_len;
@@ -1382,9 +1455,8 @@ class StaticPlacer
                                     enqueue_legalise(bound);
                                 Loc loc = ctx->getBelLocation(sz);
                                 if (ci->udata != -1) {
-                                    auto &mc = mcells.at(ci->udata);
-                                    mc.pos = mc.ref_pos = RealPair(loc, 0.5);
-                                    mc.is_fixed = true;
+                                    state.pos.at(ci->udata) = state.ref_pos.at(ci->udata) = RealPair(loc, 0.5);
+                                    mcells.at(ci->udata).is_fixed = true;
                                 }
                                 placed = true;
                                 break;
@@ -1439,9 +1511,9 @@ class StaticPlacer
                         for (auto &target : targets) {
                             Loc loc = ctx->getBelLocation(target.second);
                             if (ci->udata != -1) {
-                                auto &mc = mcells.at(target.first->udata);
-                                mc.pos = mc.ref_pos = RealPair(loc, 0.5);
-                                mc.is_fixed = true;
+                                int idx = target.first->udata;
+                                state.pos.at(idx) = state.ref_pos.at(idx) = RealPair(loc, 0.5);
+                                mcells.at(idx).is_fixed = true;
                             }
                             // log_info("%s %d %d %d\n", target.first->name.c_str(ctx), loc.x, loc.y, loc.z);
                         }
@@ -1461,7 +1533,8 @@ class StaticPlacer
 
   public:
     StaticPlacer(Context *ctx, PlacerStaticCfg cfg)
-            : ctx(ctx), cfg(cfg), fast_bels(ctx, true, 8), tmg(ctx), pool(ctx->setting<int>("threads", 8))
+            : ctx(ctx), cfg(cfg), fast_bels(ctx, true, 8), tmg(ctx), pool(ctx->setting<int>("threads", 8)),
+              threads(std::max(1, ctx->setting<int>("threads", 8)))
     {
         groups.resize(cfg.cell_groups.size());
         tmg.setup_only = true;
@@ -1482,7 +1555,10 @@ class StaticPlacer
         initialise();
         bool legalised_ip = false;
         while (true) {
-            step();
+            {
+                ProfileScope prof_scope(ctx->profiler, "static/step");
+                step();
+            }
             for (auto &p : dens_penalty)
                 if (p < 50.0)
                     p *= 1.025;
@@ -32,6 +32,7 @@
 #include <boost/range/adaptor/reversed.hpp>
 #include <queue>
 #include "nextpnr.h"
+#include "place_netlist.h"
 #include "timing.h"
 #include "util.h"
 
@@ -40,7 +41,7 @@ NEXTPNR_NAMESPACE_BEGIN
 class TimingOptimiser
 {
   public:
-    TimingOptimiser(Context *ctx, TimingOptCfg cfg) : ctx(ctx), cfg(cfg), tmg(ctx) {};
+    TimingOptimiser(Context *ctx, TimingOptCfg cfg) : ctx(ctx), cfg(cfg), netlist(ctx), tmg(ctx) {};
     bool optimise()
     {
         log_info("Running timing-driven placement optimisation...\n");
@@ -65,21 +66,18 @@ class TimingOptimiser
   private:
     void setup_delay_limits()
     {
-        max_net_delay.clear();
-        for (auto &net : ctx->nets) {
-            NetInfo *ni = net.second.get();
+        max_net_delay.assign(netlist.num_pins(), std::numeric_limits<delay_t>::max());
+        for (int i = 0; i < int(netlist.nets.size()); i++) {
+            NetInfo *ni = netlist.nets.at(i);
             if (ni->driver.cell == nullptr)
                 continue;
-            for (auto usr : ni->users) {
-                max_net_delay[std::make_pair(usr.cell->name, usr.port)] = std::numeric_limits<delay_t>::max();
-            }
-            for (auto usr : ni->users) {
-                delay_t net_delay = ctx->getNetinfoRouteDelay(ni, usr);
-                delay_t slack = tmg.get_setup_slack(CellPortKey(usr));
-                delay_t domain_slack = tmg.get_domain_setup_slack(CellPortKey(usr));
+            for (auto usr : ni->users.enumerate()) {
+                delay_t net_delay = ctx->getNetinfoRouteDelay(ni, usr.value);
+                delay_t slack = tmg.get_setup_slack(CellPortKey(usr.value));
+                delay_t domain_slack = tmg.get_domain_setup_slack(CellPortKey(usr.value));
                 if (slack == std::numeric_limits<delay_t>::max())
                     continue;
-                max_net_delay[std::make_pair(usr.cell->name, usr.port)] = net_delay + ((slack - domain_slack) / 10);
+                max_net_delay.at(netlist.user_pin(i, usr.index)) = net_delay + ((slack - domain_slack) / 10);
             }
         }
     }
@@ -94,24 +92,19 @@ class TimingOptimiser
             if (net == nullptr)
                 continue;
             if (port.second.type == PORT_IN) {
-                if (net->driver.cell == nullptr || net->driver.cell->bel == BelId())
+                if (net->driver.cell == nullptr || net->driver.cell->bel == BelId() || !port.second.user_idx)
                     continue;
-                for (auto user : net->users) {
-                    if (user.cell == cell && user.port == port.first) {
-                        if (ctx->predictArcDelay(net, user) >
-                            1.1 * max_net_delay.at(std::make_pair(cell->name, port.first)))
-                            return false;
-                    }
-                }
-
+                if (ctx->predictArcDelay(net, net->users.at(port.second.user_idx)) >
+                    1.1 * max_net_delay.at(netlist.user_pin(net->udata, port.second.user_idx)))
+                    return false;
             } else if (port.second.type == PORT_OUT) {
-                for (auto user : net->users) {
+                for (auto user : net->users.enumerate()) {
                     // This could get expensive for high-fanout nets??
-                    BelId dstBel = user.cell->bel;
+                    BelId dstBel = user.value.cell->bel;
                     if (dstBel == BelId())
                         continue;
-                    if (ctx->predictArcDelay(net, user) >
-                        1.1 * max_net_delay.at(std::make_pair(user.cell->name, user.port))) {
+                    if (ctx->predictArcDelay(net, user.value) >
+                        1.1 * max_net_delay.at(netlist.user_pin(net->udata, user.index))) {
 
                         return false;
                     }
@@ -549,10 +542,11 @@ class TimingOptimiser
     std::vector<IdString> path_cells;
     dict<IdString, pool<BelId>> cell_neighbour_bels;
     dict<BelId, pool<IdString>> bel_candidate_cells;
-    // Map cell ports to net delay limit
-    dict<std::pair<IdString, IdString>, delay_t> max_net_delay;
+    // Net delay limit by sink pin
+    std::vector<delay_t> max_net_delay;
     Context *ctx;
     TimingOptCfg cfg;
+    PlaceNetlist netlist;
     TimingAnalyser tmg;
 };
 
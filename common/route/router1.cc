@@ -17,6 +17,7 @@
  *
  */
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <queue>
@@ -37,30 +38,11 @@ struct arc_key
     store_index<PortRef> user_idx;
     // physical index into cell->bel pin mapping (usually 0)
     unsigned phys_idx;
-
-    bool operator==(const arc_key &other) const
-    {
-        return (net_info == other.net_info) && (user_idx == other.user_idx) && (phys_idx == other.phys_idx);
-    }
-    bool operator<(const arc_key &other) const
-    {
-        return net_info == other.net_info
-                       ? (user_idx == other.user_idx ? phys_idx < other.phys_idx : user_idx < other.user_idx)
-                       : net_info->name < other.net_info->name;
-    }
-
-    unsigned int hash() const
-    {
-        std::size_t seed = std::hash<NetInfo *>()(net_info);
-        seed ^= user_idx.hash() + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        seed ^= std::hash<int>()(phys_idx) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        return seed;
-    }
 };
 
 struct arc_entry
 {
-    arc_key arc;
+    int arc;
     delay_t pri;
     int randtag = 0;
 
@@ -98,46 +80,222 @@ struct QueuedWire
     };
 };
 
+// A wire in use by an arc. Each one is on two doubly linked lists: the arcs using its wire, and the wires used by its
+// arc, so either side can be ripped up without searching. Unused entries are chained through next_arc.
+struct WireArc
+{
+    WireId wire;
+    int arc;
+    int prev_arc, next_arc;
+    int prev_wire, next_wire;
+};
+
 struct Router1
 {
     Context *ctx;
     const Router1Cfg &cfg;
 
+    // Every arc of every net, numbered by net name, then user, then physical pin; so that sorting arc numbers gives
+    // the same order as sorting the arcs themselves. Nets are numbered in the same order, using 'udata'.
+    std::vector<NetInfo *> nets_by_udata;
+    std::vector<arc_key> arcs;
+    // The first arc of user u of net n is user_arcs[net_users[n] + u.idx()]
+    std::vector<int> net_users, user_arcs;
+
     std::priority_queue<arc_entry, std::vector<arc_entry>, arc_entry::Less> arc_queue;
-    dict<WireId, pool<arc_key>> wire_to_arcs;
-    dict<arc_key, pool<WireId>> arc_to_wires;
-    pool<arc_key> queued_arcs;
+    // Indexed by arc
+    std::vector<bool> queued_arcs;
+
+    std::vector<WireArc> wire_arcs;
+    int free_wire_arc = -1;
+    // Heads of the lists of arcs using each wire, indexed by getWireIndex(); and of wires used by each arc
+    std::vector<int> wire_arcs_head;
+    std::vector<int> arc_wires_head;
+
+    // Heap ordered by QueuedWire::Greater, kept as a plain vector so its storage is reused from one arc to the next
+    std::vector<QueuedWire> queue;
 
-    std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> queue;
+    // Indexed by getWireIndex()
+    std::vector<int> wireScores;
+    // Indexed by net 'udata'
+    std::vector<int> netScores;
 
-    dict<WireId, int> wireScores;
-    dict<NetInfo *, int, hash_ptr_ops> netScores;
+    // Wires visited by the current A* search; visited_idx maps getWireIndex() to an entry in visited, or -1
+    std::vector<QueuedWire> visited;
+    std::vector<int> visited_idx;
+
+    // Scratch space for ripup, reused between calls
+    std::vector<WireId> ripup_wires;
+    std::vector<int> ripup_arcs;
 
     int arcs_with_ripup = 0;
     int arcs_without_ripup = 0;
     bool ripup_flag;
 
+    // Work done since the last add_profile_counts(); an iteration is one arc taken off the queue, as in the IterCnt
+    // column of the log
+    int64_t profile_iters = 0, profile_arcs = 0, profile_visits = 0;
+
     TimingAnalyser tmg;
 
     bool timing_driven = true;
 
+    void add_profile_counts()
+    {
+        ctx->profiler.add_count("router1/iterations", profile_iters);
+        ctx->profiler.add_count("router1/arcs_routed", profile_arcs);
+        ctx->profiler.add_count("router1/wires_explored", profile_visits);
+        profile_iters = 0;
+        profile_arcs = 0;
+        profile_visits = 0;
+    }
+
     Router1(Context *ctx, const Router1Cfg &cfg) : ctx(ctx), cfg(cfg), tmg(ctx)
     {
         timing_driven = ctx->setting<bool>("timing_driven");
         tmg.setup_only = false;
         tmg.with_clock_skew = true;
+        tmg.incremental = true;
         tmg.setup();
         tmg.run();
+        wireScores.resize(ctx->getWireIndexCount());
+        visited_idx.resize(ctx->getWireIndexCount(), -1);
+        wire_arcs_head.resize(ctx->getWireIndexCount(), -1);
+        number_arcs();
+    }
+
+    void number_arcs()
+    {
+        std::vector<IdString> net_names;
+        for (auto &net_it : ctx->nets)
+            net_names.push_back(net_it.first);
+        std::sort(net_names.begin(), net_names.end());
+
+        for (IdString net_name : net_names) {
+            NetInfo *net_info = ctx->nets.at(net_name).get();
+            net_info->udata = int(nets_by_udata.size());
+            nets_by_udata.push_back(net_info);
+            net_users.push_back(int(user_arcs.size()));
+            user_arcs.resize(user_arcs.size() + net_info->users.capacity(), -1);
+            for (auto user : net_info->users.enumerate()) {
+                user_arcs.at(net_users.back() + user.index.idx()) = int(arcs.size());
+                unsigned phys_idx = 0;
+                for (auto dst_wire : ctx->getNetinfoSinkWires(net_info, user.value)) {
+                    (void)dst_wire;
+                    arcs.push_back(arc_key{net_info, user.index, phys_idx++});
+                }
+            }
+        }
+
+        netScores.resize(nets_by_udata.size());
+        queued_arcs.resize(arcs.size());
+        arc_wires_head.resize(arcs.size(), -1);
     }
 
-    void arc_queue_insert(const arc_key &arc, WireId src_wire, WireId dst_wire)
+    int arc_index(const NetInfo *net_info, store_index<PortRef> user_idx, unsigned phys_idx) const
     {
-        if (queued_arcs.count(arc))
+        return user_arcs[net_users[net_info->udata] + user_idx.idx()] + phys_idx;
+    }
+
+    // Each wire must only be added once for an arc, as the lists don't deduplicate
+    void add_wire_arc(WireId wire, int arc)
+    {
+#ifndef NDEBUG
+        for (int i = arc_wires_head[arc]; i != -1; i = wire_arcs[i].next_wire)
+            NPNR_ASSERT(wire_arcs[i].wire != wire);
+#endif
+        int idx = free_wire_arc;
+        if (idx == -1) {
+            idx = int(wire_arcs.size());
+            wire_arcs.emplace_back();
+        } else {
+            free_wire_arc = wire_arcs[idx].next_arc;
+        }
+        int &wire_head = wire_arcs_head[ctx->getWireIndex(wire)];
+        int &arc_head = arc_wires_head[arc];
+        WireArc &wa = wire_arcs[idx];
+        wa.wire = wire;
+        wa.arc = arc;
+        wa.prev_arc = -1;
+        wa.next_arc = wire_head;
+        wa.prev_wire = -1;
+        wa.next_wire = arc_head;
+        if (wire_head != -1)
+            wire_arcs[wire_head].prev_arc = idx;
+        if (arc_head != -1)
+            wire_arcs[arc_head].prev_wire = idx;
+        wire_head = idx;
+        arc_head = idx;
+    }
+
+    void remove_wire_arc(int idx)
+    {
+        WireArc &wa = wire_arcs[idx];
+        if (wa.prev_arc == -1)
+            wire_arcs_head[ctx->getWireIndex(wa.wire)] = wa.next_arc;
+        else
+            wire_arcs[wa.prev_arc].next_arc = wa.next_arc;
+        if (wa.next_arc != -1)
+            wire_arcs[wa.next_arc].prev_arc = wa.prev_arc;
+        if (wa.prev_wire == -1)
+            arc_wires_head[wa.arc] = wa.next_wire;
+        else
+            wire_arcs[wa.prev_wire].next_wire = wa.next_wire;
+        if (wa.next_wire != -1)
+            wire_arcs[wa.next_wire].prev_wire = wa.prev_wire;
+        wa.next_arc = free_wire_arc;
+        free_wire_arc = idx;
+    }
+
+    bool wire_has_arcs(WireId wire) const { return wire_arcs_head[ctx->getWireIndex(wire)] != -1; }
+
+    void queue_push(const QueuedWire &qw)
+    {
+        queue.push_back(qw);
+        std::push_heap(queue.begin(), queue.end(), QueuedWire::Greater());
+    }
+
+    QueuedWire queue_pop()
+    {
+        std::pop_heap(queue.begin(), queue.end(), QueuedWire::Greater());
+        QueuedWire qw = queue.back();
+        queue.pop_back();
+        return qw;
+    }
+
+    QueuedWire *find_visited(WireId wire)
+    {
+        int idx = visited_idx[ctx->getWireIndex(wire)];
+        return idx == -1 ? nullptr : &visited[idx];
+    }
+
+    void set_visited(const QueuedWire &qw)
+    {
+        int &idx = visited_idx[ctx->getWireIndex(qw.wire)];
+        if (idx == -1) {
+            idx = int(visited.size());
+            visited.push_back(qw);
+        } else {
+            visited[idx] = qw;
+        }
+    }
+
+    void clear_visited()
+    {
+        for (auto &qw : visited)
+            visited_idx[ctx->getWireIndex(qw.wire)] = -1;
+        visited.clear();
+    }
+
+    void arc_queue_insert(int arc, WireId src_wire, WireId dst_wire)
+    {
+        if (queued_arcs[arc])
             return;
 
-        delay_t pri = (arc.net_info->constant_value == IdString())
+        const arc_key &key = arcs[arc];
+        delay_t pri = (key.net_info->constant_value == IdString())
                               ? (ctx->estimateDelay(src_wire, dst_wire) *
-                                 (100 * tmg.get_criticality(CellPortKey(arc.net_info->users.at(arc.user_idx)))))
+                                 (100 * tmg.get_criticality(CellPortKey(key.net_info->users.at(key.user_idx)))))
                               : 0;
 
         arc_entry entry;
@@ -147,76 +305,80 @@ struct Router1
 
 #if 0
         if (ctx->debug)
-            log("[arc_queue_insert] %s (%d) %s %s [%d %d]\n", ctx->nameOf(entry.arc.net_info), entry.arc.user_idx,
+            log("[arc_queue_insert] %s (%d) %s %s [%d %d]\n", ctx->nameOf(key.net_info), key.user_idx,
                 ctx->nameOfWire(src_wire), ctx->nameOfWire(dst_wire), (int)entry.pri, entry.randtag);
 #endif
 
         arc_queue.push(entry);
-        queued_arcs.insert(arc);
+        queued_arcs[arc] = true;
     }
 
-    void arc_queue_insert(const arc_key &arc)
+    void arc_queue_insert(int arc)
     {
-        if (queued_arcs.count(arc))
+        if (queued_arcs[arc])
             return;
 
-        NetInfo *net_info = arc.net_info;
-        auto user_idx = arc.user_idx;
-        unsigned phys_idx = arc.phys_idx;
+        const arc_key &key = arcs[arc];
+        NetInfo *net_info = key.net_info;
 
         auto src_wire = ctx->getNetinfoSourceWire(net_info);
-        auto dst_wire = ctx->getNetinfoSinkWire(net_info, net_info->users[user_idx], phys_idx);
+        auto dst_wire = ctx->getNetinfoSinkWire(net_info, net_info->users[key.user_idx], key.phys_idx);
 
         arc_queue_insert(arc, src_wire, dst_wire);
     }
 
-    arc_key arc_queue_pop()
+    int arc_queue_pop()
     {
         arc_entry entry = arc_queue.top();
 
 #if 0
         if (ctx->debug)
-            log("[arc_queue_pop] %s (%d) [%d %d]\n", ctx->nameOf(entry.arc.net_info), entry.arc.user_idx,
+            log("[arc_queue_pop] %s (%d) [%d %d]\n", ctx->nameOf(arcs[entry.arc].net_info), arcs[entry.arc].user_idx,
                 (int)entry.pri, entry.randtag);
 #endif
 
         arc_queue.pop();
-        queued_arcs.erase(entry.arc);
+        queued_arcs[entry.arc] = false;
         return entry.arc;
     }
 
-    void ripup_net(NetInfo *net)
+    // Requeue all arcs using a wire and unbind it
+    void ripup_wire_arcs(WireId w, int indent)
     {
-        if (ctx->debug)
-            log("      ripup net %s\n", ctx->nameOf(net));
+        ripup_arcs.clear();
+        while (wire_arcs_head[ctx->getWireIndex(w)] != -1) {
+            int idx = wire_arcs_head[ctx->getWireIndex(w)];
+            ripup_arcs.push_back(wire_arcs[idx].arc);
+            remove_wire_arc(idx);
+        }
 
-        netScores[net]++;
+        ctx->sorted_shuffle(ripup_arcs);
 
-        std::vector<WireId> wires;
-        for (auto &it : net->wires)
-            wires.push_back(it.first);
+        for (int arc : ripup_arcs)
+            arc_queue_insert(arc);
 
-        ctx->sorted_shuffle(wires);
+        if (ctx->debug)
+            log("%*sunbind wire %s\n", indent, "", ctx->nameOfWire(w));
 
-        for (WireId w : wires) {
-            std::vector<arc_key> arcs;
-            for (auto &it : wire_to_arcs[w]) {
-                arc_to_wires[it].erase(w);
-                arcs.push_back(it);
-            }
-            wire_to_arcs[w].clear();
+        ctx->unbindWire(w);
+        wireScores[ctx->getWireIndex(w)]++;
+    }
 
-            ctx->sorted_shuffle(arcs);
+    void ripup_net(NetInfo *net)
+    {
+        if (ctx->debug)
+            log("      ripup net %s\n", ctx->nameOf(net));
 
-            for (auto &it : arcs)
-                arc_queue_insert(it);
+        netScores[net->udata]++;
 
-            if (ctx->debug)
-                log("        unbind wire %s\n", ctx->nameOfWire(w));
+        ripup_wires.clear();
+        for (auto &it : net->wires)
+            ripup_wires.push_back(it.first);
 
-            ctx->unbindWire(w);
-            wireScores[w]++;
-        }
+        ctx->sorted_shuffle(ripup_wires);
+
+        for (WireId w : ripup_wires)
+            ripup_wire_arcs(w, 8);
 
         ripup_flag = true;
     }
@@ -233,23 +395,7 @@ struct Router1
             if (n != nullptr)
                 ripup_net(n);
         } else {
-            std::vector<arc_key> arcs;
-            for (auto &it : wire_to_arcs[w]) {
-                arc_to_wires[it].erase(w);
-                arcs.push_back(it);
-            }
-            wire_to_arcs[w].clear();
-
-            ctx->sorted_shuffle(arcs);
-
-            for (auto &it : arcs)
-                arc_queue_insert(it);
-
-            if (ctx->debug)
-                log("      unbind wire %s\n", ctx->nameOfWire(w));
-
-            ctx->unbindWire(w);
-            wireScores[w]++;
+            ripup_wire_arcs(w, 6);
         }
 
         ripup_flag = true;
@@ -267,28 +413,27 @@ struct Router1
             if (n != nullptr)
                 ripup_net(n);
         } else {
-            std::vector<arc_key> arcs;
-            for (auto &it : wire_to_arcs[w]) {
-                arc_to_wires[it].erase(w);
-                arcs.push_back(it);
-            }
-            wire_to_arcs[w].clear();
-
-            ctx->sorted_shuffle(arcs);
-
-            for (auto &it : arcs)
-                arc_queue_insert(it);
-
-            if (ctx->debug)
-                log("      unbind wire %s\n", ctx->nameOfWire(w));
-
-            ctx->unbindWire(w);
-            wireScores[w]++;
+            ripup_wire_arcs(w, 6);
         }
 
         ripup_flag = true;
     }
 
+    // Unbind the wires that are currently used exclusively by an arc
+    void unroute_arc(int arc)
+    {
+        while (arc_wires_head[arc] != -1) {
+            int idx = arc_wires_head[arc];
+            WireId wire = wire_arcs[idx].wire;
+            remove_wire_arc(idx);
+            if (!wire_has_arcs(wire)) {
+                if (ctx->debug)
+                    log("  unbind %s\n", ctx->nameOfWire(wire));
+                ctx->unbindWire(wire);
+            }
+        }
+    }
+
     bool skip_net(NetInfo *net_info)
     {
 #ifdef ARCH_ECP5
@@ -305,11 +450,39 @@ struct Router1
 
     void check()
     {
-        pool<arc_key> valid_arcs;
+        // Mark the entries on the list of each wire, then check that the lists of each arc have exactly those entries,
+        // and no wire more than once
+        std::vector<bool> on_wire_list(wire_arcs.size(), false);
+        int wire_list_entries = 0;
+        for (int wire_idx = 0; wire_idx < int(wire_arcs_head.size()); wire_idx++) {
+            for (int i = wire_arcs_head[wire_idx]; i != -1; i = wire_arcs[i].next_arc) {
+                log_assert(ctx->getWireIndex(wire_arcs[i].wire) == wire_idx);
+                log_assert(!on_wire_list[i]);
+                on_wire_list[i] = true;
+                ++wire_list_entries;
+            }
+        }
+        // The last arc to use each wire, by wire index
+        std::vector<int> wire_last_arc(wire_arcs_head.size(), -1);
+        int arc_list_entries = 0;
+        for (int arc = 0; arc < int(arcs.size()); arc++) {
+            NetInfo *net_info = arcs[arc].net_info;
+            for (int idx = arc_wires_head[arc]; idx != -1; idx = wire_arcs[idx].next_wire) {
+                const WireArc &wa = wire_arcs[idx];
+                log_assert(wa.arc == arc);
+                log_assert(!skip_net(net_info));
+                log_assert(net_info->wires.count(wa.wire));
+                log_assert(on_wire_list[idx]);
+                int &last_arc = wire_last_arc[ctx->getWireIndex(wa.wire)];
+                log_assert(last_arc != arc);
+                last_arc = arc;
+                ++arc_list_entries;
+            }
+        }
+        log_assert(arc_list_entries == wire_list_entries);
 
         for (auto &net_it : ctx->nets) {
             NetInfo *net_info = net_it.second.get();
-            pool<WireId> valid_wires_for_net;
 
             if (skip_net(net_info))
                 continue;
@@ -322,53 +495,25 @@ struct Router1
             auto src_wire = ctx->getNetinfoSourceWire(net_info);
             log_assert(src_wire != WireId());
 
-            for (auto user : net_info->users.enumerate()) {
-                unsigned phys_idx = 0;
-                for (auto dst_wire : ctx->getNetinfoSinkWires(net_info, user.value)) {
+            for (auto user : net_info->users)
+                for (auto dst_wire : ctx->getNetinfoSinkWires(net_info, user))
                     log_assert(dst_wire != WireId());
 
-                    arc_key arc;
-                    arc.net_info = net_info;
-                    arc.user_idx = user.index;
-                    arc.phys_idx = phys_idx++;
-                    valid_arcs.insert(arc);
-#if 0
-                    if (ctx->debug)
-                    log("[check]   arc: %s %s\n", ctx->nameOfWire(src_wire), ctx->nameOfWire(dst_wire));
-#endif
-
-                    for (WireId wire : arc_to_wires[arc]) {
-#if 0
-                        if (ctx->debug)
-                        log("[check]     wire: %s\n", ctx->nameOfWire(wire));
-#endif
-                        valid_wires_for_net.insert(wire);
-                        log_assert(wire_to_arcs[wire].count(arc));
-                        log_assert(net_info->wires.count(wire));
-                    }
-                }
-            }
-
             for (auto &it : net_info->wires) {
                 WireId w = it.first;
-                log_assert(valid_wires_for_net.count(w));
+                log_assert(wire_has_arcs(w));
+                for (int i = wire_arcs_head[ctx->getWireIndex(w)]; i != -1; i = wire_arcs[i].next_arc) {
+                    log_assert(wire_arcs[i].wire == w);
+                    log_assert(arcs[wire_arcs[i].arc].net_info == net_info);
+                }
             }
         }
-
-        for (auto &it : wire_to_arcs) {
-            for (auto &arc : it.second)
-                log_assert(valid_arcs.count(arc));
-        }
-
-        for (auto &it : arc_to_wires) {
-            log_assert(valid_arcs.count(it.first));
-        }
     }
 
     void setup()
     {
         dict<WireId, NetInfo *> src_to_net;
-        dict<WireId, arc_key> dst_to_arc;
+        dict<WireId, int> dst_to_arc;
 
         std::vector<IdString> net_names;
         for (auto &net_it : ctx->nets)
@@ -392,30 +537,29 @@ struct Router1
                 log_error("Found two nets with same source wire %s: %s vs %s\n", ctx->nameOfWire(src_wire),
                           ctx->nameOf(net_info), ctx->nameOf(src_to_net.at(src_wire)));
 
-            if (dst_to_arc.count(src_wire))
+            if (dst_to_arc.count(src_wire)) {
+                const arc_key &other = arcs.at(dst_to_arc.at(src_wire));
                 log_error("Wire %s is used as source and sink in different nets: %s vs %s (%d)\n",
-                          ctx->nameOfWire(src_wire), ctx->nameOf(net_info),
-                          ctx->nameOf(dst_to_arc.at(src_wire).net_info), dst_to_arc.at(src_wire).user_idx.idx());
+                          ctx->nameOfWire(src_wire), ctx->nameOf(net_info), ctx->nameOf(other.net_info),
+                          other.user_idx.idx());
+            }
 
             for (auto user : net_info->users.enumerate()) {
                 unsigned phys_idx = 0;
                 for (auto dst_wire : ctx->getNetinfoSinkWires(net_info, user.value)) {
-                    arc_key arc;
-                    arc.net_info = net_info;
-                    arc.user_idx = user.index;
-                    arc.phys_idx = phys_idx++;
+                    int arc = arc_index(net_info, user.index, phys_idx++);
 
                     if (dst_wire == WireId())
                         log_error("No wire found for port %s on destination cell %s.\n", ctx->nameOf(user.value.port),
                                   ctx->nameOf(user.value.cell));
 
                     if (dst_to_arc.count(dst_wire)) {
-                        if (dst_to_arc.at(dst_wire).net_info == net_info)
+                        const arc_key &other = arcs.at(dst_to_arc.at(dst_wire));
+                        if (other.net_info == net_info)
                             continue;
                         log_error("Found two arcs with same sink wire %s: %s (%d) vs %s (%d)\n",
                                   ctx->nameOfWire(dst_wire), ctx->nameOf(net_info), user.index.idx(),
-                                  ctx->nameOf(dst_to_arc.at(dst_wire).net_info),
-                                  dst_to_arc.at(dst_wire).user_idx.idx());
+                                  ctx->nameOf(other.net_info), other.user_idx.idx());
                     }
 
                     if (src_to_net.count(dst_wire))
@@ -431,8 +575,7 @@ struct Router1
                     }
 
                     WireId cursor = dst_wire;
-                    wire_to_arcs[cursor].insert(arc);
-                    arc_to_wires[arc].insert(cursor);
+                    add_wire_arc(cursor, arc);
 
                     while (src_wire != cursor && (net_info->constant_value == IdString() ||
                                                   ctx->getWireConstantValue(cursor) != net_info->constant_value)) {
@@ -444,8 +587,7 @@ struct Router1
 
                         NPNR_ASSERT(it->second.pip != PipId());
                         cursor = ctx->getPipSrcWire(it->second.pip);
-                        wire_to_arcs[cursor].insert(arc);
-                        arc_to_wires[arc].insert(cursor);
+                        add_wire_arc(cursor, arc);
                     }
                 }
                 // TODO: this matches the situation before supporting multiple cell->bel pins, but do we want to keep
@@ -460,7 +602,7 @@ struct Router1
             std::vector<WireId> unbind_wires;
 
             for (auto &it : net_info->wires)
-                if (it.second.strength < STRENGTH_LOCKED && wire_to_arcs.count(it.first) == 0)
+                if (it.second.strength < STRENGTH_LOCKED && !wire_has_arcs(it.first))
                     unbind_wires.push_back(it.first);
 
             for (auto it : unbind_wires)
@@ -468,14 +610,14 @@ struct Router1
         }
     }
 
-    bool route_arc(const arc_key &arc, bool ripup)
+    bool route_arc(int arc, bool ripup)
     {
 
-        NetInfo *net_info = arc.net_info;
-        auto user_idx = arc.user_idx;
+        NetInfo *net_info = arcs[arc].net_info;
+        auto user_idx = arcs[arc].user_idx;
 
         auto src_wire = ctx->getNetinfoSourceWire(net_info);
-        auto dst_wire = ctx->getNetinfoSinkWire(net_info, net_info->users[user_idx], arc.phys_idx);
+        auto dst_wire = ctx->getNetinfoSinkWire(net_info, net_info->users[user_idx], arcs[arc].phys_idx);
         ripup_flag = false;
 
         float crit = tmg.get_criticality(CellPortKey(net_info->users.at(user_idx)));
@@ -487,21 +629,7 @@ struct Router1
             log("  sink ..... %s\n", ctx->nameOfWire(dst_wire));
         }
 
-        // unbind wires that are currently used exclusively by this arc
-
-        pool<WireId> old_arc_wires;
-        old_arc_wires.swap(arc_to_wires[arc]);
-
-        for (WireId wire : old_arc_wires) {
-            auto &arc_wires = wire_to_arcs.at(wire);
-            NPNR_ASSERT(arc_wires.count(arc));
-            arc_wires.erase(arc);
-            if (arc_wires.empty()) {
-                if (ctx->debug)
-                    log("  unbind %s\n", ctx->nameOfWire(wire));
-                ctx->unbindWire(wire);
-            }
-        }
+        unroute_arc(arc);
 
         // special case
 
@@ -512,18 +640,14 @@ struct Router1
             else {
                 ctx->bindWire(src_wire, net_info, STRENGTH_WEAK);
             }
-            arc_to_wires[arc].insert(src_wire);
-            wire_to_arcs[src_wire].insert(arc);
+            add_wire_arc(src_wire, arc);
             return true;
         }
 
         // reset wire queue
 
-        if (!queue.empty()) {
-            std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> new_queue;
-            queue.swap(new_queue);
-        }
-        dict<WireId, QueuedWire> visited;
+        queue.clear();
+        clear_visited();
 
         // A* main loop
 
@@ -545,13 +669,12 @@ struct Router1
             }
             qw.randtag = ctx->rng();
 
-            queue.push(qw);
-            visited[qw.wire] = qw;
+            queue_push(qw);
+            set_visited(qw);
         }
 
         while (visitCnt++ < maxVisitCnt && !queue.empty()) {
-            QueuedWire qw = queue.top();
-            queue.pop();
+            QueuedWire qw = queue_pop();
 
             for (auto pip : ctx->getPipsDownhill(qw.wire)) {
                 delay_t next_delay = qw.delay + ctx->getPipDelay(pip).maxDelay();
@@ -629,31 +752,23 @@ struct Router1
                         conflictWireNet = nullptr;
 
                     if (conflictWireWire != WireId()) {
-                        auto scores_it = wireScores.find(conflictWireWire);
-                        if (scores_it != wireScores.end())
-                            penalty_delta += scores_it->second * cfg.wireRipupPenalty;
+                        penalty_delta += wireScores[ctx->getWireIndex(conflictWireWire)] * cfg.wireRipupPenalty;
                         penalty_delta += cfg.wireRipupPenalty;
                     }
 
                     if (conflictPipWire != WireId()) {
-                        auto scores_it = wireScores.find(conflictPipWire);
-                        if (scores_it != wireScores.end())
-                            penalty_delta += scores_it->second * cfg.wireRipupPenalty;
+                        penalty_delta += wireScores[ctx->getWireIndex(conflictPipWire)] * cfg.wireRipupPenalty;
                         penalty_delta += cfg.wireRipupPenalty;
                     }
 
                     if (conflictWireNet != nullptr) {
-                        auto scores_it = netScores.find(conflictWireNet);
-                        if (scores_it != netScores.end())
-                            penalty_delta += scores_it->second * cfg.netRipupPenalty;
+                        penalty_delta += netScores[conflictWireNet->udata] * cfg.netRipupPenalty;
                         penalty_delta += cfg.netRipupPenalty;
                         penalty_delta += conflictWireNet->wires.size() * cfg.wireRipupPenalty;
                     }
 
                     if (conflictPipNet != nullptr) {
-                        auto scores_it = netScores.find(conflictPipNet);
-                        if (scores_it != netScores.end())
-                            penalty_delta += scores_it->second * cfg.netRipupPenalty;
+                        penalty_delta += netScores[conflictPipNet->udata] * cfg.netRipupPenalty;
                         penalty_delta += cfg.netRipupPenalty;
                         penalty_delta += conflictPipNet->wires.size() * cfg.wireRipupPenalty;
                     }
@@ -667,10 +782,10 @@ struct Router1
                 if ((best_score >= 0) && (next_score - next_bonus - cfg.estimatePrecision > best_score))
                     continue;
 
-                auto old_visited_it = visited.find(next_wire);
-                if (old_visited_it != visited.end()) {
-                    delay_t old_delay = old_visited_it->second.delay;
-                    delay_t old_score = old_delay + old_visited_it->second.penalty;
+                const QueuedWire *old_visited = find_visited(next_wire);
+                if (old_visited != nullptr) {
+                    delay_t old_delay = old_visited->delay;
+                    delay_t old_score = old_delay + old_visited->penalty;
                     NPNR_ASSERT(old_score >= 0);
 
                     if (next_score + ctx->getDelayEpsilon() >= old_score)
@@ -681,7 +796,7 @@ struct Router1
                         log("Found better route to %s. Old vs new delay estimate: %.3f (%.3f) %.3f (%.3f)\n",
                             ctx->nameOfWire(next_wire),
                             ctx->getDelayNS(old_score),
-                            ctx->getDelayNS(old_visited_it->second.delay),
+                            ctx->getDelayNS(old_visited->delay),
                             ctx->getDelayNS(next_score),
                             ctx->getDelayNS(next_delay));
 #endif
@@ -712,8 +827,8 @@ struct Router1
                         ctx->getDelayNS(next_delay));
 #endif
 
-                visited[next_qw.wire] = next_qw;
-                queue.push(next_qw);
+                set_visited(next_qw);
+                queue_push(next_qw);
 
                 if (next_wire == dst_wire) {
                     maxVisitCnt = std::min(maxVisitCnt, 2 * visitCnt + (next_qw.penalty > 0 ? 100 : 0));
@@ -722,30 +837,30 @@ struct Router1
             }
         }
 
+        ++profile_arcs;
+        profile_visits += visitCnt;
         if (ctx->debug)
             log("  total number of visited nodes: %d\n", visitCnt);
 
-        if (visited.count(dst_wire) == 0) {
+        if (find_visited(dst_wire) == nullptr) {
             if (ctx->debug)
                 log("  no route found for this arc\n");
             return false;
         }
 
         if (ctx->debug) {
-            log("  final route delay:   %8.2f\n", ctx->getDelayNS(visited[dst_wire].delay));
-            log("  final route penalty: %8.2f\n", ctx->getDelayNS(visited[dst_wire].penalty));
-            log("  final route bonus:   %8.2f\n", ctx->getDelayNS(visited[dst_wire].bonus));
+            log("  final route delay:   %8.2f\n", ctx->getDelayNS(find_visited(dst_wire)->delay));
+            log("  final route penalty: %8.2f\n", ctx->getDelayNS(find_visited(dst_wire)->penalty));
+            log("  final route bonus:   %8.2f\n", ctx->getDelayNS(find_visited(dst_wire)->bonus));
         }
 
         // bind resulting route (and maybe unroute other nets)
 
-        pool<WireId> unassign_wires = arc_to_wires[arc];
-
         WireId cursor = dst_wire;
         delay_t accumulated_path_delay = 0;
         delay_t last_path_delay_delta = 0;
         while (1) {
-            auto pip = visited[cursor].pip;
+            auto pip = find_visited(cursor)->pip;
 
             if (ctx->debug) {
                 delay_t path_delay_delta = ctx->estimateDelay(cursor, dst_wire) - accumulated_path_delay;
@@ -785,8 +900,7 @@ struct Router1
                 }
             }
 
-            wire_to_arcs[cursor].insert(arc);
-            arc_to_wires[arc].insert(cursor);
+            add_wire_arc(cursor, arc);
 
             if (pip == PipId())
                 break;
@@ -802,13 +916,13 @@ struct Router1
         return true;
     }
 
-    bool route_const_arc(const arc_key &arc, bool ripup)
+    bool route_const_arc(int arc, bool ripup)
     {
 
-        NetInfo *net_info = arc.net_info;
-        auto user_idx = arc.user_idx;
+        NetInfo *net_info = arcs[arc].net_info;
+        auto user_idx = arcs[arc].user_idx;
 
-        auto dst_wire = ctx->getNetinfoSinkWire(net_info, net_info->users[user_idx], arc.phys_idx);
+        auto dst_wire = ctx->getNetinfoSinkWire(net_info, net_info->users[user_idx], arcs[arc].phys_idx);
         ripup_flag = false;
 
         if (ctx->debug) {
@@ -818,21 +932,7 @@ struct Router1
             log("  sink ..... %s\n", ctx->nameOfWire(dst_wire));
         }
 
-        // unbind wires that are currently used exclusively by this arc
-
-        pool<WireId> old_arc_wires;
-        old_arc_wires.swap(arc_to_wires[arc]);
-
-        for (WireId wire : old_arc_wires) {
-            auto &arc_wires = wire_to_arcs.at(wire);
-            NPNR_ASSERT(arc_wires.count(arc));
-            arc_wires.erase(arc);
-            if (arc_wires.empty()) {
-                if (ctx->debug)
-                    log("  unbind %s\n", ctx->nameOfWire(wire));
-                ctx->unbindWire(wire);
-            }
-        }
+        unroute_arc(arc);
 
         // special case
 
@@ -843,18 +943,14 @@ struct Router1
             else {
                 ctx->bindWire(dst_wire, net_info, STRENGTH_WEAK);
             }
-            arc_to_wires[arc].insert(dst_wire);
-            wire_to_arcs[dst_wire].insert(arc);
+            add_wire_arc(dst_wire, arc);
             return true;
         }
 
         // reset wire queue
 
-        if (!queue.empty()) {
-            std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> new_queue;
-            queue.swap(new_queue);
-        }
-        dict<WireId, QueuedWire> visited;
+        queue.clear();
+        clear_visited();
 
         // A* main loop
 
@@ -872,13 +968,12 @@ struct Router1
             qw.bonus = 0;
             qw.randtag = ctx->rng();
 
-            queue.push(qw);
-            visited[qw.wire] = qw;
+            queue_push(qw);
+            set_visited(qw);
         }
 
         while (visitCnt++ < maxVisitCnt && !queue.empty()) {
-            QueuedWire qw = queue.top();
-            queue.pop();
+            QueuedWire qw = queue_pop();
 
             for (auto pip : ctx->getPipsUphill(qw.wire)) {
                 delay_t next_delay = qw.delay + ctx->getPipDelay(pip).maxDelay();
@@ -958,31 +1053,23 @@ struct Router1
                         conflictWireNet = nullptr;
 
                     if (conflictWireWire != WireId()) {
-                        auto scores_it = wireScores.find(conflictWireWire);
-                        if (scores_it != wireScores.end())
-                            penalty_delta += scores_it->second * cfg.wireRipupPenalty;
+                        penalty_delta += wireScores[ctx->getWireIndex(conflictWireWire)] * cfg.wireRipupPenalty;
                         penalty_delta += cfg.wireRipupPenalty;
                     }
 
                     if (conflictPipWire != WireId()) {
-                        auto scores_it = wireScores.find(conflictPipWire);
-                        if (scores_it != wireScores.end())
-                            penalty_delta += scores_it->second * cfg.wireRipupPenalty;
+                        penalty_delta += wireScores[ctx->getWireIndex(conflictPipWire)] * cfg.wireRipupPenalty;
                         penalty_delta += cfg.wireRipupPenalty;
                     }
 
                     if (conflictWireNet != nullptr) {
-                        auto scores_it = netScores.find(conflictWireNet);
-                        if (scores_it != netScores.end())
-                            penalty_delta += scores_it->second * cfg.netRipupPenalty;
+                        penalty_delta += netScores[conflictWireNet->udata] * cfg.netRipupPenalty;
                         penalty_delta += cfg.netRipupPenalty;
                         penalty_delta += conflictWireNet->wires.size() * cfg.wireRipupPenalty;
                     }
 
                     if (conflictPipNet != nullptr) {
-                        auto scores_it = netScores.find(conflictPipNet);
-                        if (scores_it != netScores.end())
-                            penalty_delta += scores_it->second * cfg.netRipupPenalty;
+                        penalty_delta += netScores[conflictPipNet->udata] * cfg.netRipupPenalty;
                         penalty_delta += cfg.netRipupPenalty;
                         penalty_delta += conflictPipNet->wires.size() * cfg.wireRipupPenalty;
                     }
@@ -996,8 +1083,7 @@ struct Router1
                 if ((best_score >= 0) && (next_score - next_bonus - cfg.estimatePrecision > best_score))
                     continue;
 
-                auto old_visited_it = visited.find(next_wire);
-                if (old_visited_it != visited.end()) {
+                if (find_visited(next_wire) != nullptr) {
                     continue;
                 }
 
@@ -1009,8 +1095,8 @@ struct Router1
                 next_qw.bonus = next_bonus;
                 next_qw.randtag = ctx->rng();
 
-                visited[next_qw.wire] = next_qw;
-                queue.push(next_qw);
+                set_visited(next_qw);
+                queue_push(next_qw);
 
                 if (ctx->getWireConstantValue(next_wire) == net_info->constant_value) {
                     maxVisitCnt = std::min(maxVisitCnt, 2 * visitCnt + (next_qw.penalty > 0 ? 100 : 0));
@@ -1022,6 +1108,8 @@ struct Router1
             }
         }
 
+        ++profile_arcs;
+        profile_visits += visitCnt;
         if (ctx->debug)
             log("  total number of visited nodes: %d\n", visitCnt);
 
@@ -1032,15 +1120,13 @@ struct Router1
         }
 
         if (ctx->debug) {
-            log("  final route delay:   %8.2f\n", ctx->getDelayNS(visited[dst_wire].delay));
-            log("  final route penalty: %8.2f\n", ctx->getDelayNS(visited[dst_wire].penalty));
-            log("  final route bonus:   %8.2f\n", ctx->getDelayNS(visited[dst_wire].bonus));
+            log("  final route delay:   %8.2f\n", ctx->getDelayNS(find_visited(dst_wire)->delay));
+            log("  final route penalty: %8.2f\n", ctx->getDelayNS(find_visited(dst_wire)->penalty));
+            log("  final route bonus:   %8.2f\n", ctx->getDelayNS(find_visited(dst_wire)->bonus));
         }
 
         // bind resulting route (and maybe unroute other nets)
 
-        pool<WireId> unassign_wires = arc_to_wires[arc];
-
         WireId cursor = best_src;
 
         if (!net_info->wires.count(cursor)) {
@@ -1051,11 +1137,10 @@ struct Router1
             ctx->bindWire(cursor, net_info, STRENGTH_WEAK);
         }
 
-        wire_to_arcs[cursor].insert(arc);
-        arc_to_wires[arc].insert(cursor);
+        add_wire_arc(cursor, arc);
 
         while (1) {
-            auto pip = visited[cursor].pip;
+            auto pip = find_visited(cursor)->pip;
 
             if (pip == PipId()) {
                 NPNR_ASSERT(cursor == dst_wire);
@@ -1080,8 +1165,7 @@ struct Router1
                 ctx->bindPip(pip, net_info, STRENGTH_WEAK);
             }
 
-            wire_to_arcs[next].insert(arc);
-            arc_to_wires[arc].insert(next);
+            add_wire_arc(next, arc);
 
             cursor = next;
         }
@@ -1187,8 +1271,10 @@ bool router1(Context *ctx, const Router1Cfg &cfg)
         log_info("   IterCnt |  w/ripup   wo/ripup |  w/r  wo/r |      arcs| batch(sec) total(sec)|\n");
 
         auto prev_time = rstart;
+        ProfileScope prof_route(ctx->profiler, "router1/route");
         while (!router.arc_queue.empty()) {
             if (++iter_cnt % 1000 == 0) {
+                router.add_profile_counts();
                 auto curr_time = std::chrono::high_resolution_clock::now();
                 log_info("%10d | %8d %10d | %4d %5d | %9d| %10.02f %10.02f|\n", iter_cnt, router.arcs_with_ripup,
                          router.arcs_without_ripup, router.arcs_with_ripup - last_arcs_with_ripup,
@@ -1207,11 +1293,13 @@ bool router1(Context *ctx, const Router1Cfg &cfg)
             if (ctx->debug)
                 log("-- %d --\n", iter_cnt);
 
-            arc_key arc = router.arc_queue_pop();
-            if (arc.net_info->constant_value != IdString()) {
+            int arc = router.arc_queue_pop();
+            router.profile_iters++;
+            const arc_key &key = router.arcs.at(arc);
+            if (key.net_info->constant_value != IdString()) {
                 if (!router.route_const_arc(arc, true)) {
-                    log_warning("Failed to find a route for arc %d of net %s.\n", arc.user_idx.idx(),
-                                ctx->nameOf(arc.net_info));
+                    log_warning("Failed to find a route for arc %d of net %s.\n", key.user_idx.idx(),
+                                ctx->nameOf(key.net_info));
 #ifndef NDEBUG
                     router.check();
                     ctx->check();
@@ -1220,8 +1308,8 @@ bool router1(Context *ctx, const Router1Cfg &cfg)
                 }
             } else {
                 if (!router.route_arc(arc, true)) {
-                    log_warning("Failed to find a route for arc %d of net %s.\n", arc.user_idx.idx(),
-                                ctx->nameOf(arc.net_info));
+                    log_warning("Failed to find a route for arc %d of net %s.\n", key.user_idx.idx(),
+                                ctx->nameOf(key.net_info));
 #ifndef NDEBUG
                     router.check();
                     ctx->check();
@@ -1232,6 +1320,7 @@ bool router1(Context *ctx, const Router1Cfg &cfg)
             // Timing driven ripup
             if (timing_ripup && router.arc_queue.empty() && timing_fail_count < 50) {
                 ++timing_fail_count;
+                ProfileScope prof_scope(ctx->profiler, "router1/timing");
                 router.tmg.run();
                 delay_t wns = 0, tns = 0;
                 if (timing_fail_count == 1)
@@ -1267,10 +1356,11 @@ bool router1(Context *ctx, const Router1Cfg &cfg)
                 log_info("    %d arcs ripped up due to negative slack WNS=%.02fns TNS=%.02fns.\n",
                          int(router.arc_queue.size()), ctx->getDelayNS(wns), ctx->getDelayNS(tns));
                 iter_cnt = 0;
-                router.wireScores.clear();
-                router.netScores.clear();
+                std::fill(router.wireScores.begin(), router.wireScores.end(), 0);
+                std::fill(router.netScores.begin(), router.netScores.end(), 0);
             }
         }
+        router.add_profile_counts();
         auto rend = std::chrono::high_resolution_clock::now();
         log_info("%10d | %8d %10d | %4d %5d | %9d| %10.02f %10.02f|\n", iter_cnt, router.arcs_with_ripup,
                  router.arcs_without_ripup, router.arcs_with_ripup - last_arcs_with_ripup,
@@ -29,11 +29,14 @@
 #include "router2.h"
 
 #include <algorithm>
+#include <atomic>
 #include <boost/container/flat_map.hpp>
 #include <chrono>
+#include <condition_variable>
 #include <deque>
 #include <fstream>
 #include <limits>
+#include <mutex>
 #include <queue>
 #include <set>
 
@@ -41,6 +44,7 @@
 #include "nextpnr.h"
 #include "router1.h"
 #include "scope_lock.h"
+#include "thread_pool.h"
 #include "timing.h"
 #include "util.h"
 
@@ -80,12 +84,27 @@ struct Router2
         float total() const { return cost + togo_cost; }
     };
 
+    // A* state for one wire while routing an arc
+    struct WireVisit
+    {
+        PipId pip_fwd, pip_bwd;
+        bool visited_fwd = false, visited_bwd = false;
+        float cost_fwd = 0.0, cost_bwd = 0.0;
+    };
+
     struct PerWireData
     {
+        PerWireData() = default;
+        // Only copied while setting up flat_wires, before any threads are running
+        PerWireData(const PerWireData &other)
+                : w(other.w), curr_cong(other.curr_cong.load()), hist_cong_cost(other.hist_cong_cost),
+                  unavailable(other.unavailable), reserved_net(other.reserved_net), x(other.x), y(other.y),
+                  spec_claims(other.spec_claims.load()), visit(other.visit) {};
+
         // nextpnr
         WireId w;
         // Historical congestion cost
-        int curr_cong = 0;
+        std::atomic<int> curr_cong{0};
         float hist_cong_cost = 1.0;
         // Wire is unavailable as locked to another arc
         bool unavailable = false;
@@ -93,10 +112,10 @@ struct Router2
         int reserved_net = -1;
         // The notional location of the wire, to guarantee thread safety
         int16_t x = 0, y = 0;
+        // Number of speculative routing threads that newly took this wire
+        std::atomic<int> spec_claims{0};
         // Visit data
-        PipId pip_fwd, pip_bwd;
-        bool visited_fwd = false, visited_bwd = false;
-        float cost_fwd = 0.0, cost_bwd = 0.0;
+        WireVisit visit;
     };
 
     Context *ctx;
@@ -106,6 +125,7 @@ struct Router2
     {
         tmg.setup_only = false;
         tmg.with_clock_skew = true;
+        tmg.incremental = true;
         tmg.setup();
     }
 
@@ -188,15 +208,23 @@ struct Router2
         }
     }
 
-    dict<WireId, int> wire_to_idx;
+    // Maps the arch's dense wire index to an index into flat_wires, or -1 for wires that aren't routable
+    std::vector<int> wire_to_idx;
     std::vector<PerWireData> flat_wires;
 
-    PerWireData &wire_data(WireId w) { return flat_wires[wire_to_idx.at(w)]; }
+    int get_wire_idx(WireId w) const
+    {
+        int idx = wire_to_idx[ctx->getWireIndex(w)];
+        NPNR_ASSERT(idx != -1);
+        return idx;
+    }
+    PerWireData &wire_data(WireId w) { return flat_wires[get_wire_idx(w)]; }
 
     void setup_wires()
     {
         // Set up per-wire structures, so that MT parts don't have to do any memory allocation
         // This is possibly quite wasteful and not cache-optimal; further consideration necessary
+        wire_to_idx.assign(ctx->getWireIndexCount(), -1);
         for (auto wire : ctx->getWires()) {
             PerWireData pwd;
             pwd.w = wire;
@@ -219,7 +247,7 @@ struct Router2
             pwd.x = (wire_loc.x0 + wire_loc.x1) / 2;
             pwd.y = (wire_loc.y0 + wire_loc.y1) / 2;
 
-            wire_to_idx[wire] = int(flat_wires.size());
+            wire_to_idx[ctx->getWireIndex(wire)] = int(flat_wires.size());
             flat_wires.push_back(pwd);
         }
 
@@ -262,6 +290,14 @@ struct Router2
 
     double curr_cong_weight, hist_cong_weight, estimate_weight;
 
+    // Changes to wire usage made by a speculative routing thread, indexed by wire, and the wires that have been changed
+    struct CongDelta
+    {
+        std::vector<int> delta;
+        std::vector<bool> is_touched;
+        std::vector<int> touched;
+    };
+
     struct ThreadContext
     {
         // Nets to route
@@ -282,11 +318,29 @@ struct Router2
 
         DeterministicRNG rng;
 
+        // In speculative mode, visit data and changes to wire usage are kept here rather than in flat_wires, so the
+        // thread routes against the congestion as it was at the start and doesn't see any other thread's routing.
+        // spec_visit is indexed by wire and reset using dirty_wires
+        bool speculative = false;
+        std::vector<WireVisit> spec_visit;
+        CongDelta cong_delta;
+
         // Used to add existing routing to the heap
         pool<WireId> in_wire_by_loc;
         dict<std::pair<int, int>, pool<WireId>> wire_by_loc;
+
+        // Work done, for the profiler
+        int64_t arcs_routed = 0, wires_explored = 0;
     };
 
+    void add_profile_counts(ThreadContext &t)
+    {
+        ctx->profiler.add_count("router2/arcs_routed", t.arcs_routed);
+        ctx->profiler.add_count("router2/wires_explored", t.wires_explored);
+        t.arcs_routed = 0;
+        t.wires_explored = 0;
+    }
+
     bool thread_test_wire(ThreadContext &t, PerWireData &w)
     {
         return w.x >= t.bb.x0 && w.x <= t.bb.x1 && w.y >= t.bb.y0 && w.y <= t.bb.y1;
@@ -313,7 +367,30 @@ struct Router2
             log(__VA_ARGS__);                                                                                          \
     } while (0)
 
-    void bind_pip_internal(PerNetData &net, store_index<PortRef> user, int wire, PipId pip)
+    // Number of nets using a wire, including any speculative changes not yet committed
+    int wire_cong(int wire, const CongDelta *cong_delta)
+    {
+        int cong = flat_wires[wire].curr_cong.load(std::memory_order_relaxed);
+        if (cong_delta != nullptr)
+            cong += cong_delta->delta[wire];
+        return cong;
+    }
+
+    void change_cong(int wire, int amount, CongDelta *cong_delta)
+    {
+        if (cong_delta != nullptr) {
+            cong_delta->delta[wire] += amount;
+            if (!cong_delta->is_touched[wire]) {
+                cong_delta->is_touched[wire] = true;
+                cong_delta->touched.push_back(wire);
+            }
+        } else {
+            flat_wires[wire].curr_cong.fetch_add(amount, std::memory_order_relaxed);
+        }
+    }
+
+    void bind_pip_internal(PerNetData &net, store_index<PortRef> user, int wire, PipId pip,
+                           CongDelta *cong_delta = nullptr)
     {
         auto &wd = flat_wires.at(wire);
         auto found = net.wires.find(wd.w);
@@ -321,7 +398,7 @@ struct Router2
             // Not yet used for any arcs of this net, add to list
             net.wires.emplace(wd.w, std::make_pair(pip, 1));
             // Increase bound count of wire by 1
-            ++wd.curr_cong;
+            change_cong(wire, 1, cong_delta);
         } else {
             // Already used for at least one other arc of this net
             // Don't allow two uphill PIPs for the same net and wire
@@ -331,19 +408,21 @@ struct Router2
         }
     }
 
-    void unbind_pip_internal(PerNetData &net, store_index<PortRef> user, WireId wire)
+    void unbind_pip_internal(PerNetData &net, store_index<PortRef> user, WireId wire,
+                             CongDelta *cong_delta = nullptr)
     {
-        auto &wd = wire_data(wire);
+        int wire_idx = get_wire_idx(wire);
+        auto &wd = flat_wires[wire_idx];
         auto &b = net.wires.at(wd.w);
         --b.second;
         if (b.second == 0) {
             // No remaining arcs of this net bound to this wire
-            --wd.curr_cong;
+            change_cong(wire_idx, -1, cong_delta);
             net.wires.erase(wd.w);
         }
     }
 
-    void ripup_arc(NetInfo *net, store_index<PortRef> user, size_t phys_pin)
+    void ripup_arc(NetInfo *net, store_index<PortRef> user, size_t phys_pin, CongDelta *cong_delta = nullptr)
     {
         auto &nd = nets.at(net->udata);
         auto &ad = nd.arcs.at(user.idx()).at(phys_pin);
@@ -354,19 +433,20 @@ struct Router2
         while (cursor != src &&
                (net->constant_value == IdString() || ctx->getWireConstantValue(cursor) == net->constant_value)) {
             PipId pip = nd.wires.at(cursor).first;
-            unbind_pip_internal(nd, user, cursor);
+            unbind_pip_internal(nd, user, cursor, cong_delta);
             cursor = ctx->getPipSrcWire(pip);
         }
         ad.routed = false;
     }
 
     float score_wire_for_arc(NetInfo *net, store_index<PortRef> user, size_t phys_pin, WireId wire, PipId pip,
-                             float crit_weight)
+                             float crit_weight, const CongDelta *cong_delta)
     {
-        auto &wd = wire_data(wire);
+        int wire_idx = get_wire_idx(wire);
+        auto &wd = flat_wires[wire_idx];
         auto &nd = nets.at(net->udata);
         float base_cost = cfg.get_base_cost(ctx, wire, pip, crit_weight);
-        int overuse = wd.curr_cong;
+        int overuse = wire_cong(wire_idx, cong_delta);
         float hist_cost = 1.0f + crit_weight * (wd.hist_cong_cost - 1.0f);
         float bias_cost = 0;
         int source_uses = 0;
@@ -396,15 +476,15 @@ struct Router2
         return (ctx->getDelayNS(est_delay) / (1 + source_uses * crit_weight)) + cfg.ipin_cost_adder;
     }
 
-    bool check_arc_routing(NetInfo *net, store_index<PortRef> usr, size_t phys_pin)
+    bool check_arc_routing(NetInfo *net, store_index<PortRef> usr, size_t phys_pin,
+                           const CongDelta *cong_delta = nullptr)
     {
         auto &nd = nets.at(net->udata);
         auto &ad = nd.arcs.at(usr.idx()).at(phys_pin);
         WireId src_wire = nets.at(net->udata).src_wire;
         WireId cursor = ad.sink_wire;
         while (nd.wires.count(cursor)) {
-            auto &wd = wire_data(cursor);
-            if (wd.curr_cong != 1)
+            if (wire_cong(get_wire_idx(cursor), cong_delta) != 1)
                 return false;
             auto &uh = nd.wires.at(cursor).first;
             if (uh == PipId())
@@ -423,7 +503,7 @@ struct Router2
         WireId src = nets.at(net->udata).src_wire;
         WireId cursor = ad.sink_wire;
         while (cursor != src) {
-            size_t wire_idx = wire_to_idx.at(cursor);
+            size_t wire_idx = get_wire_idx(cursor);
             PipId pip = nd.wires.at(cursor).first;
             bind_pip_internal(nd, usr, wire_idx, pip);
             cursor = ctx->getPipSrcWire(pip);
@@ -526,14 +606,8 @@ struct Router2
 
     void reset_wires(ThreadContext &t)
     {
-        for (auto w : t.dirty_wires) {
-            flat_wires[w].pip_fwd = PipId();
-            flat_wires[w].pip_bwd = PipId();
-            flat_wires[w].visited_fwd = false;
-            flat_wires[w].visited_bwd = false;
-            flat_wires[w].cost_fwd = 0.0;
-            flat_wires[w].cost_bwd = 0.0;
-        }
+        for (auto w : t.dirty_wires)
+            visit_data(t, w) = WireVisit();
         t.dirty_wires.clear();
     }
 
@@ -563,32 +637,39 @@ struct Router2
     }
 
     // Functions for marking wires as visited, and checking if they have already been visited
+    WireVisit &visit_data(ThreadContext &t, int wire)
+    {
+        return t.speculative ? t.spec_visit.at(wire) : flat_wires.at(wire).visit;
+    }
+
     void set_visited_fwd(ThreadContext &t, int wire, PipId pip, float cost)
     {
-        auto &wd = flat_wires.at(wire);
-        if (!wd.visited_fwd && !wd.visited_bwd)
+        auto &v = visit_data(t, wire);
+        if (!v.visited_fwd && !v.visited_bwd)
             t.dirty_wires.push_back(wire);
-        wd.pip_fwd = pip;
-        wd.visited_fwd = true;
-        wd.cost_fwd = cost;
+        v.pip_fwd = pip;
+        v.visited_fwd = true;
+        v.cost_fwd = cost;
     }
     void set_visited_bwd(ThreadContext &t, int wire, PipId pip, float cost)
     {
-        auto &wd = flat_wires.at(wire);
-        if (!wd.visited_fwd && !wd.visited_bwd)
+        auto &v = visit_data(t, wire);
+        if (!v.visited_fwd && !v.visited_bwd)
             t.dirty_wires.push_back(wire);
-        wd.pip_bwd = pip;
-        wd.visited_bwd = true;
-        wd.cost_bwd = cost;
+        v.pip_bwd = pip;
+        v.visited_bwd = true;
+        v.cost_bwd = cost;
     }
 
-    bool was_visited_fwd(int wire, float cost)
+    bool was_visited_fwd(ThreadContext &t, int wire, float cost)
     {
-        return flat_wires.at(wire).visited_fwd && flat_wires.at(wire).cost_fwd <= cost;
+        const WireVisit &v = visit_data(t, wire);
+        return v.visited_fwd && v.cost_fwd <= cost;
     }
-    bool was_visited_bwd(int wire, float cost)
+    bool was_visited_bwd(ThreadContext &t, int wire, float cost)
     {
-        return flat_wires.at(wire).visited_bwd && flat_wires.at(wire).cost_bwd <= cost;
+        const WireVisit &v = visit_data(t, wire);
+        return v.visited_bwd && v.cost_bwd <= cost;
     }
 
     float get_arc_crit(NetInfo *net, store_index<PortRef> i)
@@ -613,6 +694,7 @@ struct Router2
         auto &ad = nd.arcs.at(i.idx()).at(phys_pin);
         auto &usr = net->users.at(i);
         bool const_mode = is_dedi_const_net(net);
+        CongDelta *cong_delta = t.speculative ? &t.cong_delta : nullptr;
         ROUTE_LOG_DBG("Routing arc %d of net '%s' (%d, %d) -> (%d, %d)\n", i.idx(), ctx->nameOf(net), ad.bb.x0,
                       ad.bb.y0, ad.bb.x1, ad.bb.y1);
         WireId src_wire = ctx->getNetinfoSourceWire(net), dst_wire = ctx->getNetinfoSinkWire(net, usr, phys_pin);
@@ -622,8 +704,8 @@ struct Router2
         if (dst_wire == WireId())
             ARC_LOG_ERR("No wire found for port %s on destination cell %s.\n", ctx->nameOf(usr.port),
                         ctx->nameOf(usr.cell));
-        int src_wire_idx = const_mode ? -1 : wire_to_idx.at(src_wire);
-        int dst_wire_idx = wire_to_idx.at(dst_wire);
+        int src_wire_idx = const_mode ? -1 : get_wire_idx(src_wire);
+        int dst_wire_idx = get_wire_idx(dst_wire);
         // Calculate a timing weight based on criticality
         float crit = get_arc_crit(net, i);
         float crit_weight = std::max<float>(0.05f, (1.0f - std::pow(crit, 2)));
@@ -663,7 +745,7 @@ struct Router2
                 WireScore base_score;
                 base_score.delay = 0;
                 base_score.cost = 0;
-                int wire_idx = wire_to_idx.at(wire);
+                int wire_idx = get_wire_idx(wire);
                 base_score.togo_cost = get_togo_cost(net, i, wire_idx, dst_wire, false, crit_weight);
                 t.fwd_queue.push(QueuedWire(wire_idx, base_score));
                 set_visited_fwd(t, wire_idx, PipId(), 0.0);
@@ -695,7 +777,7 @@ struct Router2
                 WireScore base_score;
                 base_score.delay = 0;
                 base_score.cost = 0;
-                int wire_idx = wire_to_idx.at(wire);
+                int wire_idx = get_wire_idx(wire);
                 base_score.togo_cost = get_togo_cost(net, i, wire_idx, src_wire, true, crit_weight);
                 t.bwd_queue.push(QueuedWire(wire_idx, base_score));
                 set_visited_bwd(t, wire_idx, PipId(), 0.0);
@@ -717,7 +799,7 @@ struct Router2
                     auto curr = t.fwd_queue.top();
                     t.fwd_queue.pop();
                     ++explored;
-                    if (was_visited_bwd(curr.wire, std::numeric_limits<float>::max())) {
+                    if (was_visited_bwd(t, curr.wire, std::numeric_limits<float>::max())) {
                         // Meet in the middle; done
                         midpoint_wire = curr.wire;
                         break;
@@ -730,13 +812,14 @@ struct Router2
                         if (!ctx->checkPipAvailForNet(dh, net))
                             continue;
                         WireId next = ctx->getPipDstWire(dh);
-                        int next_idx = wire_to_idx.at(next);
+                        int next_idx = get_wire_idx(next);
                         WireScore next_score;
                         next_score.delay = curr.score.delay + cfg.get_base_cost(ctx, next, dh, crit_weight);
-                        next_score.cost = curr.score.cost + score_wire_for_arc(net, i, phys_pin, next, dh, crit_weight);
+                        next_score.cost = curr.score.cost +
+                                          score_wire_for_arc(net, i, phys_pin, next, dh, crit_weight, cong_delta);
                         next_score.togo_cost =
                                 cfg.estimate_weight * get_togo_cost(net, i, next_idx, dst_wire, false, crit_weight);
-                        if (was_visited_fwd(next_idx, next_score.delay)) {
+                        if (was_visited_fwd(t, next_idx, next_score.delay)) {
                             // Don't expand the same node twice.
                             continue;
                         }
@@ -762,7 +845,7 @@ struct Router2
                     t.bwd_queue.pop();
                     ++explored;
                     auto &curr_data = flat_wires.at(curr.wire);
-                    if (was_visited_fwd(curr.wire, std::numeric_limits<float>::max()) ||
+                    if (was_visited_fwd(t, curr.wire, std::numeric_limits<float>::max()) ||
                         (const_mode && ctx->getWireConstantValue(curr_data.w) == net->constant_value)) {
                         // Meet in the middle; done
                         midpoint_wire = curr.wire;
@@ -782,15 +865,16 @@ struct Router2
                         if (!ctx->checkPipAvailForNet(uh, net))
                             continue;
                         WireId next = ctx->getPipSrcWire(uh);
-                        int next_idx = wire_to_idx.at(next);
+                        int next_idx = get_wire_idx(next);
                         WireScore next_score;
                         next_score.delay = curr.score.delay + cfg.get_base_cost(ctx, next, uh, crit_weight);
-                        next_score.cost = curr.score.cost + score_wire_for_arc(net, i, phys_pin, next, uh, crit_weight);
+                        next_score.cost = curr.score.cost +
+                                          score_wire_for_arc(net, i, phys_pin, next, uh, crit_weight, cong_delta);
                         next_score.togo_cost = const_mode
                                                        ? 0
                                                        : cfg.estimate_weight * get_togo_cost(net, i, next_idx, src_wire,
                                                                                              true, crit_weight);
-                        if (was_visited_bwd(next_idx, next_score.delay)) {
+                        if (was_visited_bwd(t, next_idx, next_score.delay)) {
                             // Don't expand the same node twice.
                             continue;
                         }
@@ -810,18 +894,20 @@ struct Router2
             if (midpoint_wire != -1)
                 break;
         }
+        ++t.arcs_routed;
+        t.wires_explored += explored;
         ArcRouteResult result = ARC_SUCCESS;
         if (midpoint_wire != -1) {
             ROUTE_LOG_DBG("   Routed (explored %d wires): ", explored);
             if (const_mode) {
-                bind_pip_internal(nd, i, midpoint_wire, PipId());
+                bind_pip_internal(nd, i, midpoint_wire, PipId(), cong_delta);
             } else {
                 int cursor_bwd = midpoint_wire;
-                while (was_visited_fwd(cursor_bwd, std::numeric_limits<float>::max())) {
-                    PipId pip = flat_wires.at(cursor_bwd).pip_fwd;
+                while (was_visited_fwd(t, cursor_bwd, std::numeric_limits<float>::max())) {
+                    PipId pip = visit_data(t, cursor_bwd).pip_fwd;
                     if (pip == PipId() && cursor_bwd != src_wire_idx)
                         break;
-                    bind_pip_internal(nd, i, cursor_bwd, pip);
+                    bind_pip_internal(nd, i, cursor_bwd, pip, cong_delta);
                     if (ctx->debug && !is_mt) {
                         auto &wd = flat_wires.at(cursor_bwd);
                         ROUTE_LOG_DBG("      fwd wire: %s (curr %d hist %f share %d)\n", ctx->nameOfWire(wd.w),
@@ -832,7 +918,7 @@ struct Router2
                     }
                     ROUTE_LOG_DBG("         fwd pip: %s (%d, %d)\n", ctx->nameOfPip(pip), ctx->getPipLocation(pip).x,
                                   ctx->getPipLocation(pip).y);
-                    cursor_bwd = wire_to_idx.at(ctx->getPipSrcWire(pip));
+                    cursor_bwd = get_wire_idx(ctx->getPipSrcWire(pip));
                 }
 
                 while (cursor_bwd != src_wire_idx) {
@@ -847,25 +933,25 @@ struct Router2
                         ROUTE_LOG_DBG("      ext wire: %s (curr %d hist %f share %d)\n", ctx->nameOfWire(wd.w),
                                       wd.curr_cong - 1, wd.hist_cong_cost, bound.second);
                     }
-                    bind_pip_internal(nd, i, cursor_bwd, pip);
+                    bind_pip_internal(nd, i, cursor_bwd, pip, cong_delta);
                     if (pip == PipId())
                         break;
-                    cursor_bwd = wire_to_idx.at(ctx->getPipSrcWire(pip));
+                    cursor_bwd = get_wire_idx(ctx->getPipSrcWire(pip));
                 }
 
                 NPNR_ASSERT(cursor_bwd == src_wire_idx);
             }
 
             int cursor_fwd = midpoint_wire;
-            while (was_visited_bwd(cursor_fwd, std::numeric_limits<float>::max())) {
-                PipId pip = flat_wires.at(cursor_fwd).pip_bwd;
+            while (was_visited_bwd(t, cursor_fwd, std::numeric_limits<float>::max())) {
+                PipId pip = visit_data(t, cursor_fwd).pip_bwd;
                 if (pip == PipId()) {
                     break;
                 }
                 ROUTE_LOG_DBG("         bwd pip: %s (%d, %d)\n", ctx->nameOfPip(pip), ctx->getPipLocation(pip).x,
                               ctx->getPipLocation(pip).y);
-                cursor_fwd = wire_to_idx.at(ctx->getPipDstWire(pip));
-                bind_pip_internal(nd, i, cursor_fwd, pip);
+                cursor_fwd = get_wire_idx(ctx->getPipDstWire(pip));
+                bind_pip_internal(nd, i, cursor_fwd, pip, cong_delta);
                 if (ctx->debug && !is_mt) {
                     auto &wd = flat_wires.at(cursor_fwd);
                     ROUTE_LOG_DBG("      bwd wire: %s (curr %d hist %f share %d)\n", ctx->nameOfWire(wd.w),
@@ -913,6 +999,7 @@ struct Router2
         t.wire_by_loc.clear();
         t.in_wire_by_loc.clear();
         auto &nd = nets.at(net->udata);
+        CongDelta *cong_delta = t.speculative ? &t.cong_delta : nullptr;
         bool failed_slack = false;
         for (auto usr : net->users.enumerate())
             failed_slack |= arc_failed_slack(net, usr.index);
@@ -921,13 +1008,13 @@ struct Router2
             for (size_t j = 0; j < ad.size(); j++) {
                 // Ripup failed arcs to start with
                 // Check if arc is already legally routed
-                if (!failed_slack && check_arc_routing(net, usr.index, j)) {
+                if (!failed_slack && check_arc_routing(net, usr.index, j, cong_delta)) {
                     update_wire_by_loc(t, net, usr.index, j, true);
                     continue;
                 }
 
                 // Ripup arc to start with
-                ripup_arc(net, usr.index, j);
+                ripup_arc(net, usr.index, j, cong_delta);
                 t.route_arcs.emplace_back(usr.index, j);
             }
         }
@@ -1212,51 +1299,70 @@ struct Router2
         }
     }
 
-    int mid_x = 0, mid_y = 0;
+    // The multithreaded part of routing works on a tree of regions. The root covers the whole device, and every
+    // other node covers one half of its parent's region. Each node owns the nets that fit inside its region but
+    // cross the split between its children. A node becomes ready to route once both of its children are done, as
+    // at that point nothing else is touching wires inside its region.
+    struct RoutePartition
+    {
+        int parent = -1;
+        // Children that still need routing before this partition is ready
+        int pending = 0;
+    };
 
-    void partition_nets()
+    int add_partition(std::vector<ThreadContext> &tcs, std::vector<RoutePartition> &parts, BoundingBox bb,
+                      int parent, std::vector<int> region_nets, int workers)
     {
-        // Create a histogram of positions in X and Y positions
-        std::map<int, int> cxs, cys;
-        for (auto &n : nets) {
-            if (n.cx != -1)
-                ++cxs[n.cx];
-            if (n.cy != -1)
-                ++cys[n.cy];
+        int idx = int(parts.size());
+        parts.emplace_back();
+        parts.back().parent = parent;
+        tcs.emplace_back();
+        tcs.back().bb = bb;
+        tcs.back().rng.rngseed(ctx->rng64());
+        // Split along the longer side of the part of the region that is actually on the device
+        int x1 = std::min(bb.x1, ctx->getGridDimX()), y1 = std::min(bb.y1, ctx->getGridDimY());
+        bool split_x = (x1 - bb.x0) >= (y1 - bb.y0);
+        int lo = split_x ? bb.x0 : bb.y0, hi = split_x ? x1 : y1;
+        // Don't split regions with fewer than 50 nets (heuristic)
+        if (workers < 2 || region_nets.size() < 50 || (hi - lo) < 4) {
+            for (int n : region_nets)
+                tcs.at(idx).route_nets.push_back(nets_by_udata.at(n));
+            return idx;
         }
-        // 4-way split for now
-        int accum_x = 0, accum_y = 0;
-        int halfway = int(nets.size()) / 2;
-        for (auto &p : cxs) {
-            if (accum_x < halfway && (accum_x + p.second) >= halfway)
-                mid_x = p.first;
-            accum_x += p.second;
+        // Split so that net centres are divided in proportion to the number of workers on each side
+        int lo_workers = workers / 2;
+        std::vector<int> centres;
+        for (int n : region_nets) {
+            auto &nbb = nets.at(n).bb;
+            centres.push_back(split_x ? (nbb.x0 + nbb.x1) / 2 : (nbb.y0 + nbb.y1) / 2);
         }
-        for (auto &p : cys) {
-            if (accum_y < halfway && (accum_y + p.second) >= halfway)
-                mid_y = p.first;
-            accum_y += p.second;
-        }
-        if (ctx->verbose) {
-            log_info("    x splitpoint: %d\n", mid_x);
-            log_info("    y splitpoint: %d\n", mid_y);
-        }
-        std::vector<int> bins(5, 0);
-        for (auto &n : nets) {
-            if (n.bb.x0 < mid_x && n.bb.x1 < mid_x && n.bb.y0 < mid_y && n.bb.y1 < mid_y)
-                ++bins[0]; // TL
-            else if (n.bb.x0 >= mid_x && n.bb.x1 >= mid_x && n.bb.y0 < mid_y && n.bb.y1 < mid_y)
-                ++bins[1]; // TR
-            else if (n.bb.x0 < mid_x && n.bb.x1 < mid_x && n.bb.y0 >= mid_y && n.bb.y1 >= mid_y)
-                ++bins[2]; // BL
-            else if (n.bb.x0 >= mid_x && n.bb.x1 >= mid_x && n.bb.y0 >= mid_y && n.bb.y1 >= mid_y)
-                ++bins[3]; // BR
+        auto nth = centres.begin() + (centres.size() * lo_workers) / workers;
+        std::nth_element(centres.begin(), nth, centres.end());
+        int split = std::max(lo + 1, std::min(*nth, hi - 2));
+        std::vector<int> lo_nets, hi_nets;
+        for (int n : region_nets) {
+            auto &nbb = nets.at(n).bb;
+            int n0 = split_x ? nbb.x0 : nbb.y0, n1 = split_x ? nbb.x1 : nbb.y1;
+            // Keep a tile of margin to the split, as wire locations are only notional
+            if (n1 < split)
+                lo_nets.push_back(n);
+            else if (n0 > split + 1)
+                hi_nets.push_back(n);
             else
-                ++bins[4]; // cross-boundary
+                tcs.at(idx).route_nets.push_back(nets_by_udata.at(n));
         }
-        if (ctx->verbose)
-            for (int i = 0; i < 5; i++)
-                log_info("        bin %d N=%d\n", i, bins[i]);
+        BoundingBox lo_bb = bb, hi_bb = bb;
+        if (split_x) {
+            lo_bb.x1 = split;
+            hi_bb.x0 = split + 1;
+        } else {
+            lo_bb.y1 = split;
+            hi_bb.y0 = split + 1;
+        }
+        parts.at(idx).pending = 2;
+        add_partition(tcs, parts, lo_bb, idx, std::move(lo_nets), lo_workers);
+        add_partition(tcs, parts, hi_bb, idx, std::move(hi_nets), workers - lo_workers);
+        return idx;
     }
 
     void router_thread(ThreadContext &t, bool is_mt)
@@ -1268,6 +1374,141 @@ struct Router2
         }
     }
 
+#ifndef NPNR_DISABLE_THREADS
+    void run_partitions(std::vector<ThreadContext> &tcs, std::vector<RoutePartition> &parts)
+    {
+        // Idle workers take the next ready partition from a shared queue. Partitions that can be routed at the same
+        // time never overlap and each has its own RNG, so the result doesn't depend on which worker routes what.
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<int> ready;
+        // The root is left for the single-threaded part of routing
+        int remaining = int(parts.size()) - 1;
+        for (int i = 1; i < int(parts.size()); i++)
+            if (parts.at(i).pending == 0)
+                ready.push_back(i);
+        int thread_count = std::min(cfg.threads, int(ready.size()));
+        auto worker = [&]() {
+            std::unique_lock<std::mutex> lk(mutex);
+            while (true) {
+                cv.wait(lk, [&] { return !ready.empty() || remaining == 0; });
+                if (ready.empty())
+                    break;
+                int idx = ready.front();
+                ready.pop_front();
+                lk.unlock();
+                router_thread(tcs.at(idx), /*is_mt=*/true);
+                lk.lock();
+                --remaining;
+                int parent = parts.at(idx).parent;
+                if (parent > 0 && --parts.at(parent).pending == 0)
+                    ready.push_back(parent);
+                cv.notify_all();
+            }
+        };
+        std::vector<boost::thread> threads;
+        for (int i = 0; i < thread_count; i++)
+            threads.emplace_back(worker);
+        for (auto &t : threads)
+            t.join();
+    }
+#endif
+
+    bool has_spec_conflict(NetInfo *net)
+    {
+        for (auto &w : nets.at(net->udata).wires) {
+            auto &wd = wire_data(w.first);
+            if (wd.spec_claims > 1 && wd.curr_cong > 1)
+                return true;
+        }
+        return false;
+    }
+
+#ifndef NPNR_DISABLE_THREADS
+    // The per-thread state for speculative routing is sized by the number of wires, so it is allocated once here and
+    // reused by every iteration, which only clears the wires it touched
+    std::vector<ThreadContext> spec_tcs;
+    std::unique_ptr<ThreadPool> spec_pool;
+
+    void setup_speculative()
+    {
+        if (!cfg.speculative || cfg.threads <= 1)
+            return;
+        spec_tcs.resize(cfg.threads);
+        for (auto &t : spec_tcs) {
+            t.speculative = true;
+            t.bb = BoundingBox(0, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+            t.spec_visit.resize(flat_wires.size());
+            t.cong_delta.delta.resize(flat_wires.size(), 0);
+            t.cong_delta.is_touched.resize(flat_wires.size(), false);
+        }
+        spec_pool = std::make_unique<ThreadPool>(cfg.threads);
+    }
+
+    // Nets that cross the top-level split are first routed in parallel, with every thread working against the
+    // congestion as it was at the start plus its own routing. The changes to wire usage are then committed to the
+    // atomic per-wire counters, counting how many threads newly took each wire. Only nets that are left overusing a
+    // wire that more than one thread took, or that failed to route within their bounding box, are then rerouted in
+    // the singlethreaded part; route_net only rips up the arcs of those nets that aren't legally routed. As threads
+    // never see each other's routing, the result depends on the thread count but not on timing.
+    void route_speculative(ThreadContext &st)
+    {
+        int thread_count = std::min(int(spec_tcs.size()), int(st.route_nets.size()));
+        for (int i = 0; i < thread_count; i++) {
+            auto &t = spec_tcs.at(i);
+            t.route_nets.clear();
+            t.failed_nets.clear();
+            t.rng.rngseed(ctx->rng64());
+        }
+        // Deal nets out in turn, so each thread gets a similar mix of large and small nets
+        for (size_t i = 0; i < st.route_nets.size(); i++)
+            spec_tcs.at(i % thread_count).route_nets.push_back(st.route_nets.at(i));
+
+        spec_pool->run(thread_count, [&](int i) { router_thread(spec_tcs.at(i), /*is_mt=*/true); });
+        for (int i = 0; i < thread_count; i++)
+            add_profile_counts(spec_tcs.at(i));
+        // Commit, now that nothing is reading curr_cong any more
+        spec_pool->run(thread_count, [&](int i) {
+            auto &t = spec_tcs.at(i);
+            for (int wire : t.cong_delta.touched) {
+                int delta = t.cong_delta.delta.at(wire);
+                if (delta == 0)
+                    continue;
+                auto &wd = flat_wires.at(wire);
+                wd.curr_cong.fetch_add(delta);
+                if (delta > 0)
+                    wd.spec_claims.fetch_add(1);
+            }
+        });
+
+        // Reroute conflicting nets in the order they would have been routed serially. Once one side of a conflict
+        // has been rerouted, the other side usually no longer overuses the wire and can be kept as it is
+        std::vector<bool> spec_failed(nets.size(), false);
+        for (int i = 0; i < thread_count; i++)
+            for (auto net : spec_tcs.at(i).failed_nets)
+                spec_failed.at(net->udata) = true;
+        int rerouted = 0;
+        for (auto net : st.route_nets) {
+            if (!spec_failed.at(net->udata) && !has_spec_conflict(net))
+                continue;
+            route_net(st, net, false);
+            ++rerouted;
+        }
+        // Leave the per-thread state clean for the next iteration, clearing only the wires that were touched
+        for (int i = 0; i < thread_count; i++) {
+            auto &cd = spec_tcs.at(i).cong_delta;
+            for (int wire : cd.touched) {
+                flat_wires.at(wire).spec_claims = 0;
+                cd.delta.at(wire) = 0;
+                cd.is_touched.at(wire) = false;
+            }
+            cd.touched.clear();
+        }
+        if (ctx->verbose)
+            log_info("%d/%d speculatively routed nets rerouted serially\n", rerouted, int(st.route_nets.size()));
+    }
+#endif
+
     void do_route()
     {
         // Don't multithread if fewer than 200 nets (heuristic)
@@ -1278,105 +1519,41 @@ struct Router2
             for (size_t j = 0; j < route_queue.size(); j++) {
                 route_net(st, nets_by_udata[route_queue[j]], false);
             }
+            add_profile_counts(st);
             return;
         }
-        const int Nq = 4, Nv = 2, Nh = 2;
-        const int N = Nq + Nv + Nh;
-        std::vector<ThreadContext> tcs(N + 1);
-        for (auto &th : tcs) {
-            th.rng.rngseed(ctx->rng64());
-        }
-        int le_x = mid_x;
-        int rs_x = mid_x;
-        int le_y = mid_y;
-        int rs_y = mid_y;
-        // Set up thread bounding boxes
-        tcs.at(0).bb = BoundingBox(0, 0, mid_x, mid_y);
-        tcs.at(1).bb = BoundingBox(mid_x + 1, 0, std::numeric_limits<int>::max(), le_y);
-        tcs.at(2).bb = BoundingBox(0, mid_y + 1, mid_x, std::numeric_limits<int>::max());
-        tcs.at(3).bb =
-                BoundingBox(mid_x + 1, mid_y + 1, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
-
-        tcs.at(4).bb = BoundingBox(0, 0, std::numeric_limits<int>::max(), mid_y);
-        tcs.at(5).bb = BoundingBox(0, mid_y + 1, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
-
-        tcs.at(6).bb = BoundingBox(0, 0, mid_x, std::numeric_limits<int>::max());
-        tcs.at(7).bb = BoundingBox(mid_x + 1, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
-
-        tcs.at(8).bb = BoundingBox(0, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
-
-        for (auto n : route_queue) {
-            auto &nd = nets.at(n);
-            auto ni = nets_by_udata.at(n);
-            int bin = N;
-            // Quadrants
-            if (nd.bb.x0 < le_x && nd.bb.x1 < le_x && nd.bb.y0 < le_y && nd.bb.y1 < le_y)
-                bin = 0;
-            else if (nd.bb.x0 >= rs_x && nd.bb.x1 >= rs_x && nd.bb.y0 < le_y && nd.bb.y1 < le_y)
-                bin = 1;
-            else if (nd.bb.x0 < le_x && nd.bb.x1 < le_x && nd.bb.y0 >= rs_y && nd.bb.y1 >= rs_y)
-                bin = 2;
-            else if (nd.bb.x0 >= rs_x && nd.bb.x1 >= rs_x && nd.bb.y0 >= rs_y && nd.bb.y1 >= rs_y)
-                bin = 3;
-            // Vertical split
-            else if (nd.bb.y0 < le_y && nd.bb.y1 < le_y)
-                bin = Nq + 0;
-            else if (nd.bb.y0 >= rs_y && nd.bb.y1 >= rs_y)
-                bin = Nq + 1;
-            // Horizontal split
-            else if (nd.bb.x0 < le_x && nd.bb.x1 < le_x)
-                bin = Nq + Nv + 0;
-            else if (nd.bb.x0 >= rs_x && nd.bb.x1 >= rs_x)
-                bin = Nq + Nv + 1;
-            tcs.at(bin).route_nets.push_back(ni);
-        }
+        std::vector<ThreadContext> tcs;
+        std::vector<RoutePartition> parts;
+        add_partition(tcs, parts,
+                      BoundingBox(0, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max()), -1,
+                      route_queue, cfg.threads);
         if (ctx->verbose)
-            log_info("%d/%d nets not multi-threadable\n", int(tcs.at(N).route_nets.size()), int(route_queue.size()));
+            log_info("%d/%d nets not multi-threadable (%d partitions)\n", int(tcs.at(0).route_nets.size()),
+                     int(route_queue.size()), int(parts.size()));
 #ifdef NPNR_DISABLE_THREADS
-        // Singlethreaded routing - quadrants
-        for (int i = 0; i < Nq; i++) {
-            router_thread(tcs.at(i), /*is_mt=*/false);
-        }
-        // Vertical splits
-        for (int i = Nq; i < Nq + Nv; i++) {
-            router_thread(tcs.at(i), /*is_mt=*/false);
-        }
-        // Horizontal splits
-        for (int i = Nq + Nv; i < Nq + Nv + Nh; i++) {
+        // Singlethreaded routing - partitions are always created after their parent, so this routes children first
+        for (int i = int(parts.size()) - 1; i > 0; i--)
             router_thread(tcs.at(i), /*is_mt=*/false);
-        }
 #else
-        // Multithreaded part of routing - quadrants
-        std::vector<boost::thread> threads;
-        for (int i = 0; i < Nq; i++) {
-            threads.emplace_back([this, &tcs, i]() { router_thread(tcs.at(i), /*is_mt=*/true); });
-        }
-        for (auto &t : threads)
-            t.join();
-        threads.clear();
-        // Vertical splits
-        for (int i = Nq; i < Nq + Nv; i++) {
-            threads.emplace_back([this, &tcs, i]() { router_thread(tcs.at(i), /*is_mt=*/true); });
-        }
-        for (auto &t : threads)
-            t.join();
-        threads.clear();
-        // Horizontal splits
-        for (int i = Nq + Nv; i < Nq + Nv + Nh; i++) {
-            threads.emplace_back([this, &tcs, i]() { router_thread(tcs.at(i), /*is_mt=*/true); });
-        }
-        for (auto &t : threads)
-            t.join();
-        threads.clear();
+        run_partitions(tcs, parts);
 #endif
-        // Singlethreaded part of routing - nets that cross partitions
+        // Singlethreaded part of routing - nets that cross the top-level split
         // or don't fit within bounding box
-        for (auto st_net : tcs.at(N).route_nets)
-            route_net(tcs.at(N), st_net, false);
+        auto &st = tcs.at(0);
+#ifndef NPNR_DISABLE_THREADS
+        // Don't bother routing these speculatively if there are fewer than 50 of them (heuristic)
+        if (cfg.speculative && cfg.threads > 1 && st.route_nets.size() >= 50)
+            route_speculative(st);
+        else
+#endif
+            for (auto st_net : st.route_nets)
+                route_net(st, st_net, false);
         // Failed nets
-        for (int i = 0; i < N; i++)
+        for (size_t i = 1; i < tcs.size(); i++)
             for (auto fail : tcs.at(i).failed_nets)
-                route_net(tcs.at(N), fail, false);
+                route_net(st, fail, false);
+        for (auto &t : tcs)
+            add_profile_counts(t);
     }
 
     delay_t get_route_delay(int net, store_index<PortRef> usr_idx, int phys_idx)
@@ -1428,8 +1605,10 @@ struct Router2
         auto rstart = std::chrono::high_resolution_clock::now();
         setup_nets();
         setup_wires();
+#ifndef NPNR_DISABLE_THREADS
+        setup_speculative();
+#endif
         find_all_reserved_wires();
-        partition_nets();
         curr_cong_weight = cfg.init_curr_cong_weight;
         hist_cong_weight = cfg.hist_cong_weight;
         ThreadContext st;
@@ -1465,7 +1644,11 @@ struct Router2
                                  [&](int na, int nb) { return nets.at(na).max_crit > nets.at(nb).max_crit; });
             }
 
-            do_route();
+            ProfileScope prof_iter(ctx->profiler, "router2/iter");
+            {
+                ProfileScope prof_scope(ctx->profiler, "router2/route");
+                do_route();
+            }
             update_route_delays();
             route_queue.clear();
             update_congestion();
@@ -1497,8 +1680,10 @@ struct Router2
                 }
             }
             int tmgfail = 0;
-            if (timing_driven)
+            if (timing_driven) {
+                ProfileScope prof_scope(ctx->profiler, "router2/timing");
                 tmg.run(false);
+            }
             if (timing_driven_ripup && iter < 1500) {
                 for (size_t i = 0; i < nets_by_udata.size(); i++) {
                     NetInfo *ni = nets_by_udata.at(i);
@@ -1580,6 +1765,8 @@ Router2Cfg::Router2Cfg(Context *ctx)
         estimate_weight = ctx->setting<float>("router2/estimateWeight", 1.25f);
     }
     perf_profile = ctx->setting<bool>("router2/perfProfile", false);
+    threads = std::max(1, ctx->setting<int>("threads", 8));
+    speculative = ctx->setting<bool>("router2/speculative", false);
     if (ctx->settings.count(ctx->id("router2/heatmap")))
         heatmap = ctx->settings.at(ctx->id("router2/heatmap")).as_string();
     else
@@ -57,6 +57,13 @@ struct Router2Cfg
     // Print additional performance profiling information
     bool perf_profile = false;
 
+    // Number of worker threads, and so of regions, for the multithreaded part of routing
+    int threads;
+    // Route nets that cross region boundaries in parallel against a congestion snapshot, then reroute serially
+    // only the nets that conflict. Off unless --router2-speculative is given, as it keeps per-thread state the size of
+    // the routing graph
+    bool speculative;
+
     std::string heatmap;
     std::function<float(Context *ctx, WireId wire, PipId pip, float crit_weight)> get_base_cost = default_base_cost;
 };
@@ -446,34 +446,26 @@ struct ECP5Bitgen
         if (ctx->args.type == ArchArgs::LFE5U_12F || ctx->args.type == ArchArgs::LFE5U_25F ||
             ctx->args.type == ArchArgs::LFE5U_45F || ctx->args.type == ArchArgs::LFE5U_85F) {
             std::map<std::string, std::string> tiletype_xform;
-            for (const auto &tile : cc.tiles) {
-                std::string newname = tile.first;
-                auto cibdcu = tile.first.find("CIB_DCU");
+            for (const auto &tile : cc.tiles.names()) {
+                std::string newname = tile;
+                auto cibdcu = tile.find("CIB_DCU");
                 if (cibdcu != std::string::npos) {
                     // Add the V
                     if (newname.at(cibdcu - 1) != 'V') {
                         newname.insert(cibdcu, 1, 'V');
-                        tiletype_xform[tile.first] = newname;
+                        tiletype_xform[tile] = newname;
                     }
-                } else if (boost::ends_with(tile.first, "BMID_0H")) {
+                } else if (boost::ends_with(tile, "BMID_0H")) {
                     newname.back() = 'V';
-                    tiletype_xform[tile.first] = newname;
-                } else if (boost::ends_with(tile.first, "BMID_2")) {
+                    tiletype_xform[tile] = newname;
+                } else if (boost::ends_with(tile, "BMID_2")) {
                     newname.push_back('V');
-                    tiletype_xform[tile.first] = newname;
+                    tiletype_xform[tile] = newname;
                 }
             }
             // Apply the name changes
             for (auto xform : tiletype_xform) {
-                auto &existing = cc.tiles.at(xform.first);
-                for (const auto &carc : existing.carcs)
-                    cc.tiles[xform.second].carcs.push_back(carc);
-                for (const auto &cenum : existing.cenums)
-                    cc.tiles[xform.second].cenums.push_back(cenum);
-                for (const auto &cword : existing.cwords)
-                    cc.tiles[xform.second].cwords.push_back(cword);
-                for (const auto &cunknown : existing.cunknowns)
-                    cc.tiles[xform.second].cunknowns.push_back(cunknown);
+                cc.tiles[xform.second].add_config(cc.tiles.at(xform.first));
                 cc.tiles.erase(xform.first);
             }
             for (auto &tg : cc.tilegroups) {
@@ -964,7 +956,7 @@ struct ECP5Bitgen
         if (cen != nullptr) {
             std::string belname = ctx->loc_info(ci->bel)->bel_data[ci->bel.index].name.get();
             Loc loc = ctx->getBelLocation(ci->bel);
-            TileGroup tg;
+            TileGroup tg(cc.strings.get());
             switch (belname[0]) {
             case 'B':
                 tg.tiles.push_back(
@@ -993,7 +985,7 @@ struct ECP5Bitgen
 
     void write_bram(CellInfo *ci)
     {
-        TileGroup tg;
+        TileGroup tg(cc.strings.get());
         Loc loc = ctx->getBelLocation(ci->bel);
         tg.tiles = get_bram_tiles(ci->bel);
         std::string ebr = "EBR" + std::to_string(loc.z);
@@ -1105,7 +1097,7 @@ struct ECP5Bitgen
 
     void write_mult18(CellInfo *ci)
     {
-        TileGroup tg;
+        TileGroup tg(cc.strings.get());
         Loc loc = ctx->getBelLocation(ci->bel);
         tg.tiles = get_dsp_tiles(ci->bel);
         std::string dsp = "MULT18_" + std::to_string(loc.z);
@@ -1154,7 +1146,7 @@ struct ECP5Bitgen
 
     void write_alu54(CellInfo *ci)
     {
-        TileGroup tg;
+        TileGroup tg(cc.strings.get());
         Loc loc = ctx->getBelLocation(ci->bel);
         tg.tiles = get_dsp_tiles(ci->bel);
         std::string dsp = "ALU54_" + std::to_string(loc.z);
@@ -1223,7 +1215,7 @@ struct ECP5Bitgen
 
     void write_pll(CellInfo *ci)
     {
-        TileGroup tg;
+        TileGroup tg(cc.strings.get());
         tg.tiles = get_pll_tiles(ci->bel);
 
         tg.config.add_enum("MODE", "EHXPLLL");
@@ -1322,7 +1314,7 @@ struct ECP5Bitgen
 
     void write_dcu(CellInfo *ci)
     {
-        TileGroup tg;
+        TileGroup tg(cc.strings.get());
         tg.tiles = get_dcu_tiles(ci->bel);
         tg.config.add_enum("DCU.MODE", "DCUA");
 #include "dcu_bitstream.h"
@@ -1335,7 +1327,7 @@ struct ECP5Bitgen
         Loc loc = ctx->getBelLocation(ci->bel);
         bool l = loc.x < 10;
         std::string pic = l ? "PICL" : "PICR";
-        TileGroup tg;
+        TileGroup tg(cc.strings.get());
         tg.tiles.push_back(ctx->get_tile_by_type_loc(loc.y - 2, loc.x, pic + "1_DQS0"));
         tg.tiles.push_back(ctx->get_tile_by_type_loc(loc.y - 1, loc.x, pic + "2_DQS1"));
         tg.tiles.push_back(ctx->get_tile_by_type_loc(loc.y, loc.x, pic + "0_DQS2"));
@@ -1417,10 +1409,10 @@ struct ECP5Bitgen
                 for (int i = 0; i < 12; i++) {
                     auto tiles = ctx->get_tiles_at_loc(loc.y - 1, loc.x + i);
                     for (const auto &tile : tiles) {
-                        auto cc_tile = cc.tiles.find(tile.first);
-                        if (cc_tile != cc.tiles.end()) {
-                            cc_tile->second.cenums.clear();
-                            cc_tile->second.cunknowns.clear();
+                        TileConfig *cc_tile = cc.tiles.find(tile.first);
+                        if (cc_tile != nullptr) {
+                            cc_tile->cenums.clear();
+                            cc_tile->cunknowns.clear();
                         }
                     }
                 }
@@ -1484,7 +1476,7 @@ struct ECP5Bitgen
             } else if (ci->type == id_DCUA) {
                 write_dcu(ci);
             } else if (ci->type == id_EXTREFB) {
-                TileGroup tg;
+                TileGroup tg(cc.strings.get());
                 tg.tiles = get_dcu_tiles(ci->bel);
                 tg.config.add_word("EXTREF.REFCK_DCBIAS_EN",
                                    parse_config_str(get_or_default(ci->params, id_REFCK_DCBIAS_EN, Property(0)), 1));
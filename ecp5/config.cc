@@ -18,6 +18,7 @@
  */
 
 #include "config.h"
+#include <algorithm>
 #include <boost/range/adaptor/reversed.hpp>
 #include <iomanip>
 #include <set>
@@ -27,14 +28,6 @@ NEXTPNR_NAMESPACE_BEGIN
 
 #define fmt(x) (static_cast<const std::ostringstream &>(std::ostringstream() << x).str())
 
-inline std::string to_string(const std::vector<bool> &bv)
-{
-    std::ostringstream os;
-    for (auto bit : boost::adaptors::reverse(bv))
-        os << (bit ? '1' : '0');
-    return os.str();
-}
-
 inline std::istream &operator>>(std::istream &in, std::vector<bool> &bv)
 {
     bv.clear();
@@ -139,72 +132,38 @@ inline bool skip_check_eof(std::istream &in)
     return (c == EOF);
 }
 
-std::ostream &operator<<(std::ostream &out, const ConfigArc &arc)
-{
-    out << "arc: " << arc.sink << " " << arc.source << std::endl;
-    return out;
-}
-
-std::istream &operator>>(std::istream &in, ConfigArc &arc)
-{
-    in >> arc.sink;
-    in >> arc.source;
-    return in;
-}
-
-std::ostream &operator<<(std::ostream &out, const ConfigWord &cw)
-{
-    out << "word: " << cw.name << " " << to_string(cw.value) << std::endl;
-    return out;
-}
-
-std::istream &operator>>(std::istream &in, ConfigWord &cw)
-{
-    in >> cw.name;
-    in >> cw.value;
-    return in;
-}
-
-std::ostream &operator<<(std::ostream &out, const ConfigEnum &cw)
+int ConfigStrings::id(const std::string &str)
 {
-    out << "enum: " << cw.name << " " << cw.value << std::endl;
-    return out;
+    auto fnd = ids.find(str);
+    if (fnd != ids.end())
+        return fnd->second;
+    int id = int(strings.size());
+    strings.push_back(str);
+    ids.emplace(str, id);
+    return id;
 }
 
-std::istream &operator>>(std::istream &in, ConfigEnum &ce)
+int ConfigStrings::lookup(const std::string &str) const
 {
-    in >> ce.name;
-    in >> ce.value;
-    return in;
-}
-
-std::ostream &operator<<(std::ostream &out, const ConfigUnknown &cu)
-{
-    out << "unknown: " << to_string(ConfigBit{cu.frame, cu.bit, false}) << std::endl;
-    return out;
-}
-
-std::istream &operator>>(std::istream &in, ConfigUnknown &cu)
-{
-    std::string s;
-    in >> s;
-    ConfigBit c = cbit_from_str(s);
-    cu.frame = c.frame;
-    cu.bit = c.bit;
-    assert(!c.inv);
-    return in;
+    auto fnd = ids.find(str);
+    return (fnd != ids.end()) ? fnd->second : -1;
 }
 
 std::ostream &operator<<(std::ostream &out, const TileConfig &tc)
 {
+    const ConfigStrings &strs = *tc.strings;
     for (const auto &arc : tc.carcs)
-        out << arc;
-    for (const auto &cword : tc.cwords)
-        out << cword;
+        out << "arc: " << strs.str(arc.sink) << " " << strs.str(arc.source) << '\n';
+    for (const auto &cword : tc.cwords) {
+        out << "word: " << strs.str(cword.name) << " ";
+        for (int i = cword.width - 1; i >= 0; i--)
+            out << (tc.word_bits.at(cword.offset + i) ? '1' : '0');
+        out << '\n';
+    }
     for (const auto &cenum : tc.cenums)
-        out << cenum;
+        out << "enum: " << strs.str(cenum.name) << " " << strs.str(cenum.value) << '\n';
     for (const auto &cunk : tc.cunknowns)
-        out << cunk;
+        out << "unknown: " << to_string(ConfigBit{cunk.frame, cunk.bit, false}) << '\n';
     return out;
 }
 
@@ -213,25 +172,29 @@ std::istream &operator>>(std::istream &in, TileConfig &tc)
     tc.carcs.clear();
     tc.cwords.clear();
     tc.cenums.clear();
+    tc.word_bits.clear();
     while (!skip_check_eor(in)) {
         std::string type;
         in >> type;
         if (type == "arc:") {
-            ConfigArc a;
-            in >> a;
-            tc.carcs.push_back(a);
+            std::string sink, source;
+            in >> sink >> source;
+            tc.add_arc(sink, source);
         } else if (type == "word:") {
-            ConfigWord w;
-            in >> w;
-            tc.cwords.push_back(w);
+            std::string name;
+            std::vector<bool> value;
+            in >> name >> value;
+            tc.add_word(name, value);
         } else if (type == "enum:") {
-            ConfigEnum e;
-            in >> e;
-            tc.cenums.push_back(e);
+            std::string name, value;
+            in >> name >> value;
+            tc.add_enum(name, value);
         } else if (type == "unknown:") {
-            ConfigUnknown u;
-            in >> u;
-            tc.cunknowns.push_back(u);
+            std::string s;
+            in >> s;
+            ConfigBit c = cbit_from_str(s);
+            assert(!c.inv);
+            tc.add_unknown(c.frame, c.bit);
         } else {
             NPNR_ASSERT_FALSE_STR("unexpected token " + type + " while reading config text");
         }
@@ -239,14 +202,44 @@ std::istream &operator>>(std::istream &in, TileConfig &tc)
     return in;
 }
 
-void TileConfig::add_arc(const std::string &sink, const std::string &source) { carcs.push_back({sink, source}); }
+void TileConfig::add_arc(const std::string &sink, const std::string &source)
+{
+    carcs.push_back({strings->id(sink), strings->id(source)});
+}
 
-void TileConfig::add_word(const std::string &name, const std::vector<bool> &value) { cwords.push_back({name, value}); }
+void TileConfig::add_word(const std::string &name, const std::vector<bool> &value)
+{
+    cwords.push_back({strings->id(name), int(word_bits.size()), int(value.size())});
+    word_bits.insert(word_bits.end(), value.begin(), value.end());
+}
 
-void TileConfig::add_enum(const std::string &name, const std::string &value) { cenums.push_back({name, value}); }
+void TileConfig::add_enum(const std::string &name, const std::string &value)
+{
+    cenums.push_back({strings->id(name), strings->id(value)});
+}
 
 void TileConfig::add_unknown(int frame, int bit) { cunknowns.push_back({frame, bit}); }
 
+void TileConfig::add_config(const TileConfig &other)
+{
+    auto xlat = [&](int id) { return (other.strings == strings) ? id : strings->id(other.strings->str(id)); };
+    for (const auto &carc : other.carcs)
+        carcs.push_back({xlat(carc.sink), xlat(carc.source)});
+    for (const auto &cword : other.cwords) {
+        cwords.push_back({xlat(cword.name), int(word_bits.size()), cword.width});
+        word_bits.insert(word_bits.end(), other.word_bits.begin() + cword.offset,
+                         other.word_bits.begin() + cword.offset + cword.width);
+    }
+    for (const auto &cenum : other.cenums)
+        cenums.push_back({xlat(cenum.name), xlat(cenum.value)});
+    cunknowns.insert(cunknowns.end(), other.cunknowns.begin(), other.cunknowns.end());
+}
+
+std::vector<bool> TileConfig::get_word(const ConfigWord &cw) const
+{
+    return std::vector<bool>(word_bits.begin() + cw.offset, word_bits.begin() + cw.offset + cw.width);
+}
+
 std::string TileConfig::to_string() const
 {
     std::stringstream ss;
@@ -254,52 +247,108 @@ std::string TileConfig::to_string() const
     return ss.str();
 }
 
-TileConfig TileConfig::from_string(const std::string &str)
+TileConfig TileConfig::from_string(const std::string &str, ConfigStrings *strings)
 {
     std::stringstream ss(str);
-    TileConfig tc;
+    TileConfig tc(strings);
     ss >> tc;
     return tc;
 }
 
 bool TileConfig::empty() const { return carcs.empty() && cwords.empty() && cenums.empty() && cunknowns.empty(); }
 
+TileConfig &TileConfigMap::operator[](const std::string &name)
+{
+    int name_id = strings->id(name);
+    auto fnd = config_by_name.find(name_id);
+    if (fnd != config_by_name.end())
+        return configs.at(fnd->second);
+    config_by_name.emplace(name_id, int(configs.size()));
+    config_name.push_back(name_id);
+    configs.emplace_back(strings);
+    return configs.back();
+}
+
+TileConfig &TileConfigMap::at(const std::string &name)
+{
+    return configs.at(config_by_name.at(strings->lookup(name)));
+}
+
+const TileConfig &TileConfigMap::at(const std::string &name) const
+{
+    return configs.at(config_by_name.at(strings->lookup(name)));
+}
+
+TileConfig *TileConfigMap::find(const std::string &name)
+{
+    auto fnd = config_by_name.find(strings->lookup(name));
+    return (fnd != config_by_name.end()) ? &configs.at(fnd->second) : nullptr;
+}
+
+int TileConfigMap::count(const std::string &name) const
+{
+    return config_by_name.count(strings->lookup(name));
+}
+
+void TileConfigMap::erase(const std::string &name)
+{
+    auto fnd = config_by_name.find(strings->lookup(name));
+    if (fnd == config_by_name.end())
+        return;
+    // The slot isn't reused, just emptied
+    configs.at(fnd->second) = TileConfig(strings);
+    config_by_name.erase(fnd);
+}
+
+std::vector<std::string> TileConfigMap::names() const
+{
+    std::vector<std::string> result;
+    for (int i = 0; i < int(configs.size()); i++) {
+        auto fnd = config_by_name.find(config_name.at(i));
+        if (fnd != config_by_name.end() && fnd->second == i)
+            result.push_back(strings->str(config_name.at(i)));
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
 std::ostream &operator<<(std::ostream &out, const ChipConfig &cc)
 {
-    out << ".device " << cc.chip_name << std::endl << std::endl;
+    out << ".device " << cc.chip_name << '\n' << '\n';
     for (const auto &meta : cc.metadata)
-        out << ".comment " << meta << std::endl;
+        out << ".comment " << meta << '\n';
     for (const auto &sc : cc.sysconfig)
-        out << ".sysconfig " << sc.first << " " << sc.second << std::endl;
-    out << std::endl;
-    for (const auto &tile : cc.tiles) {
-        if (!tile.second.empty()) {
-            out << ".tile " << tile.first << std::endl;
-            out << tile.second;
-            out << std::endl;
+        out << ".sysconfig " << sc.first << " " << sc.second << '\n';
+    out << '\n';
+    for (const auto &name : cc.tiles.names()) {
+        const TileConfig &tc = cc.tiles.at(name);
+        if (!tc.empty()) {
+            out << ".tile " << name << '\n';
+            out << tc;
+            out << '\n';
         }
     }
     for (const auto &bram : cc.bram_data) {
-        out << ".bram_init " << bram.first << std::endl;
+        out << ".bram_init " << bram.first << '\n';
         std::ios_base::fmtflags f(out.flags());
         for (size_t i = 0; i < bram.second.size(); i++) {
             out << std::setw(3) << std::setfill('0') << std::hex << bram.second.at(i);
             if (i % 8 == 7)
-                out << std::endl;
+                out << '\n';
             else
                 out << " ";
         }
         out.flags(f);
-        out << std::endl;
+        out << '\n';
     }
     for (const auto &tg : cc.tilegroups) {
         out << ".tile_group";
         for (const auto &tile : tg.tiles) {
             out << " " << tile;
         }
-        out << std::endl;
+        out << '\n';
         out << tg.config;
-        out << std::endl;
+        out << '\n';
     }
     return out;
 }
@@ -322,11 +371,11 @@ std::istream &operator>>(std::istream &in, ChipConfig &cc)
         } else if (verb == ".tile") {
             std::string tilename;
             in >> tilename;
-            TileConfig tc;
+            TileConfig tc(cc.strings.get());
             in >> tc;
             cc.tiles[tilename] = tc;
         } else if (verb == ".tile_group") {
-            TileGroup tg;
+            TileGroup tg(cc.strings.get());
             std::string line;
             getline(in, line);
             std::stringstream ss2(line);
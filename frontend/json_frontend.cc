@@ -19,185 +19,798 @@
 
 #include "json_frontend.h"
 #include "frontend_base.h"
-#include "json11.hpp"
 #include "log.h"
 #include "nextpnr.h"
 
+#include <algorithm>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
 #include <streambuf>
+#include <string_view>
 
 NEXTPNR_NAMESPACE_BEGIN
 
-using namespace json11;
+namespace {
 
-struct JsonFrontendImpl
+// The netlist is parsed in a single pass straight out of the file buffer into the compact records below, rather than
+// building a DOM first. Names and string values are views into the buffer (strings containing escapes are decoded in
+// place, which never makes them longer), and bit vectors, properties and cell ports are stored in flat per-module
+// arrays. Objects are sorted by key, with the last of any duplicate keys winning, so everything is visited in the same
+// order as it was with the old json11 based frontend.
+
+// A run of entries in one of the per-module arrays. Only the offset is known while the module is being parsed, as the
+// array might still be reallocated; data is filled in once the module is complete.
+template <typename T> struct JsonSpan
 {
-    // See specification in frontend_base.h
-    JsonFrontendImpl(Json &root) : root(root) {};
-    Json &root;
-    typedef const Json &ModuleDataType;
-    typedef const Json &ModulePortDataType;
-    typedef const Json &CellDataType;
-    typedef const Json &NetnameDataType;
-    typedef const Json::array &BitVectorDataType;
+    uint32_t offset = 0, size = 0;
+    const T *data = nullptr;
 
-    template <typename TFunc> void foreach_module(TFunc Func) const
+    const T *begin() const { return data; }
+    const T *end() const { return data + size; }
+};
+
+struct JsonProperty
+{
+    std::string_view name, str;
+    bool is_num = false;
+    // Whether the number was an integer that fits in an int
+    bool num_ok = false;
+    int num = 0;
+};
+
+// Signals are stored as their non-negative index, constant bits as (-1 - c) for the constant character c
+typedef JsonSpan<int> JsonBitVector;
+
+struct JsonPortDir
+{
+    std::string_view name;
+    PortType dir;
+};
+
+struct JsonPortConn
+{
+    std::string_view name;
+    JsonBitVector bits;
+};
+
+struct JsonPort
+{
+    std::string_view name, direction;
+    JsonBitVector bits;
+    int offset = 0;
+    bool upto = false;
+    JsonSpan<JsonProperty> attrs;
+};
+
+struct JsonCell
+{
+    std::string_view name, type;
+    JsonSpan<JsonProperty> attrs, params;
+    JsonSpan<JsonPortDir> port_dirs;
+    JsonSpan<JsonPortConn> conns;
+};
+
+struct JsonNetname
+{
+    std::string_view name;
+    JsonBitVector bits;
+    int offset = 0;
+    bool upto = false;
+    JsonSpan<JsonProperty> attrs;
+};
+
+struct JsonModule
+{
+    std::string_view name;
+    JsonSpan<JsonProperty> attrs, settings;
+    JsonSpan<JsonPort> ports;
+    JsonSpan<JsonCell> cells;
+    JsonSpan<JsonNetname> netnames;
+
+    std::vector<int> bit_data;
+    std::vector<JsonProperty> props;
+    std::vector<JsonPortDir> port_dirs;
+    std::vector<JsonPortConn> conns;
+    std::vector<JsonPort> port_list;
+    std::vector<JsonCell> cell_list;
+    std::vector<JsonNetname> netname_list;
+};
+
+PortType lookup_portdir(std::string_view dir)
+{
+    if (dir == "input")
+        return PORT_IN;
+    else if (dir == "inout")
+        return PORT_INOUT;
+    else if (dir == "output")
+        return PORT_OUT;
+    else
+        NPNR_ASSERT_FALSE("invalid json port direction");
+}
+
+struct JsonReader
+{
+    JsonReader(char *buf, size_t size, const std::string &filename)
+            : start(buf), p(buf), end(buf + size), filename(filename) {};
+    char *start, *p, *end;
+    const std::string &filename;
+    // Current nesting of objects and arrays, limited so that malformed input can't overflow the stack
+    int depth = 0;
+    static constexpr int max_depth = 200;
+
+    [[noreturn]] void error(const char *what)
     {
-        for (const auto &mod : root.object_items())
-            Func(mod.first, mod.second);
+        int line = 1 + int(std::count(const_cast<const char *>(start), const_cast<const char *>(p), '\n'));
+        log_error("Failed to parse JSON file '%s': %s at line %d.\n", filename.c_str(), what, line);
     }
 
-    template <typename TFunc> void foreach_port(ModuleDataType &mod, TFunc Func) const
+    void skip_ws()
     {
-        const auto &ports = mod["ports"];
-        if (ports.is_null())
-            return;
-        for (const auto &port : ports.object_items())
-            Func(port.first, port.second);
+        while (p < end) {
+            char c = *p;
+            if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+                ++p;
+            } else if (c == '/' && (p + 1) < end && p[1] == '/') {
+                while (p < end && *p != '\n')
+                    ++p;
+            } else if (c == '/' && (p + 1) < end && p[1] == '*') {
+                p += 2;
+                while ((p + 1) < end && !(p[0] == '*' && p[1] == '/'))
+                    ++p;
+                if ((p + 1) >= end)
+                    error("unterminated comment");
+                p += 2;
+            } else {
+                break;
+            }
+        }
     }
 
-    template <typename TFunc> void foreach_cell(ModuleDataType &mod, TFunc Func) const
+    char peek()
     {
-        const auto &cells = mod["cells"];
-        if (cells.is_null())
-            return;
-        for (const auto &cell : cells.object_items())
-            Func(cell.first, cell.second);
+        skip_ws();
+        if (p == end)
+            error("unexpected end of input");
+        return *p;
     }
 
-    template <typename TFunc> void foreach_netname(ModuleDataType &mod, TFunc Func) const
+    void expect(char c)
     {
-        const auto &netnames = mod["netnames"];
-        if (netnames.is_null())
-            return;
-        for (const auto &netname : netnames.object_items())
-            Func(netname.first, netname.second);
+        if (peek() != c) {
+            std::string msg = stringf("expected '%c'", c);
+            error(msg.c_str());
+        }
+        ++p;
     }
 
-    PortType lookup_portdir(const std::string &dir) const
+    static void put_utf8(char *&out, uint32_t cp)
     {
-        if (dir == "input")
-            return PORT_IN;
-        else if (dir == "inout")
-            return PORT_INOUT;
-        else if (dir == "output")
-            return PORT_OUT;
-        else
-            NPNR_ASSERT_FALSE("invalid json port direction");
+        if (cp < 0x80) {
+            *out++ = char(cp);
+        } else if (cp < 0x800) {
+            *out++ = char(0xC0 | (cp >> 6));
+            *out++ = char(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            *out++ = char(0xE0 | (cp >> 12));
+            *out++ = char(0x80 | ((cp >> 6) & 0x3F));
+            *out++ = char(0x80 | (cp & 0x3F));
+        } else {
+            *out++ = char(0xF0 | (cp >> 18));
+            *out++ = char(0x80 | ((cp >> 12) & 0x3F));
+            *out++ = char(0x80 | ((cp >> 6) & 0x3F));
+            *out++ = char(0x80 | (cp & 0x3F));
+        }
     }
 
-    PortType get_port_dir(ModulePortDataType &port) const { return lookup_portdir(port["direction"].string_value()); }
+    uint32_t parse_hex4()
+    {
+        if ((end - p) < 4)
+            error("truncated \\u escape");
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = *p++;
+            value <<= 4;
+            if (c >= '0' && c <= '9')
+                value |= uint32_t(c - '0');
+            else if (c >= 'a' && c <= 'f')
+                value |= uint32_t(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F')
+                value |= uint32_t(c - 'A' + 10);
+            else
+                error("invalid \\u escape");
+        }
+        return value;
+    }
 
-    int get_array_offset(const Json &obj) const
+    std::string_view parse_string()
     {
-        auto offset = obj["offset"];
-        return offset.is_null() ? 0 : offset.int_value();
+        expect('"');
+        char *str_start = p;
+        // Fast path for the common case of no escapes
+        while (p < end && *p != '"' && *p != '\\')
+            ++p;
+        char *out = p;
+        while (p < end && *p != '"') {
+            if (*p != '\\') {
+                *out++ = *p++;
+                continue;
+            }
+            if (++p == end)
+                break;
+            char c = *p++;
+            switch (c) {
+            case '"':
+            case '\\':
+            case '/':
+                *out++ = c;
+                break;
+            case 'b':
+                *out++ = '\b';
+                break;
+            case 'f':
+                *out++ = '\f';
+                break;
+            case 'n':
+                *out++ = '\n';
+                break;
+            case 'r':
+                *out++ = '\r';
+                break;
+            case 't':
+                *out++ = '\t';
+                break;
+            case 'u': {
+                uint32_t cp = parse_hex4();
+                if (cp >= 0xD800 && cp < 0xDC00 && (end - p) >= 6 && p[0] == '\\' && p[1] == 'u') {
+                    p += 2;
+                    uint32_t lo = parse_hex4();
+                    if (lo >= 0xDC00 && lo < 0xE000) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    } else {
+                        put_utf8(out, cp);
+                        cp = lo;
+                    }
+                }
+                put_utf8(out, cp);
+                break;
+            }
+            default:
+                error("invalid escape sequence");
+            }
+        }
+        if (p == end)
+            error("unterminated string");
+        ++p;
+        return std::string_view(str_start, size_t(out - str_start));
     }
 
-    bool is_array_upto(const Json &obj) const
+    // Parses a number, returning true (and setting value) if it is an integer that fits in an int
+    bool parse_number(int &value)
     {
-        auto upto = obj["upto"];
-        return upto.is_null() ? false : bool(upto.int_value());
+        skip_ws();
+        char *num_start = p;
+        bool neg = false;
+        if (p < end && *p == '-') {
+            neg = true;
+            ++p;
+        }
+        if (p == end || *p < '0' || *p > '9')
+            error("invalid number");
+        long long acc = 0;
+        bool overflow = false;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (!overflow)
+                acc = acc * 10 + (*p - '0');
+            overflow |= (acc > (1LL << 32));
+            ++p;
+        }
+        if (p < end && (*p == '.' || *p == 'e' || *p == 'E')) {
+            while (p < end &&
+                   (*p == '.' || *p == 'e' || *p == 'E' || *p == '+' || *p == '-' || (*p >= '0' && *p <= '9')))
+                ++p;
+            double d = std::strtod(std::string(num_start, p).c_str(), nullptr);
+            if (d < std::numeric_limits<int>::min() || d > std::numeric_limits<int>::max() || d != int(d))
+                return false;
+            value = int(d);
+            return true;
+        }
+        if (neg)
+            acc = -acc;
+        if (overflow || acc < std::numeric_limits<int>::min() || acc > std::numeric_limits<int>::max())
+            return false;
+        value = int(acc);
+        return true;
     }
 
-    BitVectorDataType &get_port_bits(ModulePortDataType &port) const { return port["bits"].array_items(); }
+    int parse_int()
+    {
+        int value = 0;
+        if (!parse_number(value))
+            error("integer out of range");
+        return value;
+    }
 
-    const std::string &get_cell_type(CellDataType &cell) const { return cell["type"].string_value(); }
+    bool parse_literal(const char *lit)
+    {
+        size_t len = strlen(lit);
+        if (size_t(end - p) < len || std::string_view(p, len) != lit)
+            error("invalid literal");
+        p += len;
+        return lit[0] == 't';
+    }
 
-    Property parse_property(const Json &val) const
+    void enter_nested()
     {
-        if (val.is_number()) {
-            if (val.int_value() != val.number_value())
-                log_error("Found an out-of-range integer parameter in the JSON file.\n"
-                          "Please regenerate the input file with an up-to-date version of yosys.\n");
-            return Property(val.int_value(), 32);
+        if (++depth > max_depth)
+            error("objects and arrays nested too deeply");
+    }
+
+    // Calls func(key) for each key of an object, with the reader positioned at the value
+    template <typename TFunc> void parse_object(TFunc func)
+    {
+        expect('{');
+        if (peek() == '}') {
+            ++p;
+            return;
+        }
+        enter_nested();
+        while (true) {
+            std::string_view key = parse_string();
+            expect(':');
+            func(key);
+            char c = peek();
+            ++p;
+            if (c == '}')
+                break;
+            if (c != ',')
+                error("expected ',' or '}'");
+        }
+        --depth;
+    }
+
+    // Calls func() for each element of an array, with the reader positioned at the element
+    template <typename TFunc> void parse_array(TFunc func)
+    {
+        expect('[');
+        if (peek() == ']') {
+            ++p;
+            return;
+        }
+        enter_nested();
+        while (true) {
+            func();
+            char c = peek();
+            ++p;
+            if (c == ']')
+                break;
+            if (c != ',')
+                error("expected ',' or ']'");
+        }
+        --depth;
+    }
+
+    void skip_value()
+    {
+        char c = peek();
+        if (c == '{') {
+            parse_object([&](std::string_view) { skip_value(); });
+        } else if (c == '[') {
+            parse_array([&]() { skip_value(); });
+        } else if (c == '"') {
+            parse_string();
+        } else if (c == 't') {
+            parse_literal("true");
+        } else if (c == 'f') {
+            parse_literal("false");
+        } else if (c == 'n') {
+            parse_literal("null");
         } else {
-            return Property::from_string(val.string_value());
+            int dummy;
+            parse_number(dummy);
+        }
+    }
+
+    // Integer fields such as "offset" and "upto", where null counts as zero
+    int parse_int_field()
+    {
+        char c = peek();
+        if (c == 'n') {
+            parse_literal("null");
+            return 0;
+        } else if (c == 't' || c == 'f') {
+            return parse_literal(c == 't' ? "true" : "false");
+        } else if (c == '"' || c == '{' || c == '[') {
+            skip_value();
+            return 0;
+        }
+        return parse_int();
+    }
+
+    std::string_view parse_string_field()
+    {
+        if (peek() == '"')
+            return parse_string();
+        skip_value();
+        return std::string_view();
+    }
+
+    // Sort the entries added to vec since offset by name, keeping only the last of any duplicates
+    template <typename T> void finish_object(std::vector<T> &vec, uint32_t offset, JsonSpan<T> &span)
+    {
+        std::stable_sort(vec.begin() + offset, vec.end(), [](const T &a, const T &b) { return a.name < b.name; });
+        size_t out = offset;
+        for (size_t i = offset; i < vec.size(); i++) {
+            if ((i + 1) < vec.size() && vec.at(i + 1).name == vec.at(i).name)
+                continue;
+            if (out != i)
+                vec.at(out) = vec.at(i);
+            ++out;
         }
+        vec.resize(out);
+        span.offset = offset;
+        span.size = uint32_t(out - offset);
     }
 
-    template <typename TFunc> void foreach_attr(const Json &obj, TFunc Func) const
+    void parse_props(JsonModule &mod, JsonSpan<JsonProperty> &span)
     {
-        const auto &attrs = obj["attributes"];
-        if (attrs.is_null())
+        if (peek() != '{') {
+            skip_value();
+            span = JsonSpan<JsonProperty>();
             return;
-        for (const auto &attr : attrs.object_items()) {
-            Func(attr.first, parse_property(attr.second));
         }
+        uint32_t offset = uint32_t(mod.props.size());
+        parse_object([&](std::string_view key) {
+            JsonProperty prop;
+            prop.name = key;
+            char c = peek();
+            if (c == '"') {
+                prop.str = parse_string();
+            } else if (c == '-' || (c >= '0' && c <= '9')) {
+                prop.is_num = true;
+                prop.num_ok = parse_number(prop.num);
+            } else {
+                skip_value();
+            }
+            mod.props.push_back(prop);
+        });
+        finish_object(mod.props, offset, span);
     }
 
-    template <typename TFunc> void foreach_param(const Json &obj, TFunc Func) const
+    void parse_bits(JsonModule &mod, JsonBitVector &bits)
     {
-        const auto &params = obj["parameters"];
-        if (params.is_null())
+        bits = JsonBitVector();
+        if (peek() != '[') {
+            skip_value();
             return;
-        for (const auto &param : params.object_items()) {
-            Func(param.first, parse_property(param.second));
         }
+        bits.offset = uint32_t(mod.bit_data.size());
+        parse_array([&]() {
+            if (peek() == '"') {
+                std::string_view s = parse_string();
+                if (s.size() != 1)
+                    error("invalid constant bit");
+                mod.bit_data.push_back(-1 - int(uint8_t(s.at(0))));
+            } else {
+                int bit = parse_int();
+                if (bit < 0)
+                    error("negative signal number");
+                mod.bit_data.push_back(bit);
+            }
+        });
+        bits.size = uint32_t(mod.bit_data.size() - bits.offset);
     }
 
-    template <typename TFunc> void foreach_setting(const Json &obj, TFunc Func) const
+    void parse_port(JsonModule &mod, JsonPort &port)
     {
-        const auto &settings = obj["settings"];
-        if (settings.is_null())
+        parse_object([&](std::string_view key) {
+            if (key == "direction")
+                port.direction = parse_string_field();
+            else if (key == "bits")
+                parse_bits(mod, port.bits);
+            else if (key == "offset")
+                port.offset = parse_int_field();
+            else if (key == "upto")
+                port.upto = bool(parse_int_field());
+            else if (key == "attributes")
+                parse_props(mod, port.attrs);
+            else
+                skip_value();
+        });
+    }
+
+    void parse_netname(JsonModule &mod, JsonNetname &net)
+    {
+        parse_object([&](std::string_view key) {
+            if (key == "bits")
+                parse_bits(mod, net.bits);
+            else if (key == "offset")
+                net.offset = parse_int_field();
+            else if (key == "upto")
+                net.upto = bool(parse_int_field());
+            else if (key == "attributes")
+                parse_props(mod, net.attrs);
+            else
+                skip_value();
+        });
+    }
+
+    void parse_cell(JsonModule &mod, JsonCell &cell)
+    {
+        parse_object([&](std::string_view key) {
+            if (key == "type") {
+                cell.type = parse_string_field();
+            } else if (key == "parameters") {
+                parse_props(mod, cell.params);
+            } else if (key == "attributes") {
+                parse_props(mod, cell.attrs);
+            } else if (key == "port_directions" && peek() == '{') {
+                uint32_t offset = uint32_t(mod.port_dirs.size());
+                parse_object([&](std::string_view port) {
+                    mod.port_dirs.push_back(JsonPortDir{port, lookup_portdir(parse_string_field())});
+                });
+                finish_object(mod.port_dirs, offset, cell.port_dirs);
+            } else if (key == "connections" && peek() == '{') {
+                uint32_t offset = uint32_t(mod.conns.size());
+                parse_object([&](std::string_view port) {
+                    JsonPortConn conn;
+                    conn.name = port;
+                    parse_bits(mod, conn.bits);
+                    mod.conns.push_back(conn);
+                });
+                finish_object(mod.conns, offset, cell.conns);
+            } else {
+                skip_value();
+            }
+        });
+    }
+
+    template <typename T, typename TFunc>
+    void parse_named_objects(std::vector<T> &vec, JsonSpan<T> &span, TFunc parse_entry)
+    {
+        if (peek() != '{') {
+            skip_value();
+            span = JsonSpan<T>();
             return;
-        for (const auto &setting : settings.object_items()) {
-            Func(setting.first, parse_property(setting.second));
         }
+        uint32_t offset = uint32_t(vec.size());
+        parse_object([&](std::string_view key) {
+            T entry;
+            entry.name = key;
+            parse_entry(entry);
+            vec.push_back(entry);
+        });
+        finish_object(vec, offset, span);
     }
 
-    template <typename TFunc> void foreach_port_dir(CellDataType &cell, TFunc Func) const
+    void parse_module(JsonModule &mod)
     {
-        for (const auto &pdir : cell["port_directions"].object_items())
-            Func(pdir.first, lookup_portdir(pdir.second.string_value()));
+        parse_object([&](std::string_view key) {
+            if (key == "attributes")
+                parse_props(mod, mod.attrs);
+            else if (key == "settings")
+                parse_props(mod, mod.settings);
+            else if (key == "ports")
+                parse_named_objects(mod.port_list, mod.ports, [&](JsonPort &port) { parse_port(mod, port); });
+            else if (key == "cells")
+                parse_named_objects(mod.cell_list, mod.cells, [&](JsonCell &cell) { parse_cell(mod, cell); });
+            else if (key == "netnames")
+                parse_named_objects(mod.netname_list, mod.netnames,
+                                    [&](JsonNetname &net) { parse_netname(mod, net); });
+            else
+                skip_value();
+        });
+        // Now that the arrays won't be reallocated any more, point the spans into them
+        auto fixup = [](auto &span, const auto &vec) { span.data = vec.data() + span.offset; };
+        fixup(mod.attrs, mod.props);
+        fixup(mod.settings, mod.props);
+        fixup(mod.ports, mod.port_list);
+        fixup(mod.cells, mod.cell_list);
+        fixup(mod.netnames, mod.netname_list);
+        for (auto &port : mod.port_list) {
+            fixup(port.bits, mod.bit_data);
+            fixup(port.attrs, mod.props);
+        }
+        for (auto &cell : mod.cell_list) {
+            fixup(cell.attrs, mod.props);
+            fixup(cell.params, mod.props);
+            fixup(cell.port_dirs, mod.port_dirs);
+            fixup(cell.conns, mod.conns);
+        }
+        for (auto &conn : mod.conns)
+            fixup(conn.bits, mod.bit_data);
+        for (auto &net : mod.netname_list) {
+            fixup(net.bits, mod.bit_data);
+            fixup(net.attrs, mod.props);
+        }
     }
 
-    template <typename TFunc> void foreach_port_conn(CellDataType &cell, TFunc Func) const
+    // Returns false if there is no "modules" key
+    bool parse_netlist(std::vector<JsonModule> &modules)
     {
-        for (const auto &pconn : cell["connections"].object_items())
-            Func(pconn.first, pconn.second.array_items());
+        bool found_modules = false;
+        parse_object([&](std::string_view key) {
+            if (key != "modules") {
+                skip_value();
+                return;
+            }
+            if (peek() != '{') {
+                skip_value();
+                return;
+            }
+            found_modules = true;
+            modules.clear();
+            parse_object([&](std::string_view name) {
+                modules.emplace_back();
+                modules.back().name = name;
+                parse_module(modules.back());
+            });
+            std::stable_sort(modules.begin(), modules.end(),
+                             [](const JsonModule &a, const JsonModule &b) { return a.name < b.name; });
+            // Keep only the last of any duplicates
+            for (size_t i = 0; (i + 1) < modules.size();) {
+                if (modules.at(i).name == modules.at(i + 1).name)
+                    modules.erase(modules.begin() + i);
+                else
+                    ++i;
+            }
+        });
+        skip_ws();
+        if (p != end)
+            error("trailing characters after netlist");
+        return found_modules;
     }
+};
+
+struct JsonFrontendImpl
+{
+    // See specification in frontend_base.h
+    JsonFrontendImpl(const std::vector<JsonModule> &modules) : modules(modules) {};
+    const std::vector<JsonModule> &modules;
+    typedef JsonModule ModuleDataType;
+    typedef JsonPort ModulePortDataType;
+    typedef JsonCell CellDataType;
+    typedef JsonNetname NetnameDataType;
+    typedef JsonBitVector BitVectorDataType;
 
-    BitVectorDataType &get_net_bits(NetnameDataType &net) const { return net["bits"].array_items(); }
+    template <typename TFunc> void foreach_module(TFunc Func) const
+    {
+        for (const auto &mod : modules)
+            Func(std::string(mod.name), mod);
+    }
 
-    int get_vector_length(BitVectorDataType &bits) const { return int(bits.size()); }
+    template <typename TFunc> void foreach_port(const ModuleDataType &mod, TFunc Func) const
+    {
+        for (const auto &port : mod.ports)
+            Func(std::string(port.name), port);
+    }
 
-    bool is_vector_bit_constant(BitVectorDataType &bits, int i) const
+    template <typename TFunc> void foreach_cell(const ModuleDataType &mod, TFunc Func) const
     {
-        NPNR_ASSERT(i < int(bits.size()));
-        return bits[i].is_string();
+        for (const auto &cell : mod.cells)
+            Func(std::string(cell.name), cell);
     }
 
-    char get_vector_bit_constval(BitVectorDataType &bits, int i) const
+    template <typename TFunc> void foreach_netname(const ModuleDataType &mod, TFunc Func) const
     {
-        auto s = bits.at(i).string_value();
-        NPNR_ASSERT(s.size() == 1);
-        return s.at(0);
+        for (const auto &netname : mod.netnames)
+            Func(std::string(netname.name), netname);
     }
 
-    int get_vector_bit_signal(BitVectorDataType &bits, int i) const
+    PortType get_port_dir(const ModulePortDataType &port) const { return lookup_portdir(port.direction); }
+
+    template <typename T> int get_array_offset(const T &obj) const { return obj.offset; }
+
+    template <typename T> bool is_array_upto(const T &obj) const { return obj.upto; }
+
+    const BitVectorDataType &get_port_bits(const ModulePortDataType &port) const { return port.bits; }
+
+    std::string get_cell_type(const CellDataType &cell) const { return std::string(cell.type); }
+
+    Property parse_property(const JsonProperty &val) const
     {
-        NPNR_ASSERT(bits.at(i).is_number());
-        return bits.at(i).int_value();
+        if (val.is_num) {
+            if (!val.num_ok)
+                log_error("Found an out-of-range integer parameter in the JSON file.\n"
+                          "Please regenerate the input file with an up-to-date version of yosys.\n");
+            return Property(val.num, 32);
+        } else {
+            return Property::from_string(std::string(val.str));
+        }
+    }
+
+    template <typename TFunc> void foreach_props(const JsonSpan<JsonProperty> &props, TFunc Func) const
+    {
+        for (const auto &prop : props)
+            Func(std::string(prop.name), parse_property(prop));
+    }
+
+    template <typename T, typename TFunc> void foreach_attr(const T &obj, TFunc Func) const
+    {
+        foreach_props(obj.attrs, Func);
+    }
+
+    template <typename TFunc> void foreach_param(const CellDataType &obj, TFunc Func) const
+    {
+        foreach_props(obj.params, Func);
+    }
+
+    template <typename TFunc> void foreach_setting(const ModuleDataType &obj, TFunc Func) const
+    {
+        foreach_props(obj.settings, Func);
+    }
+
+    template <typename TFunc> void foreach_port_dir(const CellDataType &cell, TFunc Func) const
+    {
+        for (const auto &pdir : cell.port_dirs)
+            Func(std::string(pdir.name), pdir.dir);
+    }
+
+    template <typename TFunc> void foreach_port_conn(const CellDataType &cell, TFunc Func) const
+    {
+        for (const auto &pconn : cell.conns)
+            Func(std::string(pconn.name), pconn.bits);
+    }
+
+    const BitVectorDataType &get_net_bits(const NetnameDataType &net) const { return net.bits; }
+
+    int get_vector_length(const BitVectorDataType &bits) const { return int(bits.size); }
+
+    bool is_vector_bit_constant(const BitVectorDataType &bits, int i) const
+    {
+        NPNR_ASSERT(i < int(bits.size));
+        return bits.data[i] < 0;
+    }
+
+    char get_vector_bit_constval(const BitVectorDataType &bits, int i) const
+    {
+        NPNR_ASSERT(i < int(bits.size) && bits.data[i] < 0);
+        return char(-1 - bits.data[i]);
+    }
+
+    int get_vector_bit_signal(const BitVectorDataType &bits, int i) const
+    {
+        NPNR_ASSERT(i < int(bits.size) && bits.data[i] >= 0);
+        return bits.data[i];
     }
 };
 
+// The buffer is modified in place, as escaped strings are decoded
+void parse_json_buffer(char *buf, size_t size, const std::string &filename, Context *ctx)
+{
+    std::vector<JsonModule> modules;
+    if (!JsonReader(buf, size, filename).parse_netlist(modules))
+        log_error("JSON file '%s' doesn't look like a netlist (doesn't contain \"modules\" key)\n", filename.c_str());
+    GenericFrontend<JsonFrontendImpl>(ctx, JsonFrontendImpl(modules), /*split_io=*/true)();
+}
+
+} // namespace
+
 bool parse_json(std::istream &in, const std::string &filename, Context *ctx)
 {
-    Json root;
-    {
-        if (!in)
-            log_error("Failed to open JSON file '%s'.\n", filename.c_str());
-        std::string json_str((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
-        std::string error;
-        root = Json::parse(json_str, error, JsonParse::COMMENTS);
-        if (root.is_null())
-            log_error("Failed to parse JSON file '%s': %s.\n", filename.c_str(), error.c_str());
-        root = root["modules"];
-        if (root.is_null())
-            log_error("JSON file '%s' doesn't look like a netlist (doesn't contain \"modules\" key)\n",
-                      filename.c_str());
-    }
-    GenericFrontend<JsonFrontendImpl>(ctx, JsonFrontendImpl(root), /*split_io=*/true)();
+    if (!in)
+        log_error("Failed to open JSON file '%s'.\n", filename.c_str());
+    std::string json_str((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    parse_json_buffer(&json_str[0], json_str.size(), filename, ctx);
+    return true;
+}
+
+bool parse_json_file(const std::string &filename, Context *ctx)
+{
+    // Map the file copy-on-write, so that only the pages with escaped strings need to be copied. Anything that can't
+    // be mapped, such as a pipe or an empty file, is read through a stream instead
+    boost::iostreams::mapped_file file;
+    try {
+        file.open(filename, boost::iostreams::mapped_file::priv);
+    } catch (std::exception &) {
+    }
+    if (!file.is_open()) {
+        std::ifstream in(filename);
+        return parse_json(in, filename, ctx);
+    }
+    parse_json_buffer(file.data(), file.size(), filename, ctx);
     return true;
 }
 
@@ -0,0 +1,19 @@
+"""
+Shared setup for the tests that run nextpnr-generic on the viaduct example uarch.
+"""
+
+import os
+import subprocess
+import sys
+
+GEN_NETLIST = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "bench", "gen_netlist.py")
+
+
+def write_design(work_dir, size=300):
+    """Creates work_dir and writes a synthetic netlist with `size` LUT-FF pairs to design.json in it, returning the
+    path. The viaduct example uarch models neither IO buffers nor top-level ports, so the design has neither."""
+    os.makedirs(work_dir, exist_ok=True)
+    json_file = os.path.join(work_dir, "design.json")
+    subprocess.run([sys.executable, GEN_NETLIST, "example", str(size), json_file, "--no-io-buffers", "--no-ports"],
+                   check=True)
+    return json_file
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""
+Checks that HeAP's parallel strict legaliser gives the same placement for any number of threads, using the viaduct
+example uarch.
+
+The example grid is only 32x32 tiles, so the regions are made 4x4 tiles. That way each of the legaliser's four passes
+has several regions with cells in them, which can be legalised at the same time.
+
+Usage: legalise_threads.py <nextpnr-generic> <work dir>
+"""
+
+import json
+import os
+import re
+import subprocess
+import sys
+
+from example_design import write_design
+
+REGION_SIZE = 4
+
+
+def placed_checksum(binary, work_dir, json_file, threads):
+    name = "threads{}".format(threads)
+    log = os.path.join(work_dir, name + ".log")
+    cmd = [binary, "--uarch", "example", "--seed", "1", "--log", log, "--json", json_file, "--placer", "heap",
+           "--placer-heap-parallel-legalise", "--placer-heap-legalise-region-size", str(REGION_SIZE),
+           "--threads", str(threads), "--no-route", "--write", os.path.join(work_dir, name + ".json")]
+    result = subprocess.run(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    if result.returncode != 0:
+        sys.exit("FAIL: {} threads exited with {}, see {}.log".format(threads, result.returncode, name))
+    with open(log) as f:
+        checksums = re.findall(r"Checksum: (0x[0-9a-f]+)", f.read())
+    if not checksums:
+        sys.exit("FAIL: no checksum in {}.log".format(name))
+    return checksums[-1]
+
+
+def regions_per_pass(placed_json):
+    """The most regions with cells placed in them that the legaliser handles in the same pass."""
+    with open(placed_json) as f:
+        design = json.load(f)
+    regions = set()
+    for module in design["modules"].values():
+        for cell in module["cells"].values():
+            m = re.match(r"X(\d+)/Y(\d+)/", cell.get("attributes", {}).get("NEXTPNR_BEL", ""))
+            if m:
+                regions.add((int(m.group(1)) // REGION_SIZE, int(m.group(2)) // REGION_SIZE))
+    passes = {}
+    for rx, ry in regions:
+        passes[(rx % 2, ry % 2)] = passes.get((rx % 2, ry % 2), 0) + 1
+    return max(passes.values())
+
+
+def main():
+    binary, work_dir = sys.argv[1], sys.argv[2]
+    json_file = write_design(work_dir)
+
+    checksums = {threads: placed_checksum(binary, work_dir, json_file, threads) for threads in (1, 2, 4)}
+    for threads, checksum in checksums.items():
+        print("{} threads: placed checksum {}".format(threads, checksum))
+    if len(set(checksums.values())) != 1:
+        sys.exit("FAIL: placement depends on the number of threads")
+    # Otherwise the threads never had two regions to work on at once, and the test would prove nothing
+    concurrent = regions_per_pass(os.path.join(work_dir, "threads1.json"))
+    print("up to {} occupied regions per pass".format(concurrent))
+    if concurrent < 2:
+        sys.exit("FAIL: the design doesn't span enough regions to legalise several at once")
+    print("PASS")
+
+
+if __name__ == "__main__":
+    main()
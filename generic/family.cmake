@@ -5,3 +5,12 @@ foreach(uarch ${VIADUCT_UARCHES})
         target_sources(${target} PRIVATE ${UARCH_FILES})
     endforeach()
 endforeach(uarch)
+
+if (BUILD_TESTS)
+    add_test(NAME ${family}-checkpoint
+             COMMAND ${Python3_EXECUTABLE} ${CMAKE_CURRENT_SOURCE_DIR}/generic/examples/checkpoint_roundtrip.py
+                     $<TARGET_FILE:${PROGRAM_PREFIX}nextpnr-${family}> ${CMAKE_CURRENT_BINARY_DIR}/checkpoint-test)
+    add_test(NAME ${family}-legalise-threads
+             COMMAND ${Python3_EXECUTABLE} ${CMAKE_CURRENT_SOURCE_DIR}/generic/examples/legalise_threads.py
+                     $<TARGET_FILE:${PROGRAM_PREFIX}nextpnr-${family}> ${CMAKE_CURRENT_BINARY_DIR}/legalise-threads-test)
+endif()
@@ -70,6 +70,7 @@ void Arch::load_chipdb(const std::string &path)
     }
     try {
         blob_file.open(db_path);
+        blob_path = db_path;
         if (db_path.empty() || !blob_file.is_open())
             log_error("Unable to read chipdb %s\n", db_path.c_str());
         const char *blob = reinterpret_cast<const char *>(blob_file.data());
@@ -137,6 +138,8 @@ void Arch::init_tiles()
             NPNR_ASSERT(int(tile_name.size()) == tile);
             tile_name.push_back(name);
             tile_name2idx[name] = tile;
+            tile_wire_offset.push_back(wire_index_count);
+            wire_index_count += chip_tile_info(chip_info, tile).wires.ssize();
         }
     }
 }
@@ -231,6 +234,14 @@ bool Arch::route()
     set_fast_pip_delays(true);
     uarch->preRoute();
     std::string router = str_or_default(settings, id("router"), defaultRouter);
+    // router1's search is tuned around the coarse default estimate and gets slower with the lookahead, so only build it
+    // for router2, and only if the uarch's estimateDelay will use it
+    if (router == "router2" && uarch->useRouteLookahead() && !lookahead.is_init() &&
+        !args.options.count("no_lookahead")) {
+        auto cache = args.options.count("lookahead_cache") ? args.options.at("lookahead_cache")
+                                                           : HimbaechelLookahead::default_cache_file(blob_path);
+        lookahead.init(getCtx(), cache);
+    }
     bool result;
     if (router == "router1") {
         result = router1(getCtx(), Router1Cfg(getCtx()));
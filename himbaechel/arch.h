@@ -27,6 +27,7 @@
 #include "base_arch.h"
 #include "chipdb.h"
 #include "himbaechel_api.h"
+#include "himbaechel_lookahead.h"
 #include "nextpnr_namespaces.h"
 #include "nextpnr_types.h"
 
@@ -428,6 +429,7 @@ struct Arch : BaseArch<ArchRanges>
 
     // Database references
     boost::iostreams::mapped_file_source blob_file;
+    std::string blob_path;
     const ChipInfoPOD *chip_info;
     const PackageInfoPOD *package_info = nullptr;
     const SpeedGradePOD *speed_grade = nullptr;
@@ -493,6 +495,9 @@ struct Arch : BaseArch<ArchRanges>
         return IdString(chip_wire_info(chip_info, wire).const_value);
     }
     WireRange getWires() const override { return WireRange(chip_info); }
+    // Dense wire indices are tile wire indices offset by tile; non-canonical node wires leave holes in the range
+    int getWireIndexCount() const override { return wire_index_count; }
+    int getWireIndex(WireId wire) const override { return tile_wire_offset[wire.tile] + wire.index; }
     bool checkWireAvail(WireId wire) const override
     {
         if (!uarch->checkWireAvail(wire))
@@ -798,6 +803,11 @@ struct Arch : BaseArch<ArchRanges>
     void set_fast_pip_delays(bool fast_mode);
     std::vector<IdString> tile_name;
     dict<IdString, int> tile_name2idx;
+    // Built before routing, unless disabled with the no_lookahead option
+    HimbaechelLookahead lookahead;
+    // Start of each tile's wires in the dense wire index space
+    std::vector<int> tile_wire_offset;
+    int wire_index_count = 0;
 
     // -------------------------------------------------
     IdString get_tile_type(int tile) const;
@@ -43,7 +43,11 @@ bool HimbaechelAPI::isValidBelForCellType(IdString cell_type, BelId bel) const
 
 delay_t HimbaechelAPI::estimateDelay(WireId src, WireId dst) const
 {
-    // TODO: configurable lookahead
+    if (ctx->lookahead.is_init()) {
+        delay_t est = ctx->lookahead.estimateDelay(src, dst);
+        if (est >= 0)
+            return est;
+    }
     int sx, sy, dx, dy;
     tile_xy(ctx->chip_info, src.tile, sx, sy);
     tile_xy(ctx->chip_info, dst.tile, dx, dy);
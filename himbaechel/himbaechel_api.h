@@ -92,6 +92,9 @@ struct HimbaechelAPI
 
     // --- Route lookahead ---
     virtual delay_t estimateDelay(WireId src, WireId dst) const;
+    // Whether to build ctx->lookahead before routing; uarches that override estimateDelay without using it should
+    // return false
+    virtual bool useRouteLookahead() const { return true; }
     virtual delay_t predictDelay(BelId src_bel, IdString src_pin, BelId dst_bel, IdString dst_pin) const;
     virtual BoundingBox getRouteBoundingBox(WireId src, WireId dst) const;
 
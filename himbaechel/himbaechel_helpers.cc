@@ -51,7 +51,7 @@ void HimbaechelHelpers::remove_nextpnr_iobs(const pool<CellTypePort> &top_ports)
         to_remove.push_back(ci.name);
     }
     for (IdString cell_name : to_remove)
-        ctx->cells.erase(cell_name);
+        ctx->deleteCell(cell_name);
 }
 
 int HimbaechelHelpers::constrain_cell_pairs(const pool<CellTypePort> &src_ports, const pool<CellTypePort> &sink_ports,
@@ -137,7 +137,7 @@ void HimbaechelHelpers::replace_constants(CellTypePort vcc_driver, CellTypePort
         trim_nets.push_back(ni.name);
     }
     for (IdString cell_name : trim_cells)
-        ctx->cells.erase(cell_name);
+        ctx->deleteCell(cell_name);
     for (IdString net_name : trim_nets)
         ctx->nets.erase(net_name);
 }
@@ -0,0 +1,329 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  The nextpnr Authors
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "himbaechel_lookahead.h"
+
+#include <atomic>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <queue>
+
+#include "deterministic_rng.h"
+#include "log.h"
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+const uint32_t lookahead_magic = 0x4c4d4948; // "HIML"
+const int32_t lookahead_version = 2;
+
+uint64_t hash_blob(const char *data, size_t size)
+{
+    // FNV-1a over 64-bit words, this only needs to detect a changed database
+    uint64_t h = 0xcbf29ce484222325ULL;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        h = (h ^ word) * 0x100000001b3ULL;
+    }
+    for (; i < size; i++)
+        h = (h ^ uint8_t(data[i])) * 0x100000001b3ULL;
+    return h;
+}
+
+int32_t speed_grade_index(const Context *ctx)
+{
+    if (!ctx->speed_grade)
+        return -1;
+    return int32_t(ctx->speed_grade - ctx->chip_info->speed_grades.get());
+}
+} // namespace
+
+void HimbaechelLookahead::init(Context *ctx, const std::string &cache_file)
+{
+    this->ctx = ctx;
+    auto start = std::chrono::high_resolution_clock::now();
+    db_hash = hash_blob(ctx->blob_file.data(), ctx->blob_file.size());
+    setup_wire_types();
+    if (!cache_file.empty() && load(cache_file)) {
+        log_info("Loaded routing lookahead from '%s'.\n", cache_file.c_str());
+    } else {
+        log_info("Building routing lookahead for %d wire types...\n", int(tables.size()));
+        compute();
+        if (!cache_file.empty())
+            save(cache_file);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    log_info("Routing lookahead ready after %.02fs.\n", std::chrono::duration<float>(end - start).count());
+    initialised = true;
+}
+
+std::string HimbaechelLookahead::default_cache_file(const std::string &chipdb_path)
+{
+    boost::filesystem::path cache_dir;
+    if (const char *xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg)
+        cache_dir = xdg;
+    else if (const char *home = std::getenv("HOME"); home && *home)
+        cache_dir = boost::filesystem::path(home) / ".cache";
+    else if (const char *appdata = std::getenv("LOCALAPPDATA"); appdata && *appdata)
+        cache_dir = appdata;
+    else
+        return "";
+    auto name = boost::filesystem::path(chipdb_path).filename();
+    name += ".lookahead";
+    return (cache_dir / "nextpnr" / name).string();
+}
+
+delay_t HimbaechelLookahead::estimateDelay(WireId src, WireId dst) const
+{
+    const auto &type_table = tables[wire_to_table[ctx->chip_info->tile_insts[src.tile].type][src.index]];
+    const auto &table = pin_wires[ctx->getWireIndex(dst)] ? type_table.to_pin : type_table.to_wire;
+    if (table.cost.empty())
+        return -1;
+    int sx, sy, dx, dy;
+    tile_xy(ctx->chip_info, src.tile, sx, sy);
+    tile_xy(ctx->chip_info, dst.tile, dx, dy);
+    int ox = dx - sx, oy = dy - sy;
+    int cx = std::max(-max_dist, std::min(ox, max_dist)), cy = std::max(-max_dist, std::min(oy, max_dist));
+    delay_t est = table.cost[(cy + max_dist) * table_dim + (cx + max_dist)];
+    return est + table.per_tile * (std::abs(ox - cx) + std::abs(oy - cy));
+}
+
+void HimbaechelLookahead::setup_wire_types()
+{
+    dict<int32_t, int> type_to_table;
+    wire_to_table.resize(ctx->chip_info->tile_types.ssize());
+    for (int tt = 0; tt < ctx->chip_info->tile_types.ssize(); tt++) {
+        const auto &tile_type = ctx->chip_info->tile_types[tt];
+        for (const auto &wire : tile_type.wires) {
+            auto fnd = type_to_table.find(wire.wire_type);
+            if (fnd == type_to_table.end()) {
+                fnd = type_to_table.emplace(wire.wire_type, int(tables.size())).first;
+                tables.emplace_back();
+                tables.back().wire_type = wire.wire_type;
+            }
+            wire_to_table[tt].push_back(fnd->second);
+        }
+    }
+    pin_wires.resize(ctx->getWireIndexCount());
+    for (auto wire : ctx->getWires()) {
+        auto bel_pins = ctx->getWireBelPins(wire);
+        pin_wires[ctx->getWireIndex(wire)] = (bel_pins.begin() != bel_pins.end());
+    }
+}
+
+void HimbaechelLookahead::compute()
+{
+    // Pick the source wires for each type by reservoir sampling, so they are spread evenly over the device
+    DeterministicRNG rng;
+    std::vector<std::vector<WireId>> sources(tables.size());
+    std::vector<int> seen(tables.size());
+    for (auto wire : ctx->getWires()) {
+        int idx = wire_to_table[ctx->chip_info->tile_insts[wire.tile].type][wire.index];
+        int count = ++seen[idx];
+        if (count <= samples_per_type) {
+            sources[idx].push_back(wire);
+        } else {
+            int r = rng.rng(count);
+            if (r < samples_per_type)
+                sources[idx][r] = wire;
+        }
+    }
+#if defined(NPNR_DISABLE_THREADS)
+    for (int i = 0; i < int(tables.size()); i++)
+        compute_type(tables[i], sources[i]);
+#else
+    // Each type is independent and the routing graph is only read, so types can be shared out between threads
+    std::atomic<int> next_type(0);
+    auto worker = [&]() {
+        for (int i = next_type++; i < int(tables.size()); i = next_type++)
+            compute_type(tables[i], sources[i]);
+    };
+    int thread_count = std::max(1, std::min(ctx->setting<int>("threads", 8), int(tables.size())));
+    std::vector<boost::thread> threads;
+    for (int i = 0; i < thread_count; i++)
+        threads.emplace_back(worker);
+    for (auto &t : threads)
+        t.join();
+#endif
+}
+
+void HimbaechelLookahead::compute_type(TypeTable &table, const std::vector<WireId> &sources) const
+{
+    if (sources.empty())
+        return;
+    table.to_pin.cost.assign(table_dim * table_dim, -1);
+    table.to_wire.cost.assign(table_dim * table_dim, -1);
+    typedef std::pair<delay_t, WireId> QueuedWire;
+    for (WireId src : sources) {
+        int sx, sy;
+        tile_xy(ctx->chip_info, src.tile, sx, sy);
+        dict<WireId, delay_t> visited;
+        std::priority_queue<QueuedWire, std::vector<QueuedWire>, std::greater<QueuedWire>> queue;
+        visited[src] = 0;
+        queue.emplace(0, src);
+        while (!queue.empty() && int(visited.size()) < max_visit) {
+            auto curr = queue.top();
+            queue.pop();
+            if (curr.first > visited.at(curr.second))
+                continue;
+            int x, y;
+            tile_xy(ctx->chip_info, curr.second.tile, x, y);
+            int dx = x - sx, dy = y - sy;
+            if (std::abs(dx) > max_dist || std::abs(dy) > max_dist)
+                continue;
+            if (curr.second != src) {
+                auto record = [&](CostTable &cost_table) {
+                    delay_t &entry = cost_table.cost[(dy + max_dist) * table_dim + (dx + max_dist)];
+                    if (entry == -1 || curr.first < entry)
+                        entry = curr.first;
+                };
+                record(table.to_wire);
+                if (pin_wires[ctx->getWireIndex(curr.second)])
+                    record(table.to_pin);
+            }
+            for (PipId pip : ctx->getPipsDownhill(curr.second)) {
+                WireId next = ctx->getPipDstWire(pip);
+                delay_t next_cost =
+                        curr.first + ctx->getPipDelay(pip).maxDelay() + ctx->getWireDelay(next).maxDelay();
+                auto fnd = visited.find(next);
+                if (fnd != visited.end() && fnd->second <= next_cost)
+                    continue;
+                visited[next] = next_cost;
+                queue.emplace(next_cost, next);
+            }
+        }
+    }
+    finish_table(table.to_pin);
+    finish_table(table.to_wire);
+}
+
+void HimbaechelLookahead::finish_table(CostTable &table)
+{
+    // The best delay per tile seen is used to extrapolate, keeping the estimate optimistic
+    for (int dy = -max_dist; dy <= max_dist; dy++) {
+        for (int dx = -max_dist; dx <= max_dist; dx++) {
+            delay_t entry = table.cost[(dy + max_dist) * table_dim + (dx + max_dist)];
+            int dist = std::abs(dx) + std::abs(dy);
+            if (entry == -1 || dist == 0)
+                continue;
+            if (table.per_tile == -1 || entry / dist < table.per_tile)
+                table.per_tile = entry / dist;
+        }
+    }
+    if (table.per_tile == -1) {
+        // Nothing outside the source tile was reached, leave this type to the fallback estimate
+        table.cost.clear();
+        return;
+    }
+    // Fill unreached offsets with a two-pass Manhattan distance transform from the reached ones
+    auto relax = [&](int x, int y, int nx, int ny) {
+        if (nx < 0 || nx >= table_dim || ny < 0 || ny >= table_dim)
+            return;
+        delay_t from = table.cost[ny * table_dim + nx];
+        delay_t &to = table.cost[y * table_dim + x];
+        if (from != -1 && (to == -1 || from + table.per_tile < to))
+            to = from + table.per_tile;
+    };
+    for (int y = 0; y < table_dim; y++)
+        for (int x = 0; x < table_dim; x++) {
+            relax(x, y, x - 1, y);
+            relax(x, y, x, y - 1);
+        }
+    for (int y = table_dim - 1; y >= 0; y--)
+        for (int x = table_dim - 1; x >= 0; x--) {
+            relax(x, y, x + 1, y);
+            relax(x, y, x, y + 1);
+        }
+}
+
+bool HimbaechelLookahead::load(const std::string &cache_file)
+{
+    std::ifstream in(cache_file, std::ios::binary);
+    if (!in)
+        return false;
+    auto read_i32 = [&]() {
+        int32_t value = 0;
+        in.read(reinterpret_cast<char *>(&value), sizeof(value));
+        return value;
+    };
+    uint32_t magic = read_i32();
+    int32_t version = read_i32();
+    uint64_t hash = 0;
+    in.read(reinterpret_cast<char *>(&hash), sizeof(hash));
+    int32_t speed_grade = read_i32();
+    int32_t dist = read_i32();
+    int32_t table_count = read_i32();
+    if (!in || magic != lookahead_magic || version != lookahead_version || hash != db_hash ||
+        speed_grade != speed_grade_index(ctx) || dist != max_dist || table_count != int32_t(tables.size()))
+        return false;
+    auto read_table = [&](CostTable &table) {
+        table.per_tile = read_i32();
+        int32_t size = read_i32();
+        if (!in || (size != 0 && size != table_dim * table_dim))
+            return false;
+        table.cost.resize(size);
+        in.read(reinterpret_cast<char *>(table.cost.data()), size * sizeof(delay_t));
+        return bool(in);
+    };
+    for (auto &table : tables) {
+        if (read_i32() != table.wire_type)
+            return false;
+        if (!read_table(table.to_pin) || !read_table(table.to_wire))
+            return false;
+    }
+    return true;
+}
+
+void HimbaechelLookahead::save(const std::string &cache_file) const
+{
+    boost::system::error_code ec;
+    auto parent = boost::filesystem::path(cache_file).parent_path();
+    if (!parent.empty())
+        boost::filesystem::create_directories(parent, ec);
+    std::ofstream out(cache_file, std::ios::binary);
+    auto write_i32 = [&](int32_t value) { out.write(reinterpret_cast<const char *>(&value), sizeof(value)); };
+    write_i32(lookahead_magic);
+    write_i32(lookahead_version);
+    out.write(reinterpret_cast<const char *>(&db_hash), sizeof(db_hash));
+    write_i32(speed_grade_index(ctx));
+    write_i32(max_dist);
+    write_i32(int32_t(tables.size()));
+    auto write_table = [&](const CostTable &table) {
+        write_i32(table.per_tile);
+        write_i32(int32_t(table.cost.size()));
+        out.write(reinterpret_cast<const char *>(table.cost.data()), table.cost.size() * sizeof(delay_t));
+    };
+    for (const auto &table : tables) {
+        write_i32(table.wire_type);
+        write_table(table.to_pin);
+        write_table(table.to_wire);
+    }
+    if (!out)
+        log_warning("Unable to write routing lookahead cache '%s'; use -o lookahead_cache=<file> to choose another "
+                    "location.\n",
+                    cache_file.c_str());
+}
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,101 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  The nextpnr Authors
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef HIMBAECHEL_LOOKAHEAD_H
+#define HIMBAECHEL_LOOKAHEAD_H
+
+#include <string>
+#include <vector>
+
+#include "nextpnr_namespaces.h"
+#include "nextpnr_types.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+struct Context;
+
+/*
+Routing lookahead for himbächel arches
+
+For every wire type, a few wires of that type are sampled across the device and a Dijkstra search run from each of
+them, recording the minimum delay to reach a bel pin wire, and separately any wire, at each tile offset (dx, dy) up to
+max_dist away. The first is used when the destination is a bel pin wire, as it always is when routing forwards; the
+second when it isn't, as happens in router2's backwards search, where the delay to a pin would be pessimistic. Offsets
+that were not reached are filled in by extrapolating with the best delay per tile seen for that wire type, as is the
+region outside of max_dist at lookup time.
+
+Building the tables is expensive for large devices, so they are cached in the user's cache directory and keyed on a
+hash of the chipdb blob and the speed grade.
+*/
+
+struct HimbaechelLookahead
+{
+    // Load the tables from cache_file if it matches the current database, otherwise compute and then save them there.
+    // With an empty cache_file they are always computed, and not saved
+    void init(Context *ctx, const std::string &cache_file);
+    // <cache dir>/nextpnr/<chipdb name>.lookahead, where the cache dir is $XDG_CACHE_HOME, ~/.cache or
+    // %LOCALAPPDATA%; empty if none of those are set
+    static std::string default_cache_file(const std::string &chipdb_path);
+    bool is_init() const { return initialised; }
+    // Only valid once init has been called; returns -1 if there is no data for the type of src
+    delay_t estimateDelay(WireId src, WireId dst) const;
+
+  private:
+    static constexpr int max_dist = 16;
+    static constexpr int table_dim = 2 * max_dist + 1;
+    // Number of wires of each type to run a search from
+    static constexpr int samples_per_type = 4;
+    // Limit on wires visited in each search, to bound runtime on large devices
+    static constexpr int max_visit = 50000;
+
+    struct CostTable
+    {
+        // Extrapolation for offsets that weren't reached; -1 if nothing outside the source tile was reached, in which
+        // case the fallback estimate is used
+        delay_t per_tile = -1;
+        // Indexed by (dy + max_dist) * table_dim + (dx + max_dist)
+        std::vector<delay_t> cost;
+    };
+
+    struct TypeTable
+    {
+        int32_t wire_type = -1;
+        CostTable to_pin, to_wire;
+    };
+
+    Context *ctx = nullptr;
+    bool initialised = false;
+    uint64_t db_hash = 0;
+    // [tile type][tile wire] -> index into tables
+    std::vector<std::vector<int>> wire_to_table;
+    std::vector<TypeTable> tables;
+    // By wire index, whether the wire has any bel pins
+    std::vector<bool> pin_wires;
+
+    void setup_wire_types();
+    void compute();
+    void compute_type(TypeTable &table, const std::vector<WireId> &sources) const;
+    static void finish_table(CostTable &table);
+    bool load(const std::string &cache_file);
+    void save(const std::string &cache_file) const;
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif
@@ -385,7 +385,7 @@ struct GowinGlobalRouter
         // remove the virtual DQCE
         dqce_ci->disconnectPort(id_CLKIN);
         dqce_ci->disconnectPort(id_CE);
-        ctx->cells.erase(dqce_ci->name);
+        ctx->deleteCell(dqce_ci->name);
     }
 
     void route_dcs_net(NetInfo *net)
@@ -479,7 +479,7 @@ struct GowinGlobalRouter
             dcs_ci->disconnectPort(ctx->idf("CLK%d", i));
         }
         log_info("    '%s' net was routed.\n", ctx->nameOf(net));
-        ctx->cells.erase(dcs_ci->name);
+        ctx->deleteCell(dcs_ci->name);
     }
 
     void route_dhcen_net(NetInfo *net)
@@ -556,7 +556,7 @@ struct GowinGlobalRouter
         dhcen_ci->disconnectPort(id_CLKOUT);
         dhcen_ci->disconnectPort(id_CLKIN);
         dhcen_ci->disconnectPort(id_CE);
-        ctx->cells.erase(dhcen_ci->name);
+        ctx->deleteCell(dhcen_ci->name);
     }
 
     void route_buffered_net(NetInfo *net)
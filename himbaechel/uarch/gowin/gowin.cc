@@ -793,7 +793,7 @@ void GowinImpl::create_passthrough_luts(void)
         }
     }
     for (auto &cell : new_cells) {
-        ctx->cells[cell->name] = std::move(cell);
+        ctx->addCell(std::move(cell));
     }
 }
 
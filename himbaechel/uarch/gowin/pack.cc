@@ -159,7 +159,7 @@ struct GowinPacker
             to_remove.push_back(ci.name);
         }
         for (IdString cell_name : to_remove)
-            ctx->cells.erase(cell_name);
+            ctx->deleteCell(cell_name);
     }
 
     BelId bind_io(CellInfo &ci)
@@ -322,7 +322,7 @@ struct GowinPacker
         }
 
         for (auto cell : cells_to_remove) {
-            ctx->cells.erase(cell);
+            ctx->deleteCell(cell);
         }
         for (auto net : nets_to_remove) {
             ctx->nets.erase(net);
@@ -1203,7 +1203,7 @@ struct GowinPacker
             }
         }
         for (auto &ncell : new_cells) {
-            ctx->cells[ncell->name] = std::move(ncell);
+            ctx->addCell(std::move(ncell));
         }
     }
 
@@ -1304,7 +1304,7 @@ struct GowinPacker
             }
         }
         for (auto &ncell : new_cells) {
-            ctx->cells[ncell->name] = std::move(ncell);
+            ctx->addCell(std::move(ncell));
         }
     }
 
@@ -1840,22 +1840,22 @@ struct GowinPacker
                 case ID_pROMX9: /* fallthrough */
                 case ID_pROM:
                     pack_ROM(ci);
-                    ci->type = id_ROM;
+                    ctx->setCellType(ci, id_ROM);
                     break;
                 case ID_SDPX9B: /* fallthrough */
                 case ID_SDPB:
                     pack_SDPB(ci);
-                    ci->type = id_SDP;
+                    ctx->setCellType(ci, id_SDP);
                     break;
                 case ID_DPX9B: /* fallthrough */
                 case ID_DPB:
                     pack_DPB(ci);
-                    ci->type = id_DP;
+                    ctx->setCellType(ci, id_DP);
                     break;
                 case ID_SPX9: /* fallthrough */
                 case ID_SP:
                     pack_SP(ci, new_cells);
-                    ci->type = id_SP;
+                    ctx->setCellType(ci, id_SP);
                     break;
                 default:
                     log_error("Unsupported BSRAM type '%s'\n", ci->type.c_str(ctx));
@@ -1864,7 +1864,7 @@ struct GowinPacker
         }
 
         for (auto &cell : new_cells) {
-            ctx->cells[cell->name] = std::move(cell);
+            ctx->addCell(std::move(cell));
         }
     }
 
@@ -2577,11 +2577,10 @@ struct GowinPacker
         for (auto &cell : new_cells) {
             if (cell->cluster != ClusterId()) {
                 IdString cluster_root = cell->cluster;
-                IdString cell_name = cell->name;
-                ctx->cells[cell_name] = std::move(cell);
-                ctx->cells.at(cluster_root).get()->constr_children.push_back(ctx->cells.at(cell_name).get());
+                CellInfo *new_ci = ctx->addCell(std::move(cell));
+                ctx->cells.at(cluster_root).get()->constr_children.push_back(new_ci);
             } else {
-                ctx->cells[cell->name] = std::move(cell);
+                ctx->addCell(std::move(cell));
             }
         }
 
@@ -2805,21 +2804,13 @@ struct GowinPacker
     {
         log_info("Pack GSR...\n");
 
-        bool user_gsr = false;
-        for (auto &cell : ctx->cells) {
-            auto &ci = *cell.second;
-
-            if (ci.type == id_GSR) {
-                user_gsr = true;
-                break;
-            }
-        }
+        bool user_gsr = !ctx->getCellsByType(id_GSR).empty();
         if (!user_gsr) {
             // make default GSR
             auto gsr_cell = std::make_unique<CellInfo>(ctx, id_GSR, id_GSR);
             gsr_cell->addInput(id_GSRI);
             gsr_cell->connectPort(id_GSRI, ctx->nets.at(ctx->id("$PACKER_VCC")).get());
-            ctx->cells[gsr_cell->name] = std::move(gsr_cell);
+            ctx->addCell(std::move(gsr_cell));
         }
         if (ctx->verbose) {
             if (user_gsr) {
@@ -2840,21 +2831,13 @@ struct GowinPacker
         }
         log_info("Pack BANDGAP...\n");
 
-        bool user_bandgap = false;
-        for (auto &cell : ctx->cells) {
-            auto &ci = *cell.second;
-
-            if (ci.type == id_BANDGAP) {
-                user_bandgap = true;
-                break;
-            }
-        }
+        bool user_bandgap = !ctx->getCellsByType(id_BANDGAP).empty();
         if (!user_bandgap) {
             // make default BANDGAP
             auto bandgap_cell = std::make_unique<CellInfo>(ctx, id_BANDGAP, id_BANDGAP);
             bandgap_cell->addInput(id_BGEN);
             bandgap_cell->connectPort(id_BGEN, ctx->nets.at(ctx->id("$PACKER_VCC")).get());
-            ctx->cells[bandgap_cell->name] = std::move(bandgap_cell);
+            ctx->addCell(std::move(bandgap_cell));
         }
         if (ctx->verbose) {
             if (user_bandgap) {
@@ -2872,15 +2855,11 @@ struct GowinPacker
     {
         log_info("Pack INV...\n");
 
-        for (auto &cell : ctx->cells) {
-            auto &ci = *cell.second;
-
-            if (ci.type == id_INV) {
-                ci.type = id_LUT4;
-                ci.renamePort(id_O, id_F);
-                ci.renamePort(id_I, id_I3); // use D - it's simple for INIT
-                ci.params[id_INIT] = Property(0x00ff);
-            }
+        for (CellInfo *ci : ctx->getCellsByType(id_INV)) {
+            ctx->setCellType(ci, id_LUT4);
+            ci->renamePort(id_O, id_F);
+            ci->renamePort(id_I, id_I3); // use D - it's simple for INIT
+            ci->params[id_INIT] = Property(0x00ff);
         }
     }
 
@@ -2939,10 +2918,7 @@ struct GowinPacker
     {
         log_info("Pack HCLK cells...\n");
 
-        for (auto &cell : ctx->cells) {
-            auto ci = cell.second.get();
-            if (ci->type != id_CLKDIV)
-                continue;
+        for (CellInfo *ci : ctx->getCellsByType(id_CLKDIV)) {
             NetInfo *hclk_in = ci->getPort(id_HCLKIN);
             if (hclk_in) {
                 CellInfo *this_driver = hclk_in->driver.cell;
@@ -3007,12 +2983,9 @@ struct GowinPacker
         // use is made during routing, but some of the information (let’s say
         // mapping cell pins -> bel pins) is filled in before routing.
         bool grab_bels = false;
-        for (auto &cell : ctx->cells) {
-            auto &ci = *cell.second;
-            if (ci.type == id_DQCE) {
-                ci.pseudo_cell = std::make_unique<RegionPlug>(Loc(0, 0, 0));
-                grab_bels = true;
-            }
+        for (CellInfo *ci : ctx->getCellsByType(id_DQCE)) {
+            ci->pseudo_cell = std::make_unique<RegionPlug>(Loc(0, 0, 0));
+            grab_bels = true;
         }
         if (grab_bels) {
             for (int i = 0; i < 32; ++i) {
@@ -3042,12 +3015,9 @@ struct GowinPacker
         // use is made during routing, but some of the information (let’s say
         // mapping cell pins -> bel pins) is filled in before routing.
         bool grab_bels = false;
-        for (auto &cell : ctx->cells) {
-            auto &ci = *cell.second;
-            if (ci.type == id_DCS) {
-                ci.pseudo_cell = std::make_unique<RegionPlug>(Loc(0, 0, 0));
-                grab_bels = true;
-            }
+        for (CellInfo *ci : ctx->getCellsByType(id_DCS)) {
+            ci->pseudo_cell = std::make_unique<RegionPlug>(Loc(0, 0, 0));
+            grab_bels = true;
         }
         if (grab_bels) {
             for (int i = 0; i < 8; ++i) {
@@ -3075,12 +3045,9 @@ struct GowinPacker
         // Allocate all available dhcen bels; we will find out which of them
         // will actually be used during the routing process.
         bool grab_bels = false;
-        for (auto &cell : ctx->cells) {
-            auto &ci = *cell.second;
-            if (ci.type == id_DHCEN) {
-                ci.pseudo_cell = std::make_unique<RegionPlug>(Loc(0, 0, 0));
-                grab_bels = true;
-            }
+        for (CellInfo *ci : ctx->getCellsByType(id_DHCEN)) {
+            ci->pseudo_cell = std::make_unique<RegionPlug>(Loc(0, 0, 0));
+            grab_bels = true;
         }
         if (grab_bels) {
             // sane message if new primitives are used with old bases
@@ -3188,7 +3155,7 @@ struct GowinPacker
             }
         }
         for (auto &ncell : new_cells) {
-            ctx->cells[ncell->name] = std::move(ncell);
+            ctx->addCell(std::move(ncell));
         }
     }
 
@@ -23,12 +23,14 @@
 
 #include <fstream>
 #include <regex>
+#include <sstream>
 
 #include "extra_data.h"
 #include "himbaechel_api.h"
 #include "log.h"
 #include "nextpnr.h"
 #include "pins.h"
+#include "thread_pool.h"
 #include "util.h"
 
 #include "xilinx.h"
@@ -42,13 +44,28 @@ struct FasmBackend
 {
     Context *ctx;
     XilinxImpl *uarch;
-    std::ostream &out;
+    std::ostream &file;
+    // Features are formatted into this buffer, and handed to the file in large blocks
+    std::ostringstream out;
     std::vector<std::string> fasm_ctx;
     dict<int, std::vector<PipId>> pips_by_tile;
+    std::vector<std::string> tile_names;
 
     dict<IdString, pool<IdString>> invertible_pins;
 
-    FasmBackend(Context *ctx, XilinxImpl *uarch, std::ostream &out) : ctx(ctx), uarch(uarch), out(out) {};
+    FasmBackend(Context *ctx, XilinxImpl *uarch, std::ostream &file) : ctx(ctx), uarch(uarch), file(file) {};
+
+    static constexpr std::streamoff flush_size = 1 << 20;
+    void flush_output(bool force = false)
+    {
+        if (!force && out.tellp() < flush_size)
+            return;
+        std::string buf = out.str();
+        file.write(buf.data(), buf.size());
+        out.str(std::string());
+    }
+
+    const std::string &get_tile_name(int tile) const { return tile_names.at(tile); }
 
     void push(const std::string &x) { fasm_ctx.push_back(x); }
 
@@ -63,8 +80,9 @@ struct FasmBackend
     void blank()
     {
         if (!last_was_blank)
-            out << std::endl;
+            out << '\n';
         last_was_blank = true;
+        flush_output();
     }
 
     void write_prefix()
@@ -78,7 +96,7 @@ struct FasmBackend
     {
         if (value) {
             write_prefix();
-            out << name << std::endl;
+            out << name << '\n';
         }
     }
 
@@ -88,7 +106,7 @@ struct FasmBackend
         out << name << " = " << int(value.size()) << "'b";
         for (auto bit : boost::adaptors::reverse(value))
             out << ((bit ^ invert) ? '1' : '0');
-        out << std::endl;
+        out << '\n';
     }
 
     void write_int_vector(const std::string &name, uint64_t value, int width, bool invert = false)
@@ -219,21 +237,20 @@ struct FasmBackend
         }
     }
 
-    void write_pip(PipId pip, NetInfo *net)
+    // Write the features for one routing pip to os, returning true if any were written. This only reads from the
+    // context, and reports warnings back rather than logging them, so it can be called from several threads at once.
+    bool write_pip(std::ostream &os, PipId pip, std::vector<std::string> &warnings) const
     {
-
-        pips_by_tile[pip.tile].push_back(pip);
-
         auto dst_intent = ctx->getWireType(ctx->getPipDstWire(pip));
         if (dst_intent == id_PSEUDO_GND || dst_intent == id_PSEUDO_VCC)
-            return;
+            return false;
 
         auto &pd = chip_pip_info(ctx->chip_info, pip);
         const auto &extra_data = *reinterpret_cast<const XlnxPipExtraDataPOD *>(pd.extra_data.get());
         unsigned pip_type = pd.flags;
 
         if (pip_type != PIP_TILE_ROUTING && pip_type != PIP_SITE_INTERNAL)
-            return;
+            return false;
 
         IdString src = IdString(chip_tile_info(ctx->chip_info, pip.tile).wires[pd.src_wire].name);
         IdString dst = IdString(chip_tile_info(ctx->chip_info, pip.tile).wires[pd.dst_wire].name);
@@ -255,11 +272,11 @@ struct FasmBackend
                     boost::erase_all(loc, "_T1");
                     boost::replace_all(loc, "IOI_OLOGIC", "OLOGIC_Y");
                     // the replacements transformed it into : LIOI3_X0Y73.OLOGIC_Y1
-                    out << loc << "."
-                        << "ZINV_T1" << std::endl;
+                    os << loc << "."
+                       << "ZINV_T1" << '\n';
                 }
             }
-            return;
+            return false;
         }
 
         // handle tile routing pips
@@ -268,7 +285,7 @@ struct FasmBackend
 
         if (pp_config.count(ppk)) {
             auto &pp = pp_config.at(ppk);
-            std::string tile_name = uarch->tile_name(pip.tile);
+            const std::string &tile_name = get_tile_name(pip.tile);
             for (auto c : pp) {
                 if (boost::starts_with(tile_name, "RIOI3_SING") || boost::starts_with(tile_name, "LIOI3_SING") ||
                     boost::starts_with(tile_name, "RIOI_SING")) {
@@ -280,21 +297,21 @@ struct FasmBackend
                             c.replace(y0pos, 2, "Y1");
                     }
                 }
-                out << tile_name << "." << c << std::endl;
+                os << tile_name << "." << c << '\n';
             }
-            if (!pp.empty())
-                last_was_blank = false;
+            return !pp.empty();
         } else {
             if (extra_data.pip_config == 1)
-                log_warning("Unprocessed route-thru %s.%s.%s\n!", tile_type.c_str(ctx), src.c_str(ctx), dst.c_str(ctx));
+                warnings.push_back(stringf("Unprocessed route-thru %s.%s.%s\n!", tile_type.c_str(ctx), src.c_str(ctx),
+                                           dst.c_str(ctx)));
 
-            std::string tile_name = uarch->tile_name(pip.tile);
+            const std::string &tile_name = get_tile_name(pip.tile);
             std::string dst_name = dst.str(ctx);
             std::string src_name = src.str(ctx);
 
             if (boost::starts_with(tile_name, "DSP_L") || boost::starts_with(tile_name, "DSP_R")) {
                 // FIXME: PPIPs missing for DSPs
-                return;
+                return false;
             }
             std::string orig_dst_name = dst_name;
             if (boost::starts_with(tile_name, "RIOI3_SING") || boost::starts_with(tile_name, "LIOI3_SING") ||
@@ -302,7 +319,7 @@ struct FasmBackend
                 // FIXME: PPIPs missing for SING IOI3s
                 if ((boost::contains(src_name, "IMUX") || boost::contains(src_name, "CTRL0")) &&
                     !boost::contains(dst_name, "CLK"))
-                    return;
+                    return false;
                 auto spos = src_name.find("_SING_");
                 if (spos != std::string::npos)
                     src_name.erase(spos, 5);
@@ -325,12 +342,12 @@ struct FasmBackend
             }
             if (boost::contains(tile_name, "IOI")) {
                 if (boost::contains(dst_name, "OCLKB") && boost::contains(src_name, "IOI_OCLKM_"))
-                    return; // missing, not sure if really a ppip?
+                    return false; // missing, not sure if really a ppip?
             }
 
-            out << tile_name << ".";
-            out << dst_name << ".";
-            out << src_name << std::endl;
+            os << tile_name << ".";
+            os << dst_name << ".";
+            os << src_name << '\n';
 
             if (boost::contains(tile_name, "IOI") && boost::starts_with(dst_name, "IOI_OCLK_")) {
                 dst_name.insert(dst_name.find("OCLK") + 4, 1, 'M');
@@ -340,13 +357,13 @@ struct FasmBackend
 
                 NPNR_ASSERT(w != WireId());
                 if (ctx->getBoundWireNet(w) == nullptr) {
-                    out << tile_name << ".";
-                    out << dst_name << ".";
-                    out << src_name << std::endl;
+                    os << tile_name << ".";
+                    os << dst_name << ".";
+                    os << src_name << '\n';
                 }
             }
 
-            last_was_blank = false;
+            return true;
         }
     };
 
@@ -464,7 +481,7 @@ struct FasmBackend
                 out << belname;
                 if (!skip_pinname)
                     out << "." << pinname;
-                out << std::endl;
+                out << '\n';
             }
         }
     }
@@ -488,7 +505,7 @@ struct FasmBackend
             dst = (src);                                                                                               \
     } while (0)
 
-        std::string tname = uarch->tile_name(tile);
+        std::string tname = get_tile_name(tile);
 
         const auto &lts = uarch->tile_status.at(tile).lts;
         if (!lts)
@@ -603,7 +620,7 @@ struct FasmBackend
     {
         bool wa7_used = false, wa8_used = false;
 
-        std::string tname = uarch->tile_name(tile);
+        std::string tname = get_tile_name(tile);
         bool is_mtile = boost::contains(tname, "CLBLM");
         bool is_slicem = is_mtile && (half == 0);
 
@@ -667,7 +684,7 @@ struct FasmBackend
 
     void write_carry_config(int tile, int half)
     {
-        std::string tname = uarch->tile_name(tile);
+        std::string tname = get_tile_name(tile);
         bool is_mtile = boost::contains(tname, "CLBLM");
 
         const auto &lts = uarch->tile_status.at(tile).lts;
@@ -708,17 +725,52 @@ struct FasmBackend
         }
     }
 
+    struct NetFeatures
+    {
+        std::string text;
+        bool any_written = false;
+        std::vector<std::string> warnings;
+    };
+
     void write_routing()
     {
         get_pseudo_pip_data();
-        for (auto &net : ctx->nets) {
-            NetInfo *ni = net.second.get();
-            out << stringf("# routing for net %s", ni->name.c_str(ctx)) << std::endl;
-            for (auto &w : ni->wires) {
-                if (w.second.pip != PipId())
-                    write_pip(w.second.pip, ni);
+        std::vector<NetInfo *> nets;
+        for (auto &net : ctx->nets)
+            nets.push_back(net.second.get());
+
+        // The features for each net only depend on its own pips, so batches of nets are formatted in parallel into
+        // their own buffers, which are then written out in net order; the output is the same as formatting serially.
+        const int batch_size = 4096;
+        ThreadPool thread_pool(std::max(1, ctx->setting<int>("threads", 8)));
+        std::vector<NetFeatures> features;
+        for (int batch_start = 0; batch_start < int(nets.size()); batch_start += batch_size) {
+            int batch_end = std::min(int(nets.size()), batch_start + batch_size);
+            features.clear();
+            features.resize(batch_end - batch_start);
+            thread_pool.run(batch_end - batch_start, [&](int i) {
+                std::ostringstream os;
+                NetFeatures &nf = features.at(i);
+                for (auto &w : nets.at(batch_start + i)->wires) {
+                    if (w.second.pip != PipId() && write_pip(os, w.second.pip, nf.warnings))
+                        nf.any_written = true;
+                }
+                nf.text = os.str();
+            });
+            for (int i = batch_start; i < batch_end; i++) {
+                NetInfo *ni = nets.at(i);
+                NetFeatures &nf = features.at(i - batch_start);
+                for (auto &warning : nf.warnings)
+                    log_warning("%s", warning.c_str());
+                out << "# routing for net " << ni->name.str(ctx) << '\n' << nf.text;
+                for (auto &w : ni->wires) {
+                    if (w.second.pip != PipId())
+                        pips_by_tile[w.second.pip.tile].push_back(w.second.pip);
+                }
+                if (nf.any_written)
+                    last_was_blank = false;
+                blank();
             }
-            blank();
         }
     }
 
@@ -748,7 +800,7 @@ struct FasmBackend
         for (auto &usr : pad_net->users)
             if (boost::contains(usr.cell->type.str(ctx), "INBUF"))
                 is_input = true;
-        std::string tile = uarch->tile_name(pad->bel.tile);
+        std::string tile = get_tile_name(pad->bel.tile);
         push(tile);
 
         bool is_riob18 = boost::starts_with(tile, "RIOB18_");
@@ -953,7 +1005,7 @@ struct FasmBackend
 
     void write_iol_config(CellInfo *ci)
     {
-        std::string tile = uarch->tile_name(ci->bel.tile);
+        std::string tile = get_tile_name(ci->bel.tile);
         push(tile);
         bool is_sing = boost::contains(tile, "_SING_");
         bool is_top_sing = ci->bel.tile < uarch->hclk_for_ioi(ci->bel.tile);
@@ -1155,7 +1207,7 @@ struct FasmBackend
             }
         }
         for (auto &hclk : ioconfig_by_hclk) {
-            push(uarch->tile_name(hclk.first));
+            push(get_tile_name(hclk.first));
             write_bit("STEPDOWN", hclk.second.stepdown);
             write_bit("VREF.V_675_MV", hclk.second.vref);
             write_bit("ONLY_DIFF_IN_USE", hclk.second.only_diff);
@@ -1190,7 +1242,7 @@ struct FasmBackend
         for (auto &cell : ctx->cells) {
             CellInfo *ci = cell.second.get();
             if (ci->type == id_BUFGCTRL) {
-                push(uarch->tile_name(ci->bel.tile));
+                push(get_tile_name(ci->bel.tile));
                 auto xy = uarch->rel_site_loc(uarch->get_bel_site(ci->bel));
                 push(stringf("BUFGCTRL.BUFGCTRL_X%dY%d", xy.x, xy.y));
                 write_bit("IN_USE");
@@ -1209,7 +1261,7 @@ struct FasmBackend
         }
 
         for (int tile = 0; tile < ctx->chip_info->tile_insts.ssize(); tile++) {
-            std::string name = uarch->tile_name(tile);
+            std::string name = get_tile_name(tile);
             std::string type = ctx->get_tile_type(tile).str(ctx);
             push(name);
             if (type == "HCLK_L" || type == "HCLK_R" || type == "HCLK_L_BOT_UTURN" || type == "HCLK_R_BOT_UTURN") {
@@ -1253,7 +1305,7 @@ struct FasmBackend
         }
 
         for (int tile = 0; tile < ctx->chip_info->tile_insts.ssize(); tile++) {
-            std::string name = uarch->tile_name(tile);
+            std::string name = get_tile_name(tile);
             std::string type = ctx->get_tile_type(tile).str(ctx);
             push(name);
             if (type == "CLK_BUFG_REBUF") {
@@ -1338,7 +1390,7 @@ struct FasmBackend
 
     void write_bram_half(int tile, int half, CellInfo *ci)
     {
-        push(uarch->tile_name(tile));
+        push(get_tile_name(tile));
         push("RAMB18_Y" + std::to_string(half));
         if (ci != nullptr) {
             bool is_36 = ci->type == id_RAMB36E1_RAMB36E1;
@@ -1457,7 +1509,7 @@ struct FasmBackend
 
     void write_pll(CellInfo *ci)
     {
-        push(uarch->tile_name(ci->bel.tile));
+        push(get_tile_name(ci->bel.tile));
         push("PLLE2_ADV");
         write_bit("IN_USE");
         // FIXME: should be INV not ZINV (XRay error?)
@@ -1493,7 +1545,7 @@ struct FasmBackend
 
     void write_dsp_cell(CellInfo *ci)
     {
-        auto tile_name = uarch->tile_name(ci->bel.tile);
+        auto tile_name = get_tile_name(ci->bel.tile);
         auto tile_side = tile_name.at(4);
         push(tile_name);
         push("DSP48");
@@ -1632,12 +1684,15 @@ struct FasmBackend
     void write_fasm()
     {
         get_invertible_pins(ctx, invertible_pins);
+        for (int tile = 0; tile < ctx->chip_info->tile_insts.ssize(); tile++)
+            tile_names.push_back(uarch->tile_name(tile));
         write_logic();
         write_io();
         write_routing();
         write_bram();
         write_clocking();
         write_ip();
+        flush_output(true);
     }
 };
 
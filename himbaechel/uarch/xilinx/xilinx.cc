@@ -18,12 +18,12 @@
  */
 
 #include <boost/algorithm/string.hpp>
-#include <queue>
 #include <regex>
 
 #include "himbaechel_api.h"
 #include "log.h"
 #include "nextpnr.h"
+#include "thread_pool.h"
 #include "util.h"
 
 #include "placer_heap.h"
@@ -426,92 +426,190 @@ bool XilinxImpl::is_general_routing(WireId wire) const
                       id_IOBIN2OUT, id_INTENT_SITE_WIRE, id_INTENT_SITE_GND);
 }
 
+namespace {
+// The result of searching from a site wire to the nearest general routing. Everything is stored relative to the tile
+// of the starting wire, so it can be reused for other tiles with the same type and routing shape.
+struct LocSearchResult
+{
+    struct PathWire
+    {
+        int dx, dy;
+        int type, shape;
+        int index;
+    };
+    bool found = false;
+    // Offset to the general routing wire that was found, and the type and shape of its tile
+    int dx = 0, dy = 0;
+    int type = -1, shape = -1;
+    // Wires from the one found (not included, unless it is the starting wire) back to the starting wire
+    std::vector<PathWire> path;
+};
+
+// Reused between searches done by the same thread
+struct LocSearchScratch
+{
+    std::vector<WireId> visit;
+    dict<WireId, WireId> backtrace;
+};
+
+struct LocSearchStart
+{
+    WireId wire;
+    bool is_source;
+    int memo; // index of the start whose search result is reused for this one
+};
+
+void search_general_routing(const XilinxImpl *impl, const LocSearchStart &start, LocSearchScratch &scratch,
+                            LocSearchResult &result)
+{
+    const Context *ctx = impl->ctx;
+    scratch.visit.clear();
+    scratch.backtrace.clear();
+    int sx, sy;
+    tile_xy(ctx->chip_info, start.wire.tile, sx, sy);
+    // as this is a best-effort optimisation to slightly improve routing,
+    // don't spend too long with a nice low iteration limit
+    const int iter_max = 500;
+    scratch.visit.push_back(start.wire);
+    for (int head = 0; head < int(scratch.visit.size()) && head < iter_max; head++) {
+        WireId cursor = scratch.visit.at(head);
+        if (impl->is_general_routing(cursor)) {
+            int x, y;
+            tile_xy(ctx->chip_info, cursor.tile, x, y);
+            result.found = true;
+            result.dx = x - sx;
+            result.dy = y - sy;
+            const auto &found_inst = ctx->chip_info->tile_insts[cursor.tile];
+            result.type = found_inst.type;
+            result.shape = found_inst.shape;
+            auto add_path = [&](WireId wire) {
+                tile_xy(ctx->chip_info, wire.tile, x, y);
+                const auto &inst = ctx->chip_info->tile_insts[wire.tile];
+                result.path.push_back({x - sx, y - sy, inst.type, inst.shape, wire.index});
+            };
+            if (cursor == start.wire)
+                add_path(cursor);
+            while (cursor != start.wire) {
+                cursor = scratch.backtrace.at(cursor);
+                add_path(cursor);
+            }
+            return;
+        }
+        auto visit = [&](WireId next) {
+            if (next != start.wire && !scratch.backtrace.count(next)) {
+                scratch.backtrace[next] = cursor;
+                scratch.visit.push_back(next);
+            }
+        };
+        if (start.is_source) {
+            for (auto pip : ctx->getPipsDownhill(cursor))
+                visit(ctx->getPipDstWire(pip));
+        } else {
+            for (auto pip : ctx->getPipsUphill(cursor))
+                visit(ctx->getPipSrcWire(pip));
+        }
+    }
+}
+
+// Apply a search result relative to the tile of start, returning false if its path doesn't fit the routing there
+bool translate_search_result(const Context *ctx, WireId start, const LocSearchResult &result,
+                             std::vector<std::pair<WireId, Loc>> &locs)
+{
+    const ChipInfoPOD *chip = ctx->chip_info;
+    int sx, sy;
+    tile_xy(chip, start.tile, sx, sy);
+    Loc loc(sx + result.dx, sy + result.dy, 0);
+    if (loc.x < 0 || loc.x >= chip->width || loc.y < 0 || loc.y >= chip->height)
+        return false;
+    // The general routing wire must be in the same kind of tile, as well as the path to it
+    const auto &found_inst = chip->tile_insts[loc.y * chip->width + loc.x];
+    if (found_inst.type != result.type || found_inst.shape != result.shape)
+        return false;
+    for (auto &pw : result.path) {
+        int x = sx + pw.dx, y = sy + pw.dy;
+        if (x < 0 || x >= chip->width || y < 0 || y >= chip->height)
+            return false;
+        int tile = y * chip->width + x;
+        const auto &inst = chip->tile_insts[tile];
+        if (inst.type != pw.type || inst.shape != pw.shape)
+            return false;
+        locs.emplace_back(WireId(tile, pw.index), loc);
+    }
+    return !locs.empty() && locs.back().first == start;
+}
+} // namespace
+
 void XilinxImpl::find_source_sink_locs()
 {
+    // Find the wires to search from, in the order the searches were originally done in
+    std::vector<LocSearchStart> starts;
+    pool<WireId> seen_sinks, seen_sources;
+    // Identical IO, BRAM and DSP tiles give the same result, so only the first of each is searched for
+    dict<std::tuple<bool, int, int, int>, int> memo;
+    auto add_start = [&](WireId wire, bool is_source) {
+        if (wire == WireId() || !(is_source ? seen_sources : seen_sinks).insert(wire).second)
+            return;
+        const auto &inst = ctx->chip_info->tile_insts[wire.tile];
+        auto key = std::make_tuple(is_source, int(inst.type), int(inst.shape), int(wire.index));
+        int memo_idx = memo.emplace(key, int(starts.size())).first->second;
+        starts.push_back(LocSearchStart{wire, is_source, memo_idx});
+    };
     for (auto &net : ctx->nets) {
         NetInfo *ni = net.second.get();
         for (auto &usr : ni->users) {
             BelId bel = usr.cell->bel;
             if (bel == BelId() || is_logic_tile(bel))
                 continue; // don't need to do this for logic bels, which are always next to their INT
-            WireId sink = ctx->getNetinfoSinkWire(ni, usr, 0);
-            if (sink == WireId() || sink_locs.count(sink))
-                continue;
-            std::queue<WireId> visit;
-            dict<WireId, WireId> backtrace;
-            int iter = 0;
-            // as this is a best-effort optimisation to slightly improve routing,
-            // don't spend too long with a nice low iteration limit
-            const int iter_max = 500;
-            visit.push(sink);
-            while (!visit.empty() && iter < iter_max) {
-                ++iter;
-                WireId cursor = visit.front();
-                visit.pop();
-                if (is_general_routing(cursor)) {
-                    Loc loc(0, 0, 0);
-                    tile_xy(ctx->chip_info, cursor.tile, loc.x, loc.y);
-                    sink_locs[sink] = loc;
-
-                    while (backtrace.count(cursor)) {
-                        cursor = backtrace.at(cursor);
-                        if (!sink_locs.count(cursor)) {
-                            sink_locs[cursor] = loc;
-                        }
-                    }
-
-                    break;
-                }
-                for (auto pip : ctx->getPipsUphill(cursor)) {
-                    WireId src = ctx->getPipSrcWire(pip);
-                    if (!backtrace.count(src)) {
-                        backtrace[src] = cursor;
-                        visit.push(src);
-                    }
-                }
-            }
+            add_start(ctx->getNetinfoSinkWire(ni, usr, 0), false);
         }
         auto &drv = ni->driver;
         if (drv.cell != nullptr) {
             BelId bel = drv.cell->bel;
             if (bel == BelId() || is_logic_tile(bel))
                 continue; // don't need to do this for logic bels, which are always next to their INT
-            WireId source = ctx->getNetinfoSourceWire(ni);
-            if (source == WireId() || source_locs.count(source))
-                continue;
-            std::queue<WireId> visit;
-            dict<WireId, WireId> backtrace;
-            int iter = 0;
-            // as this is a best-effort optimisation to slightly improve routing,
-            // don't spend too long with a nice low iteration limit
-            const int iter_max = 500;
-            visit.push(source);
-            while (!visit.empty() && iter < iter_max) {
-                ++iter;
-                WireId cursor = visit.front();
-                visit.pop();
-                if (is_general_routing(cursor)) {
-                    Loc loc(0, 0, 0);
-                    tile_xy(ctx->chip_info, cursor.tile, loc.x, loc.y);
-                    source_locs[source] = loc;
-
-                    while (backtrace.count(cursor)) {
-                        cursor = backtrace.at(cursor);
-                        if (!source_locs.count(cursor)) {
-                            source_locs[cursor] = loc;
-                        }
-                    }
-
-                    break;
-                }
-                for (auto pip : ctx->getPipsDownhill(cursor)) {
-                    WireId dst = ctx->getPipDstWire(pip);
-                    if (!backtrace.count(dst)) {
-                        backtrace[dst] = cursor;
-                        visit.push(dst);
-                    }
-                }
-            }
+            add_start(ctx->getNetinfoSourceWire(ni), true);
+        }
+    }
+
+    // The searches only read the routing graph, so they are shared out between threads, first for the starts that
+    // are searched from, then for those whose result is translated from the memo (searching too if that fails)
+    std::vector<LocSearchResult> results(starts.size());
+    std::vector<std::vector<std::pair<WireId, Loc>>> locs(starts.size());
+    auto process = [&](int i, bool memo_pass, LocSearchScratch &scratch) {
+        const LocSearchStart &start = starts.at(i);
+        if ((start.memo == i) != memo_pass)
+            return;
+        if (!memo_pass) {
+            const LocSearchResult &memo_result = results.at(start.memo);
+            if (!memo_result.found || translate_search_result(ctx, start.wire, memo_result, locs.at(i)))
+                return;
+            locs.at(i).clear();
+        }
+        search_general_routing(this, start, scratch, results.at(i));
+        if (results.at(i).found) {
+            bool translated = translate_search_result(ctx, start.wire, results.at(i), locs.at(i));
+            NPNR_ASSERT(translated);
+        }
+    };
+    // Each worker takes every thread_count'th start, which spreads the starts of each pass evenly
+    int thread_count = std::max(1, std::min(ctx->setting<int>("threads", 8), int(starts.size())));
+    ThreadPool thread_pool(thread_count);
+    for (bool memo_pass : {true, false}) {
+        thread_pool.run(thread_count, [&](int t) {
+            LocSearchScratch scratch;
+            for (int i = t; i < int(starts.size()); i += thread_count)
+                process(i, memo_pass, scratch);
+        });
+    }
+
+    // Record the results in the original order, so wires on more than one path keep the location they had before
+    for (int i = 0; i < int(starts.size()); i++) {
+        auto &target = starts.at(i).is_source ? source_locs : sink_locs;
+        if (locs.at(i).empty() || target.count(starts.at(i).wire))
+            continue;
+        for (auto &wl : locs.at(i)) {
+            if (!target.count(wl.first))
+                target[wl.first] = wl.second;
         }
     }
 }
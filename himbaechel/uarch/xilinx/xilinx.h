@@ -174,6 +174,7 @@ struct XilinxImpl : HimbaechelAPI
     void find_source_sink_locs();
 
     delay_t estimateDelay(WireId src, WireId dst) const override;
+    bool useRouteLookahead() const override { return false; }
     BoundingBox getRouteBoundingBox(WireId src, WireId dst) const override;
 
   private:
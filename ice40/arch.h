@@ -404,6 +404,8 @@ struct Arch : BaseArch<ArchRanges>
     mutable dict<IdStringList, int> wire_by_name;
     mutable dict<IdStringList, int> pip_by_name;
     mutable dict<Loc, int> bel_by_loc;
+    // Config entry index by name for each non-routing tile type, built by the bitstream writer/reader on first use
+    mutable std::vector<dict<std::string, int>> config_entry_by_name;
 
     std::vector<bool> bel_carry;
     std::vector<CellInfo *> bel_to_cell;
@@ -32,14 +32,23 @@ inline TileType tile_at(const Context *ctx, int x, int y)
     return ctx->chip_info->tile_grid[y * ctx->chip_info->width + x];
 }
 
-const ConfigEntryPOD &find_config(const TileInfoPOD &tile, const std::string &name)
+const ConfigEntryPOD &find_config(const Context *ctx, const TileInfoPOD &tile, const std::string &name)
 {
-    for (auto &entry : tile.entries) {
-        if (std::string(entry.name.get()) == name) {
-            return entry;
+    const auto &tiles = ctx->chip_info->bits_info->tiles_nonrouting;
+    auto &index = ctx->config_entry_by_name;
+    if (index.empty()) {
+        index.resize(tiles.size());
+        for (int type = 0; type < tiles.ssize(); type++) {
+            const auto &entries = tiles[type].entries;
+            for (int i = 0; i < entries.ssize(); i++)
+                index.at(type).emplace(entries[i].name.get(), i);
         }
     }
-    NPNR_ASSERT_FALSE_STR("unable to find config bit " + name);
+    const auto &tile_index = index.at(&tile - tiles.begin());
+    auto fnd = tile_index.find(name);
+    if (fnd == tile_index.end())
+        NPNR_ASSERT_FALSE_STR("unable to find config bit " + name);
+    return tile.entries[fnd->second];
 }
 
 std::tuple<int8_t, int8_t, int8_t> get_ieren(const BitstreamInfoPOD &bi, int8_t x, int8_t y, int8_t z)
@@ -53,10 +62,10 @@ std::tuple<int8_t, int8_t, int8_t> get_ieren(const BitstreamInfoPOD &bi, int8_t
     return std::make_tuple(-1, -1, -1);
 };
 
-bool get_config(const TileInfoPOD &ti, std::vector<std::vector<int8_t>> &tile_cfg, const std::string &name,
-                int index = -1)
+bool get_config(const Context *ctx, const TileInfoPOD &ti, std::vector<std::vector<int8_t>> &tile_cfg,
+                const std::string &name, int index = -1)
 {
-    const ConfigEntryPOD &cfg = find_config(ti, name);
+    const ConfigEntryPOD &cfg = find_config(ctx, ti, name);
     if (index == -1) {
         for (auto &bit : cfg.bits) {
             return tile_cfg.at(bit.row).at(bit.col);
@@ -67,10 +76,10 @@ bool get_config(const TileInfoPOD &ti, std::vector<std::vector<int8_t>> &tile_cf
     return false;
 }
 
-void set_config(const TileInfoPOD &ti, std::vector<std::vector<int8_t>> &tile_cfg, const std::string &name, bool value,
-                int index = -1)
+void set_config(const Context *ctx, const TileInfoPOD &ti, std::vector<std::vector<int8_t>> &tile_cfg,
+                const std::string &name, bool value, int index = -1)
 {
-    const ConfigEntryPOD &cfg = find_config(ti, name);
+    const ConfigEntryPOD &cfg = find_config(ctx, ti, name);
     if (index == -1) {
         for (auto &bit : cfg.bits) {
             int8_t &cbit = tile_cfg.at(bit.row).at(bit.col);
@@ -92,9 +101,9 @@ void set_ie_bit_logical(const Context *ctx, const TileInfoPOD &ti, std::vector<s
                         const std::string &name, bool value)
 {
     if (ctx->args.type == ArchArgs::LP1K || ctx->args.type == ArchArgs::HX1K) {
-        set_config(ti, tile_cfg, name, !value);
+        set_config(ctx, ti, tile_cfg, name, !value);
     } else {
-        set_config(ti, tile_cfg, name, value);
+        set_config(ctx, ti, tile_cfg, name, value);
     }
 }
 
@@ -149,7 +158,7 @@ static void set_ec_cbit(chipconfig_t &config, const Context *ctx, const BelConfi
     for (auto &cbit : cell_cbits.entries) {
         if (cbit.entry_name.get() == name) {
             const auto &ti = chip->bits_info->tiles_nonrouting[tile_at(ctx, cbit.x, cbit.y)];
-            set_config(ti, config.at(cbit.y).at(cbit.x), prefix + cbit.cbit_name.get(), value);
+            set_config(ctx, ti, config.at(cbit.y).at(cbit.x), prefix + cbit.cbit_name.get(), value);
             return;
         }
     }
@@ -377,7 +386,7 @@ void write_asc(const Context *ctx, std::ostream &out)
                 }
 
                 for (int i = 0; i < 20; i++)
-                    set_config(ti, config.at(beli.y).at(beli.x), "LC_" + std::to_string(beli.z), lc.at(i), i);
+                    set_config(ctx, ti, config.at(beli.y).at(beli.x), "LC_" + std::to_string(beli.z), lc.at(i), i);
             } else {
                 for (int i = 0; i < swi.num_bits; i++) {
                     bool val = (pi.switch_mask & (1 << ((swi.num_bits - 1) - i))) != 0;
@@ -435,9 +444,9 @@ void write_asc(const Context *ctx, std::ostream &out)
             bool icegate_ena = get_param_or_def(
                     ctx, cell.second.get(), (port == id_PLLOUT_A) ? id_ENABLE_ICEGATE_PORTA : id_ENABLE_ICEGATE_PORTB);
 
-            set_config(ti, config.at(io_bel_loc.y).at(io_bel_loc.x),
+            set_config(ctx, ti, config.at(io_bel_loc.y).at(io_bel_loc.x),
                        "IOB_" + std::to_string(io_bel_loc.z) + ".PINTYPE_1", icegate_ena);
-            set_config(ti, config.at(io_bel_loc.y).at(io_bel_loc.x),
+            set_config(ctx, ti, config.at(io_bel_loc.y).at(io_bel_loc.x),
                        "IOB_" + std::to_string(io_bel_loc.z) + ".PINTYPE_0", true);
         }
     }
@@ -514,16 +523,16 @@ void write_asc(const Context *ctx, std::ostream &out)
             lc.at(19) = async_sr;
 
             for (int i = 0; i < 20; i++)
-                set_config(ti, config.at(y).at(x), "LC_" + std::to_string(z), lc.at(i), i);
+                set_config(ctx, ti, config.at(y).at(x), "LC_" + std::to_string(z), lc.at(i), i);
             if (dff_enable)
-                set_config(ti, config.at(y).at(x), "NegClk", neg_clk);
+                set_config(ctx, ti, config.at(y).at(x), "NegClk", neg_clk);
 
             bool carry_const = get_param_or_def(ctx, cell.second.get(), id_CIN_CONST);
             bool carry_set = get_param_or_def(ctx, cell.second.get(), id_CIN_SET);
             if (carry_const) {
                 if (!ctx->force)
                     NPNR_ASSERT(z == 0);
-                set_config(ti, config.at(y).at(x), "CarryInSet", carry_set);
+                set_config(ctx, ti, config.at(y).at(x), "CarryInSet", carry_set);
             }
         } else if (cell.second->type == id_SB_IO) {
             const BelInfoPOD &beli = ci.bel_data[bel.index];
@@ -538,10 +547,11 @@ void write_asc(const Context *ctx, std::ostream &out)
 
             for (int i = used_by_pll_out ? 2 : 0; i < 6; i++) {
                 bool val = (pin_type >> i) & 0x01;
-                set_config(ti, config.at(y).at(x), "IOB_" + std::to_string(z) + ".PINTYPE_" + std::to_string(i), val);
+                set_config(ctx, ti, config.at(y).at(x), "IOB_" + std::to_string(z) + ".PINTYPE_" + std::to_string(i),
+                           val);
             }
             if (cell.second->getPort(id_INPUT_CLK) || cell.second->getPort(id_OUTPUT_CLK))
-                set_config(ti, config.at(y).at(x), "NegClk", neg_trigger);
+                set_config(ctx, ti, config.at(y).at(x), "NegClk", neg_trigger);
 
             bool input_en = false;
             if ((ctx->wire_to_net[ctx->getBelPinWire(bel, id_D_IN_0).index] != nullptr) ||
@@ -558,11 +568,11 @@ void write_asc(const Context *ctx, std::ostream &out)
                 NPNR_ASSERT(iez != -1);
 
                 if (ctx->args.type == ArchArgs::LP1K || ctx->args.type == ArchArgs::HX1K) {
-                    set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), !input_en);
-                    set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), !pullup);
+                    set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), !input_en);
+                    set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), !pullup);
                 } else {
-                    set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), input_en);
-                    set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), !pullup);
+                    set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), input_en);
+                    set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), !pullup);
                 }
 
                 if (ctx->args.type == ArchArgs::UP5K || ctx->args.type == ArchArgs::UP3K) {
@@ -572,23 +582,29 @@ void write_asc(const Context *ctx, std::ostream &out)
                     NPNR_ASSERT(pullup_resistor == "100K" || pullup_resistor == "10K" || pullup_resistor == "6P8K" ||
                                 pullup_resistor == "3P3K");
                     if (iez == 0) {
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_39",
+                        set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.cf_bit_39",
                                    (!pullup) || (pullup_resistor != "100K"));
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_36", pullup && pullup_resistor == "3P3K");
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_37", pullup && pullup_resistor == "6P8K");
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_38", pullup && pullup_resistor == "10K");
+                        set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.cf_bit_36",
+                                   pullup && pullup_resistor == "3P3K");
+                        set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.cf_bit_37",
+                                   pullup && pullup_resistor == "6P8K");
+                        set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.cf_bit_38",
+                                   pullup && pullup_resistor == "10K");
                     } else if (iez == 1) {
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_35",
+                        set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.cf_bit_35",
                                    (!pullup) || (pullup_resistor != "100K"));
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_32", pullup && pullup_resistor == "3P3K");
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_33", pullup && pullup_resistor == "6P8K");
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_34", pullup && pullup_resistor == "10K");
+                        set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.cf_bit_32",
+                                   pullup && pullup_resistor == "3P3K");
+                        set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.cf_bit_33",
+                                   pullup && pullup_resistor == "6P8K");
+                        set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.cf_bit_34",
+                                   pullup && pullup_resistor == "10K");
                     }
                 }
             } else {
                 NPNR_ASSERT(z == 0);
                 // Only enable the actual LVDS buffer if input is used for something
-                set_config(ti, config.at(y).at(x), "IoCtrl.LVDS", input_en);
+                set_config(ctx, ti, config.at(y).at(x), "IoCtrl.LVDS", input_en);
 
                 // Set both IO config
                 for (int cz = 0; cz < 2; cz++) {
@@ -600,18 +616,18 @@ void write_asc(const Context *ctx, std::ostream &out)
                     pullup &= !input_en; /* If input is used, force disable pullups */
 
                     if (ctx->args.type == ArchArgs::LP1K || ctx->args.type == ArchArgs::HX1K) {
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), true);
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), !pullup);
+                        set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), true);
+                        set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), !pullup);
                     } else {
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), false);
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), !pullup);
+                        set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), false);
+                        set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), !pullup);
                     }
 
                     if (ctx->args.type == ArchArgs::UP5K || ctx->args.type == ArchArgs::UP3K) {
                         if (iez == 0) {
-                            set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_39", !pullup);
+                            set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.cf_bit_39", !pullup);
                         } else if (iez == 1) {
-                            set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_35", !pullup);
+                            set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.cf_bit_35", !pullup);
                         }
                     }
                 }
@@ -631,23 +647,23 @@ void write_asc(const Context *ctx, std::ostream &out)
             const TileInfoPOD &ti_ramt = bi.tiles_nonrouting[TILE_RAMT];
             const TileInfoPOD &ti_ramb = bi.tiles_nonrouting[TILE_RAMB];
             if (!(ctx->args.type == ArchArgs::LP1K || ctx->args.type == ArchArgs::HX1K)) {
-                set_config(ti_ramb, config.at(y).at(x), "RamConfig.PowerUp", true);
+                set_config(ctx, ti_ramb, config.at(y).at(x), "RamConfig.PowerUp", true);
             }
             bool negclk_r = get_param_or_def(ctx, cell.second.get(), id_NEG_CLK_R);
             bool negclk_w = get_param_or_def(ctx, cell.second.get(), id_NEG_CLK_W);
             int write_mode = get_param_or_def(ctx, cell.second.get(), id_WRITE_MODE);
             int read_mode = get_param_or_def(ctx, cell.second.get(), id_READ_MODE);
             if (ctx->args.type == ArchArgs::LP1K || ctx->args.type == ArchArgs::HX1K) {
-                set_config(ti_ramb, config.at(y).at(x), "NegClk", negclk_w);
-                set_config(ti_ramt, config.at(y + 1).at(x), "NegClk", negclk_r);
+                set_config(ctx, ti_ramb, config.at(y).at(x), "NegClk", negclk_w);
+                set_config(ctx, ti_ramt, config.at(y + 1).at(x), "NegClk", negclk_r);
             } else {
-                set_config(ti_ramb, config.at(y).at(x), "NegClk", negclk_r);
-                set_config(ti_ramt, config.at(y + 1).at(x), "NegClk", negclk_w);
+                set_config(ctx, ti_ramb, config.at(y).at(x), "NegClk", negclk_r);
+                set_config(ctx, ti_ramt, config.at(y + 1).at(x), "NegClk", negclk_w);
             }
-            set_config(ti_ramt, config.at(y + 1).at(x), "RamConfig.CBIT_0", write_mode & 0x1);
-            set_config(ti_ramt, config.at(y + 1).at(x), "RamConfig.CBIT_1", write_mode & 0x2);
-            set_config(ti_ramt, config.at(y + 1).at(x), "RamConfig.CBIT_2", read_mode & 0x1);
-            set_config(ti_ramt, config.at(y + 1).at(x), "RamConfig.CBIT_3", read_mode & 0x2);
+            set_config(ctx, ti_ramt, config.at(y + 1).at(x), "RamConfig.CBIT_0", write_mode & 0x1);
+            set_config(ctx, ti_ramt, config.at(y + 1).at(x), "RamConfig.CBIT_1", write_mode & 0x2);
+            set_config(ctx, ti_ramt, config.at(y + 1).at(x), "RamConfig.CBIT_2", read_mode & 0x1);
+            set_config(ctx, ti_ramt, config.at(y + 1).at(x), "RamConfig.CBIT_3", read_mode & 0x2);
         } else if (cell.second->type == id_SB_LED_DRV_CUR) {
             set_ec_cbit(config, ctx, get_ec_config(ctx->chip_info, cell.second->bel), "LED_DRV_CUR_EN", true,
                         "IpConfig.");
@@ -692,18 +708,18 @@ void write_asc(const Context *ctx, std::ostream &out)
             if (x == 0 && y == 0) {
                 const TileInfoPOD &ti_ipcon = bi.tiles_nonrouting[TILE_IPCON];
                 if (z == 1) {
-                    set_config(ti_ipcon, config.at(1).at(0), "IpConfig.CBIT_0", true);
+                    set_config(ctx, ti_ipcon, config.at(1).at(0), "IpConfig.CBIT_0", true);
                 } else if (z == 2) {
-                    set_config(ti_ipcon, config.at(1).at(0), "IpConfig.CBIT_1", true);
+                    set_config(ctx, ti_ipcon, config.at(1).at(0), "IpConfig.CBIT_1", true);
                 } else {
                     NPNR_ASSERT(false);
                 }
             } else if (x == 25 && y == 0) {
                 const TileInfoPOD &ti_ipcon = bi.tiles_nonrouting[TILE_IPCON];
                 if (z == 3) {
-                    set_config(ti_ipcon, config.at(1).at(25), "IpConfig.CBIT_0", true);
+                    set_config(ctx, ti_ipcon, config.at(1).at(25), "IpConfig.CBIT_0", true);
                 } else if (z == 4) {
-                    set_config(ti_ipcon, config.at(1).at(25), "IpConfig.CBIT_1", true);
+                    set_config(ctx, ti_ipcon, config.at(1).at(25), "IpConfig.CBIT_1", true);
                 } else {
                     NPNR_ASSERT(false);
                 }
@@ -779,11 +795,11 @@ void write_asc(const Context *ctx, std::ostream &out)
                         continue;
                 }
                 if (ctx->args.type == ArchArgs::LP1K || ctx->args.type == ArchArgs::HX1K) {
-                    set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), true);
-                    set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), false);
+                    set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), true);
+                    set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), false);
                 } else {
-                    set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), false);
-                    set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), false);
+                    set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), false);
+                    set_config(ctx, ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), false);
                 }
             }
         } else if (ctx->bel_to_cell[bel.index] == nullptr && ctx->getBelType(bel) == id_ICESTORM_RAM) {
@@ -791,7 +807,7 @@ void write_asc(const Context *ctx, std::ostream &out)
             int x = beli.x, y = beli.y;
             const TileInfoPOD &ti = bi.tiles_nonrouting[TILE_RAMB];
             if ((ctx->args.type == ArchArgs::LP1K || ctx->args.type == ArchArgs::HX1K)) {
-                set_config(ti, config.at(y).at(x), "RamConfig.PowerUp", true);
+                set_config(ctx, ti, config.at(y).at(x), "RamConfig.PowerUp", true);
             }
         }
     }
@@ -822,14 +838,14 @@ void write_asc(const Context *ctx, std::ostream &out)
                 setColBufCtrl = false;
             }
             if (setColBufCtrl) {
-                set_config(ti, config.at(y).at(x), "ColBufCtrl.glb_netwk_0", true);
-                set_config(ti, config.at(y).at(x), "ColBufCtrl.glb_netwk_1", true);
-                set_config(ti, config.at(y).at(x), "ColBufCtrl.glb_netwk_2", true);
-                set_config(ti, config.at(y).at(x), "ColBufCtrl.glb_netwk_3", true);
-                set_config(ti, config.at(y).at(x), "ColBufCtrl.glb_netwk_4", true);
-                set_config(ti, config.at(y).at(x), "ColBufCtrl.glb_netwk_5", true);
-                set_config(ti, config.at(y).at(x), "ColBufCtrl.glb_netwk_6", true);
-                set_config(ti, config.at(y).at(x), "ColBufCtrl.glb_netwk_7", true);
+                set_config(ctx, ti, config.at(y).at(x), "ColBufCtrl.glb_netwk_0", true);
+                set_config(ctx, ti, config.at(y).at(x), "ColBufCtrl.glb_netwk_1", true);
+                set_config(ctx, ti, config.at(y).at(x), "ColBufCtrl.glb_netwk_2", true);
+                set_config(ctx, ti, config.at(y).at(x), "ColBufCtrl.glb_netwk_3", true);
+                set_config(ctx, ti, config.at(y).at(x), "ColBufCtrl.glb_netwk_4", true);
+                set_config(ctx, ti, config.at(y).at(x), "ColBufCtrl.glb_netwk_5", true);
+                set_config(ctx, ti, config.at(y).at(x), "ColBufCtrl.glb_netwk_6", true);
+                set_config(ctx, ti, config.at(y).at(x), "ColBufCtrl.glb_netwk_7", true);
             }
 
             // Weird UltraPlus bits
@@ -840,13 +856,13 @@ void write_asc(const Context *ctx, std::ostream &out)
                             4, 14, 15, 5, 6, 16, 17, 7, 3, 13, 12, 2, 1, 11, 10, 0,
                     };
                     for (int i = 0; i < 16; i++)
-                        set_config(ti, config.at(y).at(x), "LC_" + std::to_string(lc_idx), ((i % 8) >= 4),
+                        set_config(ctx, ti, config.at(y).at(x), "LC_" + std::to_string(lc_idx), ((i % 8) >= 4),
                                    ip_dsp_lut_perm.at(i));
                     if (tile == TILE_IPCON)
-                        set_config(ti, config.at(y).at(x), "Cascade.IPCON_LC0" + std::to_string(lc_idx) + "_inmux02_5",
-                                   true);
+                        set_config(ctx, ti, config.at(y).at(x),
+                                   "Cascade.IPCON_LC0" + std::to_string(lc_idx) + "_inmux02_5", true);
                     else
-                        set_config(ti, config.at(y).at(x),
+                        set_config(ctx, ti, config.at(y).at(x),
                                    "Cascade.MULT" + std::to_string(int(tile - TILE_DSP0)) + "_LC0" +
                                            std::to_string(lc_idx) + "_inmux02_5",
                                    true);
@@ -1060,12 +1076,12 @@ bool read_asc(Context *ctx, std::istream &in)
                 std::vector<bool> lc(20, false);
                 bool isUsed = false;
                 for (int i = 0; i < 20; i++) {
-                    lc.at(i) = get_config(ti, config.at(y).at(x), "LC_" + std::to_string(z), i);
+                    lc.at(i) = get_config(ctx, ti, config.at(y).at(x), "LC_" + std::to_string(z), i);
                     isUsed |= lc.at(i);
                 }
-                bool neg_clk = get_config(ti, config.at(y).at(x), "NegClk");
+                bool neg_clk = get_config(ctx, ti, config.at(y).at(x), "NegClk");
                 isUsed |= neg_clk;
-                bool carry_set = get_config(ti, config.at(y).at(x), "CarryInSet");
+                bool carry_set = get_config(ctx, ti, config.at(y).at(x), "CarryInSet");
                 isUsed |= carry_set;
 
                 if (isUsed) {
@@ -1082,10 +1098,10 @@ bool read_asc(Context *ctx, std::istream &in)
                 int x = beli.x, y = beli.y, z = beli.z;
                 bool isUsed = false;
                 for (int i = 0; i < 6; i++) {
-                    isUsed |= get_config(ti, config.at(y).at(x),
+                    isUsed |= get_config(ctx, ti, config.at(y).at(x),
                                          "IOB_" + std::to_string(z) + ".PINTYPE_" + std::to_string(i));
                 }
-                bool neg_trigger = get_config(ti, config.at(y).at(x), "NegClk");
+                bool neg_trigger = get_config(ctx, ti, config.at(y).at(x), "NegClk");
                 isUsed |= neg_trigger;
 
                 if (isUsed) {
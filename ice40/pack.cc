@@ -1719,16 +1719,21 @@ bool Arch::pack()
         log_break();
         pack_constants(ctx);
         pack_io(ctx);
-        pack_lut_lutffs(ctx);
-        pack_nonlut_ffs(ctx);
-        pack_carries(ctx);
-        merge_carry_luts(ctx);
+        {
+            ProfileScope prof_scope(ctx->profiler, "ice40/pack_logic");
+            pack_lut_lutffs(ctx);
+            pack_nonlut_ffs(ctx);
+            pack_carries(ctx);
+            merge_carry_luts(ctx);
+        }
         pack_ram(ctx);
         place_plls(ctx);
         pack_special(ctx);
         pack_plls(ctx);
-        if (!bool_or_default(ctx->settings, id_no_promote_globals, false))
+        if (!bool_or_default(ctx->settings, id_no_promote_globals, false)) {
+            ProfileScope prof_scope(ctx->profiler, "ice40/promote_globals");
             promote_globals(ctx);
+        }
         copy_gb_constraints(ctx);
         ctx->assignArchInfo();
         constrain_chains(ctx);
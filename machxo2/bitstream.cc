@@ -438,7 +438,7 @@ struct MachXO2Bitgen
 
     void write_bram(CellInfo *ci)
     {
-        TileGroup tg;
+        TileGroup tg(cc.strings.get());
         tg.tiles = get_bram_tiles(ci->bel);
         std::string ebr = "EBR";
 
@@ -517,7 +517,7 @@ struct MachXO2Bitgen
 
     void write_pll(CellInfo *ci)
     {
-        TileGroup tg;
+        TileGroup tg(cc.strings.get());
         tg.tiles = get_pll_tiles(ci->bel);
 
         tg.config.add_enum("MODE", "EHXPLLJ");
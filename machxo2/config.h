@@ -21,50 +21,58 @@
 #ifndef MACHXO2_CONFIG_H
 #define MACHXO2_CONFIG_H
 
+#include <deque>
 #include <map>
+#include <memory>
 #include "nextpnr.h"
 
 NEXTPNR_NAMESPACE_BEGIN
 
 // This represents configuration at "FASM" level, in terms of routing arcs and non-routing configuration settings -
 // either words or enums.
+//
+// Tile names, setting names and enum values are interned, so each distinct string is stored only once however many
+// tiles use it, and entries only hold their integer IDs. Text is only produced when the configuration is written out.
+// Each ChipConfig has its own table, which all of its tiles and tile groups refer to.
+
+// A table of interned configuration strings
+struct ConfigStrings
+{
+    // Get the ID of str, adding it if not already present
+    int id(const std::string &str);
+    // Get the ID of str, or -1 if not present
+    int lookup(const std::string &str) const;
+    const std::string &str(int id) const { return strings.at(id); }
+
+  private:
+    std::vector<std::string> strings;
+    dict<std::string, int> ids;
+};
 
 // A connection in a tile
 struct ConfigArc
 {
-    std::string sink;
-    std::string source;
+    int sink;
+    int source;
     inline bool operator==(const ConfigArc &other) const { return other.source == source && other.sink == sink; }
 };
 
-std::ostream &operator<<(std::ostream &out, const ConfigArc &arc);
-
-std::istream &operator>>(std::istream &in, ConfigArc &arc);
-
-// A configuration setting in a tile that takes one or more bits (such as LUT init)
+// A configuration setting in a tile that takes one or more bits (such as LUT init), which are stored in the tile's
+// word_bits
 struct ConfigWord
 {
-    std::string name;
-    std::vector<bool> value;
-    inline bool operator==(const ConfigWord &other) const { return other.name == name && other.value == value; }
+    int name;
+    int offset, width;
 };
 
-std::ostream &operator<<(std::ostream &out, const ConfigWord &cw);
-
-std::istream &operator>>(std::istream &in, ConfigWord &cw);
-
 // A configuration setting in a tile that takes an enumeration value (such as IO type)
 struct ConfigEnum
 {
-    std::string name;
-    std::string value;
+    int name;
+    int value;
     inline bool operator==(const ConfigEnum &other) const { return other.name == name && other.value == value; }
 };
 
-std::ostream &operator<<(std::ostream &out, const ConfigEnum &ce);
-
-std::istream &operator>>(std::istream &in, ConfigEnum &ce);
-
 // An unknown bit, specified by position only
 struct ConfigUnknown
 {
@@ -72,25 +80,30 @@ struct ConfigUnknown
     inline bool operator==(const ConfigUnknown &other) const { return other.frame == frame && other.bit == bit; }
 };
 
-std::ostream &operator<<(std::ostream &out, const ConfigUnknown &tc);
-
-std::istream &operator>>(std::istream &in, ConfigUnknown &ce);
-
 struct TileConfig
 {
+    explicit TileConfig(ConfigStrings *strings) : strings(strings) {};
+
+    // The table that the IDs in the entries refer to
+    ConfigStrings *strings;
     std::vector<ConfigArc> carcs;
     std::vector<ConfigWord> cwords;
     std::vector<ConfigEnum> cenums;
     std::vector<ConfigUnknown> cunknowns;
+    std::vector<bool> word_bits;
     int total_known_bits = 0;
 
     void add_arc(const std::string &sink, const std::string &source);
     void add_word(const std::string &name, const std::vector<bool> &value);
     void add_enum(const std::string &name, const std::string &value);
     void add_unknown(int frame, int bit);
+    // Add all the settings of another tile to this one, which may use a different string table
+    void add_config(const TileConfig &other);
+
+    std::vector<bool> get_word(const ConfigWord &cw) const;
 
     std::string to_string() const;
-    static TileConfig from_string(const std::string &str);
+    static TileConfig from_string(const std::string &str, ConfigStrings *strings);
 
     bool empty() const;
 };
@@ -99,10 +112,35 @@ std::ostream &operator<<(std::ostream &out, const TileConfig &tc);
 
 std::istream &operator>>(std::istream &in, TileConfig &ce);
 
+// The configured tiles, indexed by the ID of their interned name. References to tiles stay valid as more are added.
+class TileConfigMap
+{
+  public:
+    explicit TileConfigMap(ConfigStrings *strings) : strings(strings) {};
+
+    TileConfig &operator[](const std::string &name);
+    TileConfig &at(const std::string &name);
+    const TileConfig &at(const std::string &name) const;
+    // Returns nullptr if the tile has no config
+    TileConfig *find(const std::string &name);
+    int count(const std::string &name) const;
+    void erase(const std::string &name);
+    // Names of the tiles with config, in the order they are written out
+    std::vector<std::string> names() const;
+
+  private:
+    ConfigStrings *strings;
+    std::deque<TileConfig> configs;
+    std::vector<int> config_name;
+    dict<int, int> config_by_name;
+};
+
 // A group of tiles to configure at once for a particular feature that is split across tiles
 // TileGroups are currently for non-routing configuration only
 struct TileGroup
 {
+    explicit TileGroup(ConfigStrings *strings) : config(strings) {};
+
     std::vector<std::string> tiles;
     TileConfig config;
 };
@@ -111,10 +149,14 @@ struct TileGroup
 class ChipConfig
 {
   public:
+    ChipConfig() : strings(std::make_unique<ConfigStrings>()), tiles(strings.get()) {};
+
+    // Kept on the heap, so that moving the config doesn't invalidate the pointers to it
+    std::unique_ptr<ConfigStrings> strings;
     std::string chip_name;
     std::string chip_variant;
     std::vector<std::string> metadata;
-    std::map<std::string, TileConfig> tiles;
+    TileConfigMap tiles;
     std::vector<TileGroup> tilegroups;
     std::map<std::string, std::string> sysconfig;
     std::map<uint16_t, std::vector<uint16_t>> bram_data;